@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_big_integer.dir/bench_big_integer.cpp.o"
+  "CMakeFiles/bench_big_integer.dir/bench_big_integer.cpp.o.d"
+  "bench_big_integer"
+  "bench_big_integer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_big_integer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/types.dir/pyc_big_integer.cpp.o"
+  "CMakeFiles/types.dir/pyc_big_integer.cpp.o.d"
+  "libtypes.a"
+  "libtypes.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/types.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
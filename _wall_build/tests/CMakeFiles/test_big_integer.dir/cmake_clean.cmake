@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_big_integer.dir/test_big_integer.cpp.o"
+  "CMakeFiles/test_big_integer.dir/test_big_integer.cpp.o.d"
+  "test_big_integer"
+  "test_big_integer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_big_integer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
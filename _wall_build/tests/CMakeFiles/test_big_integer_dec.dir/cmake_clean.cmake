@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_big_integer_dec.dir/__/src/types/pyc_big_integer.cpp.o"
+  "CMakeFiles/test_big_integer_dec.dir/__/src/types/pyc_big_integer.cpp.o.d"
+  "CMakeFiles/test_big_integer_dec.dir/test_big_integer.cpp.o"
+  "CMakeFiles/test_big_integer_dec.dir/test_big_integer.cpp.o.d"
+  "test_big_integer_dec"
+  "test_big_integer_dec.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_big_integer_dec.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
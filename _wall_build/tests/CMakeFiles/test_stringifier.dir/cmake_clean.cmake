@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_stringifier.dir/test_stringifier.cpp.o"
+  "CMakeFiles/test_stringifier.dir/test_stringifier.cpp.o.d"
+  "test_stringifier"
+  "test_stringifier.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_stringifier.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,104 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/tests
+# Build directory: /root/repo/_wall_build/tests
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(PythonicCppLibTests "/root/repo/_wall_build/tests/test_big_integer" "bigint")
+set_tests_properties(PythonicCppLibTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;23;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntLargeTests "/root/repo/_wall_build/tests/test_big_integer" "large")
+set_tests_properties(BigIntLargeTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;24;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntMulTests "/root/repo/_wall_build/tests/test_big_integer" "mul")
+set_tests_properties(BigIntMulTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;25;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDivTests "/root/repo/_wall_build/tests/test_big_integer" "div")
+set_tests_properties(BigIntDivTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;26;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntStrTests "/root/repo/_wall_build/tests/test_big_integer" "str")
+set_tests_properties(BigIntStrTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;27;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntAllocTests "/root/repo/_wall_build/tests/test_big_integer" "alloc")
+set_tests_properties(BigIntAllocTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;28;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntPmrTests "/root/repo/_wall_build/tests/test_big_integer" "pmr")
+set_tests_properties(BigIntPmrTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;29;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntKernelTests "/root/repo/_wall_build/tests/test_big_integer" "kernel")
+set_tests_properties(BigIntKernelTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;30;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntExprTests "/root/repo/_wall_build/tests/test_big_integer" "expr")
+set_tests_properties(BigIntExprTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;31;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntPowTests "/root/repo/_wall_build/tests/test_big_integer" "pow")
+set_tests_properties(BigIntPowTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;32;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntGcdTests "/root/repo/_wall_build/tests/test_big_integer" "gcd")
+set_tests_properties(BigIntGcdTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;33;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntRootTests "/root/repo/_wall_build/tests/test_big_integer" "root")
+set_tests_properties(BigIntRootTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;34;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntBitTests "/root/repo/_wall_build/tests/test_big_integer" "bit")
+set_tests_properties(BigIntBitTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;35;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntParallelTests "/root/repo/_wall_build/tests/test_big_integer" "parallel")
+set_tests_properties(BigIntParallelTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;36;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntCombTests "/root/repo/_wall_build/tests/test_big_integer" "comb")
+set_tests_properties(BigIntCombTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;37;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntFixedTests "/root/repo/_wall_build/tests/test_big_integer" "fixed")
+set_tests_properties(BigIntFixedTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;38;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntNativeTests "/root/repo/_wall_build/tests/test_big_integer" "native")
+set_tests_properties(BigIntNativeTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;39;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntConvTests "/root/repo/_wall_build/tests/test_big_integer" "conv")
+set_tests_properties(BigIntConvTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;40;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntBytesTests "/root/repo/_wall_build/tests/test_big_integer" "bytes")
+set_tests_properties(BigIntBytesTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;41;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntViewTests "/root/repo/_wall_build/tests/test_big_integer" "view")
+set_tests_properties(BigIntViewTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;42;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntHashTests "/root/repo/_wall_build/tests/test_big_integer" "hash")
+set_tests_properties(BigIntHashTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;43;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntParseTests "/root/repo/_wall_build/tests/test_big_integer" "parse")
+set_tests_properties(BigIntParseTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;44;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntFormatTests "/root/repo/_wall_build/tests/test_big_integer" "format")
+set_tests_properties(BigIntFormatTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;45;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitTests "/root/repo/_wall_build/tests/test_big_integer_dec" "bigint")
+set_tests_properties(BigIntDecimalDigitTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;46;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitLargeTests "/root/repo/_wall_build/tests/test_big_integer_dec" "large")
+set_tests_properties(BigIntDecimalDigitLargeTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;47;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitMulTests "/root/repo/_wall_build/tests/test_big_integer_dec" "mul")
+set_tests_properties(BigIntDecimalDigitMulTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;48;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitDivTests "/root/repo/_wall_build/tests/test_big_integer_dec" "div")
+set_tests_properties(BigIntDecimalDigitDivTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;49;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitStrTests "/root/repo/_wall_build/tests/test_big_integer_dec" "str")
+set_tests_properties(BigIntDecimalDigitStrTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;50;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitAllocTests "/root/repo/_wall_build/tests/test_big_integer_dec" "alloc")
+set_tests_properties(BigIntDecimalDigitAllocTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;51;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitPmrTests "/root/repo/_wall_build/tests/test_big_integer_dec" "pmr")
+set_tests_properties(BigIntDecimalDigitPmrTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;52;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitKernelTests "/root/repo/_wall_build/tests/test_big_integer_dec" "kernel")
+set_tests_properties(BigIntDecimalDigitKernelTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;53;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitExprTests "/root/repo/_wall_build/tests/test_big_integer_dec" "expr")
+set_tests_properties(BigIntDecimalDigitExprTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;54;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitPowTests "/root/repo/_wall_build/tests/test_big_integer_dec" "pow")
+set_tests_properties(BigIntDecimalDigitPowTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;55;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitGcdTests "/root/repo/_wall_build/tests/test_big_integer_dec" "gcd")
+set_tests_properties(BigIntDecimalDigitGcdTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;56;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitRootTests "/root/repo/_wall_build/tests/test_big_integer_dec" "root")
+set_tests_properties(BigIntDecimalDigitRootTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;57;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitBitTests "/root/repo/_wall_build/tests/test_big_integer_dec" "bit")
+set_tests_properties(BigIntDecimalDigitBitTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;58;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitParallelTests "/root/repo/_wall_build/tests/test_big_integer_dec" "parallel")
+set_tests_properties(BigIntDecimalDigitParallelTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;59;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitCombTests "/root/repo/_wall_build/tests/test_big_integer_dec" "comb")
+set_tests_properties(BigIntDecimalDigitCombTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;60;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitFixedTests "/root/repo/_wall_build/tests/test_big_integer_dec" "fixed")
+set_tests_properties(BigIntDecimalDigitFixedTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;61;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitNativeTests "/root/repo/_wall_build/tests/test_big_integer_dec" "native")
+set_tests_properties(BigIntDecimalDigitNativeTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;62;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitConvTests "/root/repo/_wall_build/tests/test_big_integer_dec" "conv")
+set_tests_properties(BigIntDecimalDigitConvTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;63;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitBytesTests "/root/repo/_wall_build/tests/test_big_integer_dec" "bytes")
+set_tests_properties(BigIntDecimalDigitBytesTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;64;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitViewTests "/root/repo/_wall_build/tests/test_big_integer_dec" "view")
+set_tests_properties(BigIntDecimalDigitViewTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;65;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitHashTests "/root/repo/_wall_build/tests/test_big_integer_dec" "hash")
+set_tests_properties(BigIntDecimalDigitHashTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;66;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitParseTests "/root/repo/_wall_build/tests/test_big_integer_dec" "parse")
+set_tests_properties(BigIntDecimalDigitParseTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;67;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(BigIntDecimalDigitFormatTests "/root/repo/_wall_build/tests/test_big_integer_dec" "format")
+set_tests_properties(BigIntDecimalDigitFormatTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;68;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(StringifierTests "/root/repo/_wall_build/tests/test_stringifier")
+set_tests_properties(StringifierTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;69;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(NumericTests "/root/repo/_wall_build/tests/test_numeric")
+set_tests_properties(NumericTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;70;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(TypesTests "/root/repo/_wall_build/tests/test_types")
+set_tests_properties(TypesTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;71;add_test;/root/repo/tests/CMakeLists.txt;0;")
@@ -0,0 +1,988 @@
+/*
+    bench_big_integer.cpp
+
+
+*/
+
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <functional>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdlib>
+#include <algorithm>
+#include <sstream>
+
+#include "pyc_big_integer.hpp"
+#include "pyc_fixed_integer.hpp"
+#include "pyc_big_integer_view.hpp"
+#include "test_alloc_count.hpp"
+
+/*
+    how to run?
+
+    mkdir -p out && cd out
+    cmake -DCMAKE_BUILD_TYPE=Release ..
+    make && ./bench/bench_big_integer mul
+
+*/
+
+namespace pyc = com::cafrii::pyc;
+using namespace pyc;
+
+
+
+// run fn repeatedly for at least min_sec, and returns average time per call (unit: us)
+static double measure(const std::function<void()>& fn, double min_sec = 0.2)
+{
+    using clock = std::chrono::steady_clock;
+    auto t0 = clock::now();
+    int iter = 0;
+    double elapsed;
+    do {
+        fn();
+        iter++;
+        elapsed = std::chrono::duration<double>(clock::now() - t0).count();
+    } while (elapsed < min_sec);
+    return elapsed / iter * 1e6;
+}
+
+static mpn::LimbVec random_limbs(std::mt19937& gen, int n)
+{
+    mpn::LimbVec v(n);
+    for (auto& x : v) x = mpn::Limb(gen() % mpn::kBase);
+    if (n > 0 && v[n-1] == 0) v[n-1] = 1;
+    return v;
+}
+
+
+/*
+    time of each multiplication tier, for same size operands.
+    it shows where the crossover between tiers sits on this host.
+    slow tiers are skipped for big operands.
+*/
+int bench_mul(int argc, char **argv)
+{
+    std::mt19937 gen(2025);
+    int sizes[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192,
+        16384, 32768, 65536, 131072, 262144 };
+
+    for (bool bSqr : {false, true}) {
+        printf("%s (unit: us)\n", bSqr ? "sqr" : "mul");
+        printf("%8s %10s %12s %12s %12s %12s  %s\n",
+            "limbs", "digits", "basecase", "karatsuba", "toom3", "ntt", "fastest");
+        for (int n : sizes) {
+            auto a = random_limbs(gen, n);
+            auto b = bSqr ? a : random_limbs(gen, n);
+            const mpn::Limb* pa = a.data();
+            const mpn::Limb* pb = bSqr ? pa : b.data();
+            mpn::LimbVec r(2*n);
+
+            double t[4] = { -1, -1, -1, -1 };
+            const char* names[4] = { "basecase", "karatsuba", "toom3", "ntt" };
+            if (n <= 4096)
+                t[0] = measure([&]{
+                    if (bSqr) mpn::SqrBasecase(r.data(), pa, n);
+                    else mpn::MulBasecase(r.data(), pa, n, pb, n);
+                });
+            if (n <= 32768)
+                t[1] = measure([&]{ mpn::MulKaratsuba(r.data(), pa, pb, n); });
+            if (n <= 65536)
+                t[2] = measure([&]{ mpn::MulToom3(r.data(), pa, pb, n); });
+            t[3] = measure([&]{ mpn::MulNtt(r.data(), pa, n, pb, n); });
+
+            int best = 3;
+            for (int k=0; k<4; k++)
+                if (t[k] >= 0 && t[k] < t[best]) best = k;
+
+            // approximate number of decimal digits of n limbs
+            long long digits = (long long)(n * sizeof(mpn::Limb) * 8 * 0.30103);
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+            digits = n;
+#endif
+            printf("%8d %10lld", n, digits);
+            for (int k=0; k<4; k++) {
+                if (t[k] >= 0) printf(" %12.1f", t[k]);
+                else printf(" %12s", "-");
+            }
+            printf("  %s\n", names[best]);
+        }
+        printf("\n");
+    }
+    return 0;
+}
+
+/*
+    time of knuth and burnikel-ziegler division, 2n by n limbs.
+    multiplication of same size is shown for reference.
+*/
+int bench_div(int argc, char **argv)
+{
+    std::mt19937 gen(2025);
+    int sizes[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768 };
+
+    printf("div 2n / n (unit: us)\n");
+    printf("%8s %12s %12s %12s  %s\n", "limbs", "knuth", "bz", "mul n*n", "fastest");
+    for (int n : sizes) {
+        auto a = random_limbs(gen, 2*n);
+        auto b = random_limbs(gen, n);
+        mpn::LimbVec q(n + 1), r(n), p(2*n);
+
+        double tk = -1, tb = -1;
+        if (n <= 8192)
+            tk = measure([&]{ mpn::DivRemKnuth(q.data(), r.data(), a.data(), 2*n, b.data(), n); });
+        if (n > 1)
+            tb = measure([&]{ mpn::DivRemBZ(q.data(), r.data(), a.data(), 2*n, b.data(), n); });
+        double tm = measure([&]{ mpn::Mul(p.data(), a.data(), n, b.data(), n); });
+
+        const char* best = (tk >= 0 && (tb < 0 || tk < tb)) ? "knuth" : "bz";
+        printf("%8d", n);
+        for (double t : {tk, tb, tm}) {
+            if (t >= 0) printf(" %12.1f", t);
+            else printf(" %12s", "-");
+        }
+        printf("  %s\n", best);
+    }
+    return 0;
+}
+
+/*
+    decimal string conversion, 10^3 through 10^7 digits.
+    divide-and-conquer vs O(n^2) chunk loop. (basecase is skipped for big numbers)
+    multiplication of same size is shown for reference.
+*/
+int bench_str(int argc, char **argv)
+{
+    std::mt19937 gen(2025);
+    printf("decimal string conversion (unit: us)\n");
+    printf("%10s %8s %12s %12s %12s %12s %12s\n",
+        "digits", "limbs", "parse", "parse(base)", "print", "print(base)", "mul n*n");
+    for (int digits : { 1000, 10000, 100000, 1000000, 10000000 }) {
+        std::string s(digits, '0');
+        for (auto& c : s) c = char('0' + gen() % 10);
+        s[0] = '1';
+
+        int cap = mpn::LimbsForDigits(digits);
+        mpn::LimbVec a(cap);
+        int n = mpn::SetStr(a.data(), s.data(), digits);
+        std::string out(mpn::DigitsForLimbs(n), ' ');
+        double min_sec = digits >= 1000000 ? 0 : 0.2; // run once for huge ones
+        // powers of 10 are cached by first call. it is not counted.
+        mpn::GetStr(out.data(), a.data(), n);
+
+        double t[5] = { -1, -1, -1, -1, -1 };
+        t[0] = measure([&]{
+            std::fill(a.begin(), a.end(), 0);
+            mpn::SetStr(a.data(), s.data(), digits);
+        }, min_sec);
+        if (digits <= 100000)
+            t[1] = measure([&]{
+                std::fill(a.begin(), a.end(), 0);
+                mpn::SetStrBasecase(a.data(), s.data(), digits);
+            }, min_sec);
+        t[2] = measure([&]{ mpn::GetStr(out.data(), a.data(), n); }, min_sec);
+        if (digits <= 100000)
+            t[3] = measure([&]{ mpn::GetStrBasecase(out.data(), a.data(), n); }, min_sec);
+        mpn::LimbVec r(2*n);
+        t[4] = measure([&]{ mpn::Mul(r.data(), a.data(), n, a.data(), n); }, min_sec);
+
+        printf("%10d %8d", digits, n);
+        for (double x : t) {
+            if (x >= 0) printf(" %12.1f", x);
+            else printf(" %12s", "-");
+        }
+        printf("\n");
+    }
+    return 0;
+}
+
+/*
+    add/sub kernels, on each of cpu feature level.
+    throughput is shown as limbs per ns. unsupported kernels are skipped.
+    PYC_BIGINT_KERNEL env var does not matter here.
+*/
+int bench_addsub(int argc, char **argv)
+{
+    std::mt19937 gen(2025);
+    const char* names[] = { "scalar", "sse4", "avx2", "avx512" };
+    int sizes[] = { 4, 16, 64, 256, 1024, 4096, 16384, 65536, 262144 };
+
+    for (bool bSub : {false, true}) {
+        printf("%s (unit: limbs/ns)\n", bSub ? "sub" : "add");
+        printf("%8s", "limbs");
+        for (auto name : names) printf(" %10s", name);
+        printf("\n");
+        for (int n : sizes) {
+            auto a = random_limbs(gen, n);
+            auto b = random_limbs(gen, n);
+            mpn::LimbVec r(n);
+            printf("%8d", n);
+            for (auto name : names) {
+                if (!mpn::SelectAddSubKernel(name)) {
+                    printf(" %10s", "-");
+                    continue;
+                }
+                double t = measure([&]{
+                    if (bSub) mpn::SubN(r.data(), a.data(), b.data(), n);
+                    else mpn::AddN(r.data(), a.data(), b.data(), n);
+                }, 0.1);
+                printf(" %10.2f", n / (t * 1e3));
+            }
+            printf("\n");
+        }
+        printf("\n");
+    }
+    mpn::SelectAddSubKernel("auto");
+    printf("auto: %s\n", mpn::AddSubKernel());
+    return 0;
+}
+
+/*
+    modular exponentiation, b^e mod m where all of them have same bits.
+    odd modulus runs on montgomery, even one on barrett reduction.
+    plain square-and-multiply with % operator is shown for reference.
+*/
+int bench_powmod(int argc, char **argv)
+{
+    std::mt19937 gen(2025);
+    printf("powmod, same bits of base, exp and mod (unit: us)\n");
+    printf("%6s %12s %12s %12s %12s %12s\n",
+        "bits", "montgomery", "mont(ct)", "barrett", "barrett(ct)", "mul and %");
+    for (int bits : { 256, 512, 1024, 2048, 3072, 4096 }) {
+        int digits = (int)(bits * 0.30103);
+        auto random_big = [&]{
+            std::string sn(digits, '0');
+            for (auto& c : sn) c = char('0' + gen() % 10);
+            sn[0] = char('1' + gen() % 9);
+            return BigInt(sn);
+        };
+        BigInt m = random_big(), b = random_big(), e = random_big();
+        BigInt mo = m % 2 == 0 ? m + 1 : m;
+        BigInt me = m % 2 == 0 ? m : m + 1;
+        b = b % me;
+        ModContext co(mo), ce(me);
+
+        double t[5];
+        t[0] = measure([&]{ co.Pow(b, e); });
+        t[1] = measure([&]{ co.Pow(b, e, true); });
+        t[2] = measure([&]{ ce.Pow(b, e); });
+        t[3] = measure([&]{ ce.Pow(b, e, true); });
+        t[4] = measure([&]{
+            BigInt r = 1, x = b, y = e;
+            while (y > 0) {
+                if (y % 2 == 1) r = r * x % mo;
+                x = x * x % mo;
+                y /= 2;
+            }
+        });
+        printf("%6d", bits);
+        for (double x : t) printf(" %12.1f", x);
+        printf("\n");
+    }
+    return 0;
+}
+
+/*
+    gcd of two random numbers of same size.
+    euclid (division per quotient), lehmer, and lehmer + half-gcd.
+    slow ones are skipped for big numbers.
+*/
+int bench_gcd(int argc, char **argv)
+{
+    std::mt19937 gen(2025);
+    printf("gcd (unit: us)\n");
+    printf("%8s %12s %12s %12s %12s  %s\n", "limbs", "euclid", "lehmer", "gcd", "mul n*n", "fastest");
+    for (int n : { 2, 4, 16, 64, 256, 512, 1024, 2048, 4096, 16384, 65536 }) {
+        auto a = random_limbs(gen, n);
+        auto b = random_limbs(gen, n);
+        mpn::LimbVec g(n), p(2*n);
+        double min_sec = n >= 16384 ? 0 : 0.2;
+
+        double t[4] = { -1, -1, -1, -1 };
+        if (n <= 4096)
+            t[0] = measure([&]{ mpn::GcdEuclid(g.data(), a.data(), n, b.data(), n); }, min_sec);
+        if (n <= 16384)
+            t[1] = measure([&]{ mpn::GcdLehmer(g.data(), a.data(), n, b.data(), n); }, min_sec);
+        t[2] = measure([&]{ mpn::Gcd(g.data(), a.data(), n, b.data(), n); }, min_sec);
+        t[3] = measure([&]{ mpn::Mul(p.data(), a.data(), n, b.data(), n); }, min_sec);
+
+        int best = 2;
+        for (int k=0; k<3; k++)
+            if (t[k] >= 0 && t[k] < t[best]) best = k;
+        const char* names[3] = { "euclid", "lehmer", "gcd" };
+        printf("%8d", n);
+        for (double x : t) {
+            if (x >= 0) printf(" %12.1f", x);
+            else printf(" %12s", "-");
+        }
+        printf("  %s\n", names[best]);
+    }
+    return 0;
+}
+
+/*
+    isqrt and cube root of random number, compared with a multiplication
+    of root size. (a has 2n limbs for sqrt, 3n limbs for cube root)
+*/
+int bench_root(int argc, char **argv)
+{
+    std::mt19937 gen(2026);
+    printf("root (unit: us)\n");
+    printf("%8s %12s %12s %12s %10s\n", "n", "mul n*n", "isqrt(2n)", "iroot3(3n)", "sqrt/mul");
+    for (int n : { 1, 4, 16, 64, 256, 1024, 4096, 16384, 65536, 262144 }) {
+        auto a = random_limbs(gen, 3 * n);
+        mpn::LimbVec p(2 * n), s(3 * n);
+        double min_sec = n >= 16384 ? 0 : 0.2;
+
+        double tm = measure([&]{ mpn::Mul(p.data(), a.data(), n, a.data() + n, n); }, min_sec);
+        int rn;
+        mpn::LimbVec r(n + 2);
+        double ts = measure([&]{ mpn::SqrtRem(s.data(), r.data(), a.data(), 2 * n, rn); }, min_sec);
+        double tc = measure([&]{ mpn::Root(s.data(), a.data(), 3 * n, 3); }, min_sec);
+        printf("%8d %12.1f %12.1f %12.1f %10.1f\n", n, tm, ts, tc, ts / tm);
+    }
+    return 0;
+}
+
+/*
+    bitwise operators on negative numbers (two's complement on the fly),
+    compared with a decimal round trip of same number, which is what
+    bit manipulation through strings would cost at least.
+*/
+int bench_bit(int argc, char **argv)
+{
+    std::mt19937 gen(2027);
+    auto random_big = [&](int digits) {
+        std::string sn(digits, '0');
+        for (auto& c : sn) c = char('0' + gen() % 10);
+        sn[0] = char('1' + gen() % 9);
+        return BigInt(sn);
+    };
+    printf("bitwise (unit: ns)\n");
+    printf("%8s %10s %10s %10s %10s %10s %12s\n", "digits", "a & b", "a ^ b", "a << 77", "a >> 77", "bit_count", "str trip");
+    for (int digits : { 18, 150, 1200, 10000, 100000 }) {
+        BigInt a = -random_big(digits), b = random_big(digits), r;
+        double min_sec = 0.1;
+        double t[6];
+        t[0] = measure([&]{ r = a; r &= b; }, min_sec);
+        t[1] = measure([&]{ r = a; r ^= b; }, min_sec);
+        t[2] = measure([&]{ r = a; r <<= 77; }, min_sec);
+        t[3] = measure([&]{ r = a; r >>= 77; }, min_sec);
+        volatile long long c;
+        t[4] = measure([&]{ c = a.BitCount(); }, min_sec);
+        t[5] = measure([&]{ r = BigInt(a.ToStr()); }, min_sec);
+        (void)c;
+        printf("%8d", digits);
+        for (double x : t) printf(" %10.0f", x * 1e3);
+        printf("\n");
+    }
+    return 0;
+}
+
+/*
+    speedup of parallel mode, for huge multiplication and string conversion.
+    thread counts are given as args. (default: 1 2 4 8 and all hardware threads)
+*/
+int bench_parallel(int argc, char **argv)
+{
+    std::vector<int> threads;
+    for (int i=1; i<argc; i++) threads.push_back(atoi(argv[i]));
+    if (threads.empty()) threads = { 1, 2, 4, 8, 0 };
+
+    std::mt19937 gen(2028);
+    printf("parallel mode (unit: ms)\n");
+    printf("%10s %8s %8s %12s %12s %12s\n", "digits", "limbs", "threads", "mul n*n", "parse", "print");
+    for (int digits : { 100000, 1000000, 10000000 }) {
+        std::string s(digits, '0');
+        for (auto& c : s) c = char('0' + gen() % 10);
+        s[0] = '1';
+        int cap = mpn::LimbsForDigits(digits);
+        mpn::LimbVec a(cap);
+        int n = mpn::SetStr(a.data(), s.data(), digits);
+        std::string out(mpn::DigitsForLimbs(n), ' ');
+        mpn::LimbVec r(2*n);
+        mpn::GetStr(out.data(), a.data(), n); // powers of 10 are cached.
+
+        for (int th : threads) {
+            mpn::SetThreadCount(th);
+            double min_sec = digits >= 1000000 ? 0 : 0.2;
+            double t[3];
+            t[0] = measure([&]{ mpn::Mul(r.data(), a.data(), n, a.data(), n); }, min_sec);
+            t[1] = measure([&]{
+                std::fill(a.begin(), a.end(), 0);
+                mpn::SetStr(a.data(), s.data(), digits);
+            }, min_sec);
+            t[2] = measure([&]{ mpn::GetStr(out.data(), a.data(), n); }, min_sec);
+            printf("%10d %8d %8d", digits, n, mpn::ThreadCount());
+            for (double x : t) printf(" %12.1f", x * 1e-3);
+            printf("\n");
+        }
+    }
+    mpn::SetThreadCount(1);
+    return 0;
+}
+
+
+/*
+    factorial and comb by prime factorization, compared with the naive
+    loop of one term at a time. (skipped for big n)
+*/
+int bench_comb(int argc, char **argv)
+{
+    printf("combinatorics (unit: ms)\n");
+    printf("%10s %12s %12s %12s %12s\n", "n", "factorial", "naive", "comb(n,n/2)", "comb(n,100)");
+    for (int n : { 1000, 10000, 100000, 1000000 }) {
+        double min_sec = n >= 100000 ? 0 : 0.2;
+        BigInt r;
+        double t[4] = { -1, -1, -1, -1 };
+        t[0] = measure([&]{ r = factorial(n); }, min_sec);
+        if (n <= 100000)
+            t[1] = measure([&]{
+                r = 1;
+                for (int i=2; i<=n; i++) r *= i;
+            }, min_sec);
+        t[2] = measure([&]{ r = comb(n, n / 2); }, min_sec);
+        t[3] = measure([&]{ r = comb(n, 100); }, min_sec);
+        printf("%10d", n);
+        for (double x : t) {
+            if (x >= 0) printf(" %12.2f", x * 1e-3);
+            else printf(" %12s", "-");
+        }
+        printf("\n");
+    }
+    return 0;
+}
+
+/*
+    FixedInt against BigInt of same values, for bounded 128..512 bit numbers.
+    BigInt needs heap above 64 bits, FixedInt never does.
+*/
+template <typename T>
+static void bench_fixed_one(std::mt19937& gen)
+{
+    BigInt a = 1, b = 1;
+    for (int k=0; k<T::kBits/2 - 1; k+=32) {
+        a = (a << 32) + BigInt((long long)gen());
+        b = (b << 32) + BigInt((long long)gen());
+    }
+    T x(a), y(b), r;
+    BigInt s;
+    double t[6];
+    t[0] = measure([&]{ r = x + y; }, 0.1);
+    t[1] = measure([&]{ r = x * y; }, 0.1);
+    t[2] = measure([&]{ r = (x * y) / y; }, 0.1);
+    t[3] = measure([&]{ s = a + b; }, 0.1);
+    t[4] = measure([&]{ s = a * b; }, 0.1);
+    t[5] = measure([&]{ s = (a * b) / b; }, 0.1);
+    volatile unsigned long long sink = r.Low64() + (unsigned long long)s.IsZero();
+    (void)sink;
+    printf("%6d", T::kBits);
+    for (double v : t) printf(" %10.1f", v * 1e3);
+    printf("\n");
+}
+
+int bench_fixed(int argc, char **argv)
+{
+    std::mt19937 gen(2029);
+    printf("fixed width vs BigInt (unit: ns)\n");
+    printf("%6s %10s %10s %10s %10s %10s %10s\n", "bits", "fix +", "fix *", "fix * /", "big +", "big *", "big * /");
+    bench_fixed_one<Int128>(gen);
+    bench_fixed_one<Int256>(gen);
+    bench_fixed_one<Int512>(gen);
+    return 0;
+}
+
+/*
+    native integer operand against BigInt one, for counters and small steps.
+    "1" is how operator++ used to add one.
+*/
+int bench_native(int argc, char **argv)
+{
+    printf("native operand (unit: ns)\n");
+    printf("%8s %10s %10s %10s %10s %10s %10s\n", "digits", "++x", "x += 5", "x += \"1\"", "x += B(5)", "x * 7", "x < 5");
+    for (int digits : { 10, 30, 100, 1000 }) {
+        std::string sn(digits, '7');
+        BigInt x(sn), r;
+        volatile bool b;
+        double t[6];
+        t[0] = measure([&]{ ++x; }, 0.1);
+        t[1] = measure([&]{ x += 5; }, 0.1);
+        t[2] = measure([&]{ x += BigInt("1"); }, 0.1);
+        t[3] = measure([&]{ x += BigInt(5); }, 0.1);
+        t[4] = measure([&]{ r = x * 7; }, 0.1);
+        t[5] = measure([&]{ b = x < 5; }, 0.1);
+        (void)b;
+        printf("%8d", digits);
+        for (double v : t) printf(" %10.1f", v * 1e3);
+        printf("\n");
+    }
+    return 0;
+}
+
+/*
+    conversion to native numbers, against detour through decimal string.
+    ToStr+strtod is what caller had to do before ToDouble.
+*/
+int bench_conv(int argc, char **argv)
+{
+    printf("conversion (unit: ns)\n");
+    printf("%8s %10s %10s %10s %10s\n", "digits", "To<i64>", "ToDouble", "str+strtod", "truediv");
+    for (int digits : { 15, 30, 100, 300 }) {
+        std::string sn(digits, '7');
+        BigInt x(sn), y(std::string(digits / 2 + 1, '3'));
+        volatile double d;
+        volatile long long v;
+        double t[4];
+        t[0] = digits < 19 ? measure([&]{ v = x.ToInt64(); }, 0.1) : -1;
+        t[1] = measure([&]{ d = x.ToDouble(); }, 0.1);
+        t[2] = measure([&]{ d = strtod(x.ToStr().c_str(), nullptr); }, 0.1);
+        t[3] = measure([&]{ d = truediv(x, y); }, 0.1);
+        (void)d; (void)v;
+        printf("%8d", digits);
+        for (double u : t) {
+            if (u >= 0) printf(" %10.1f", u * 1e3);
+            else printf(" %10s", "-");
+        }
+        printf("\n");
+    }
+    return 0;
+}
+
+/*
+    bulk serialization of many values, against decimal text.
+    size column is total bytes of each format.
+*/
+int bench_bytes(int argc, char **argv)
+{
+    std::mt19937 gen(2035);
+    const int count = 10000;
+    printf("serialization of %d values (unit: us)\n", count);
+    printf("%8s %10s %10s %10s %10s %10s %10s\n", "digits", "encode", "decode", "ToStr", "parse", "bin size", "str size");
+    for (int digits : { 10, 30, 100, 1000 }) {
+        std::vector<BigInt> v;
+        for (int i=0; i<count; i++) {
+            std::string sn(digits, '0');
+            for (auto& c : sn) c = char('0' + gen() % 10);
+            sn[0] = char('1' + gen() % 9);
+            v.emplace_back(sn);
+        }
+        std::vector<std::byte> buf(BigInt::EncodedSize(v));
+        std::vector<BigInt> w;
+        std::vector<std::string> strs;
+        size_t ssize = 0;
+        double t[4];
+        t[0] = measure([&]{ BigInt::EncodeAll(v, buf); }, 0.2);
+        t[1] = measure([&]{ w.clear(); BigInt::DecodeAll(buf, w); }, 0.2);
+        t[2] = measure([&]{ strs.clear(); for (auto& x : v) strs.push_back(x.ToStr()); }, 0.2);
+        t[3] = measure([&]{ w.clear(); for (auto& s : strs) w.emplace_back(s); }, 0.2);
+        for (auto& s : strs) ssize += s.size() + 1;
+        printf("%8d", digits);
+        for (double u : t) printf(" %10.1f", u);
+        printf(" %10zu %10zu\n", buf.size(), ssize);
+    }
+    return 0;
+}
+
+/*
+    startup cost of a big constant: parse of decimal text, decode of compact
+    encoding, and view over raw limbs (as from mapped file), then one use of it.
+*/
+int bench_view(int argc, char **argv)
+{
+    std::mt19937 gen(2036);
+    printf("load of constant (unit: us)\n");
+    printf("%8s %10s %10s %10s %10s %10s\n", "digits", "parse", "decode", "view", "y += x", "y += view");
+    for (int digits : { 10000, 100000, 1000000 }) {
+        std::string sn(digits, '0');
+        for (auto& c : sn) c = char('0' + gen() % 10);
+        sn[0] = char('1' + gen() % 9);
+        const BigInt x(sn);
+        std::vector<std::byte> enc(x.EncodedSize());
+        x.Encode(enc);
+        auto limbs = BigIntView(x).Limbs();
+        std::vector<std::byte> file(limbs.size_bytes());
+        std::memcpy(file.data(), limbs.data(), file.size());
+        BigInt r, y = x;
+        BigIntView v;
+        double t[5];
+        t[0] = measure([&]{ r = BigInt(sn); }, 0.2);
+        t[1] = measure([&]{ r = BigInt::Decode(enc); }, 0.2);
+        t[2] = measure([&]{ v = BigIntView::FromBytes(file); }, 0.2);
+        t[3] = measure([&]{ y += r; }, 0.2);
+        t[4] = measure([&]{ y += v; }, 0.2);
+        printf("%8d", digits);
+        for (double u : t) printf(" %10.2f", u);
+        printf("\n");
+    }
+    return 0;
+}
+
+/*
+    comparison, for sorted index and dedup.
+    near values differ only at the lowest limb, so the whole magnitude is scanned.
+    sort is of 100000 values with same number of digits and common top half, by pointer.
+*/
+int bench_compare(int argc, char **argv)
+{
+    std::mt19937 gen(2037);
+    printf("comparison (unit: ns, sort: ms)\n");
+    printf("%8s %10s %10s %10s %10s\n", "digits", "near <", "equal ==", "near <=>", "sort");
+    for (int digits : { 20, 100, 1000, 10000 }) {
+        std::string sn(digits, '0');
+        for (auto& c : sn) c = char('0' + gen() % 10);
+        sn[0] = char('1' + gen() % 9);
+        const BigInt a(sn), b = a + 1, c = a;
+        std::vector<BigInt> v;
+        for (int i=0; i<100000; i++) {
+            std::string t = sn;
+            for (int k=digits/2; k<digits; k++) t[k] = char('0' + gen() % 10);
+            v.emplace_back(t);
+        }
+        volatile bool r;
+        volatile int o;
+        double t[4];
+        t[0] = measure([&]{ r = a < b; }, 0.1);
+        t[1] = measure([&]{ r = a == c; }, 0.1);
+        t[2] = measure([&]{ o = (a <=> b) < 0 ? -1 : 1; }, 0.1);
+        (void)r; (void)o;
+        // pointers are sorted, so that only comparison is measured.
+        std::vector<const BigInt*> w;
+        t[3] = measure([&]{
+                w.clear();
+                for (auto& x : v) w.push_back(&x);
+                std::sort(w.begin(), w.end(), [](const BigInt* x, const BigInt* y) { return *x < *y; });
+            }, 0.5);
+        printf("%8d", digits);
+        for (int i=0; i<3; i++) printf(" %10.1f", t[i] * 1e3);
+        printf(" %10.2f\n", t[3] * 1e-3);
+    }
+    return 0;
+}
+
+// hash of decimal string, which was the workaround before std::hash<BigInt>.
+struct StrHash
+{
+    size_t operator()(const BigInt& a) const { return std::hash<std::string>{}(a.ToStr()); }
+};
+
+template <typename Hash>
+static void bench_hash_map(const char* name, const std::vector<BigInt>& keys)
+{
+    using clock = std::chrono::steady_clock;
+    std::unordered_map<BigInt, int, Hash> m;
+    m.reserve(keys.size());
+    auto t0 = clock::now();
+    for (size_t i=0; i<keys.size(); i++)
+        m.emplace(keys[i], (int)i);
+    auto t1 = clock::now();
+    long long sum = 0;
+    for (const BigInt& k : keys)
+        sum += m.find(k)->second;
+    auto t2 = clock::now();
+    double ti = std::chrono::duration<double>(t1 - t0).count(), tf = std::chrono::duration<double>(t2 - t1).count();
+    printf("%10s %10.0f %10.0f %10.1f %10.1f  (%lld)\n", name, ti * 1e3, tf * 1e3,
+        ti / keys.size() * 1e9, tf / keys.size() * 1e9, sum % 1000);
+}
+
+/*
+    std::hash<BigInt> against hash of ToStr(), for one value and for a hash map.
+    map keys are about 100 bits, beyond inline storage. count is 10M by default.
+*/
+int bench_hash(int argc, char **argv)
+{
+    long count = argc >= 2 ? atol(argv[1]) : 10000000;
+    printf("hash of one value (unit: ns)\n");
+    printf("%8s %10s %10s\n", "digits", "Hash", "ToStr");
+    for (int digits : { 18, 40, 100, 1000 }) {
+        const BigInt x(std::string(digits, '7'));
+        volatile size_t h;
+        double t[2];
+        t[0] = measure([&]{ h = std::hash<BigInt>{}(x); }, 0.1);
+        t[1] = measure([&]{ h = StrHash{}(x); }, 0.1);
+        (void)h;
+        printf("%8d %10.1f %10.1f\n", digits, t[0] * 1e3, t[1] * 1e3);
+    }
+
+    std::vector<BigInt> keys;
+    keys.reserve(count);
+    const BigInt base = BigInt(1) << 100;
+    for (long i=0; i<count; i++)
+        keys.push_back(base + BigInt(i) * 0x9E3779B97F4A7C15ULL);
+    printf("\nunordered_map of %ld keys (total: ms, per key: ns)\n", count);
+    printf("%10s %10s %10s %10s %10s\n", "hash", "insert", "find", "insert/k", "find/k");
+    {
+        // first pass takes page faults of node allocation. later ones reuse freed memory.
+        std::unordered_map<BigInt, int> warm;
+        warm.reserve(keys.size());
+        for (size_t i=0; i<keys.size(); i++)
+            warm.emplace(keys[i], (int)i);
+    }
+    bench_hash_map<std::hash<BigInt>>("Hash", keys);
+    bench_hash_map<StrHash>("ToStr", keys);
+    return 0;
+}
+
+/*
+    parse of decimal text which comes in pieces, as read from file or socket.
+    whole string (needs all text in memory) against BigIntParser by 64KB chunk,
+    and operator>> of istream.
+*/
+int bench_parse(int argc, char **argv)
+{
+    std::mt19937 gen(2038);
+    printf("parse (unit: ms)\n");
+    printf("%8s %10s %10s %10s\n", "digits", "string", "chunked", "istream");
+    for (int digits : { 10000, 100000, 1000000, 4000000 }) {
+        std::string sn(digits, '0');
+        for (auto& c : sn) c = char('0' + gen() % 10);
+        sn[0] = char('1' + gen() % 9);
+        BigInt r;
+        double t[3];
+        t[0] = measure([&]{ r = BigInt(sn); }, 0.2);
+        t[1] = measure([&]{
+                BigIntParser p;
+                for (size_t pos=0; pos<sn.size(); pos+=65536)
+                    p.Feed(std::string_view(sn).substr(pos, 65536));
+                r = p.Finish();
+            }, 0.2);
+        t[2] = measure([&]{
+                std::istringstream is(sn);
+                is >> r;
+            }, 0.2);
+        printf("%8d", digits);
+        for (double u : t) printf(" %10.2f", u * 1e-3);
+        printf("\n");
+    }
+    return 0;
+}
+
+/*
+    formatted output, as of log writer. ostream writes to a reused buffer,
+    so that only conversion is measured.
+*/
+int bench_format(int argc, char **argv)
+{
+    std::mt19937 gen(2039);
+    printf("format (unit: ns)\n");
+    printf("%8s %10s %10s %10s %10s %10s\n", "digits", "ToStr", "{:,}", "{:>30}", "{:x}", "ostream");
+    for (int digits : { 10, 19, 40, 100, 1000, 10000 }) {
+        std::string sn(digits, '0');
+        for (auto& c : sn) c = char('0' + gen() % 10);
+        sn[0] = char('1' + gen() % 9);
+        const BigInt x(sn);
+        std::string r;
+        std::ostringstream os;
+        double t[5];
+        t[0] = measure([&]{ r = x.ToStr(); }, 0.1);
+        t[1] = measure([&]{ r = x.Format(","); }, 0.1);
+        t[2] = measure([&]{ r = x.Format(">30"); }, 0.1);
+        t[3] = measure([&]{ r = x.Format("x"); }, 0.1);
+        t[4] = measure([&]{ os.seekp(0); os << x; }, 0.1);
+        printf("%8d", digits);
+        for (double u : t) printf(" %10.1f", u * 1e3);
+        printf("\n");
+    }
+    return 0;
+}
+
+// result of one op of suite
+struct OpStat
+{
+    const char* op;
+    long long digits;
+    double ns;          // per op
+    double allocs;      // per op
+    long long iters;
+};
+
+// as measure(), with count of allocations. fn does nops operations per call.
+static OpStat measure_op(const char* op, long long digits, const std::function<void()>& fn,
+    double min_sec, int nops = 1)
+{
+    using clock = std::chrono::steady_clock;
+    fn(); // warm up, for caches and scratch buffers
+    long long a0 = g_num_alloc.load();
+    auto t0 = clock::now();
+    long long iter = 0;
+    double elapsed;
+    do {
+        fn();
+        iter++;
+        elapsed = std::chrono::duration<double>(clock::now() - t0).count();
+    } while (elapsed < min_sec);
+    long long n = iter * nops;
+    return { op, digits, elapsed / n * 1e9, double(g_num_alloc.load() - a0) / n, n };
+}
+
+static std::string random_digits(std::mt19937& gen, long long n)
+{
+    std::string sn(n, '0');
+    for (auto& c : sn) c = char('0' + gen() % 10);
+    sn[0] = char('1' + gen() % 9);
+    return sn;
+}
+
+/*
+    basic operations of BigInt, for operand sizes from 10 to 10^7 decimal digits.
+    reports time per op, digits per second and heap allocations per op,
+    and writes json to be compared across commits and compiler flags.
+
+        suite [--max digits] [--time sec] [--tag name] [--json path]
+
+    digits is the size of operands. div is 2n by n digits, pow is (n/8 digits)^8,
+    and long long is of 18 digits. compare is of values differ only in the lowest limb.
+    move is move construction and move assignment, one each.
+*/
+int bench_suite(int argc, char **argv)
+{
+    long long maxDigits = 10000000;
+    double minSec = 0.2;
+    const char* tag = "";
+    const char* json = nullptr;
+    for (int i=1; i+1<argc; i+=2) {
+        if (!strcmp(argv[i], "--max")) maxDigits = atoll(argv[i+1]);
+        else if (!strcmp(argv[i], "--time")) minSec = atof(argv[i+1]);
+        else if (!strcmp(argv[i], "--tag")) tag = argv[i+1];
+        else if (!strcmp(argv[i], "--json")) json = argv[i+1];
+        else {
+            printf("unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::mt19937 gen(2040);
+    std::vector<OpStat> stats;
+    auto report = [&](const OpStat& st) {
+        printf("%-8s %10lld %14.1f %14.4g %10.2f\n", st.op, st.digits, st.ns,
+            st.digits / (st.ns * 1e-9), st.allocs);
+        fflush(stdout);
+        stats.push_back(st);
+    };
+    printf("%-8s %10s %14s %14s %10s\n", "op", "digits", "ns/op", "digits/s", "allocs/op");
+    {
+        volatile long long v = 123456789012345678LL;
+        BigInt r;
+        report(measure_op("from_ll", 18, [&]{ r = BigInt(v); }, minSec));
+    }
+    for (long long n=10; n<=maxDigits; n*=10) {
+        const std::string sa = random_digits(gen, n), sb = random_digits(gen, n);
+        const BigInt a(sa), b(sb), a1 = a + 1;
+        BigInt r, m = a;
+        volatile bool c;
+        std::string s;
+        report(measure_op("parse", n, [&]{ r = BigInt(sa); }, minSec));
+        report(measure_op("to_str", n, [&]{ s = a.ToStr(); }, minSec));
+        report(measure_op("add", n, [&]{ r = a + b; }, minSec));
+        report(measure_op("sub", n, [&]{ r = a - b; }, minSec));
+        report(measure_op("compare", n, [&]{ c = a < a1; }, minSec));
+        report(measure_op("copy", n, [&]{ r = a; }, minSec));
+        report(measure_op("move", n, [&]{ BigInt t(std::move(m)); m = std::move(t); }, minSec, 2));
+        report(measure_op("mul", n, [&]{ r = a * b; }, minSec));
+        const BigInt a2 = a * b;
+        report(measure_op("div", n, [&]{ r = a2 / b; }, minSec));
+        const BigInt x(sa.substr(0, std::max(1LL, n / 8)));
+        report(measure_op("pow", n, [&]{ r = BigInt::Pow(x, 8); }, minSec));
+        (void)c;
+    }
+
+    if (json) {
+        FILE* fp = strcmp(json, "-") ? fopen(json, "w") : stdout;
+        if (!fp) {
+            printf("can not open %s\n", json);
+            return 1;
+        }
+        fprintf(fp, "{\n  \"tag\": \"%s\",\n", tag);
+#if defined(__VERSION__)
+        fprintf(fp, "  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+#if defined(__OPTIMIZE__)
+        fprintf(fp, "  \"optimized\": true,\n");
+#else
+        fprintf(fp, "  \"optimized\": false,\n");
+#endif
+        fprintf(fp, "  \"limb_bits\": %d,\n", (int)(sizeof(mpn::Limb) * 8));
+        fprintf(fp, "  \"results\": [\n");
+        for (size_t i=0; i<stats.size(); i++) {
+            const OpStat& st = stats[i];
+            fprintf(fp, "    { \"op\": \"%s\", \"digits\": %lld, \"ns_per_op\": %.1f, \"digits_per_sec\": %.6g, "
+                "\"allocs_per_op\": %.3f, \"iterations\": %lld }%s\n", st.op, st.digits, st.ns,
+                st.digits / (st.ns * 1e-9), st.allocs, st.iters, i + 1 < stats.size() ? "," : "");
+        }
+        fprintf(fp, "  ]\n}\n");
+        if (fp != stdout)
+            fclose(fp);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+	printf("benchmark of pyc big integer\n");
+
+	if (argc >= 2 && !strcmp(argv[1], "mul"))
+		return bench_mul(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "div"))
+		return bench_div(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "str"))
+		return bench_str(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "addsub"))
+		return bench_addsub(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "powmod"))
+		return bench_powmod(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "gcd"))
+		return bench_gcd(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "root"))
+		return bench_root(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "bit"))
+		return bench_bit(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "parallel"))
+		return bench_parallel(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "comb"))
+		return bench_comb(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "fixed"))
+		return bench_fixed(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "native"))
+		return bench_native(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "conv"))
+		return bench_conv(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "bytes"))
+		return bench_bytes(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "view"))
+		return bench_view(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "compare"))
+		return bench_compare(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "hash"))
+		return bench_hash(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "parse"))
+		return bench_parse(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "format"))
+		return bench_format(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "suite"))
+		return bench_suite(argc-1, ((argv[1] = argv[0]), argv+1));
+
+	printf("usage: %s mode [args..]\n", argv[0]);
+	printf("   mul\n");
+	printf("   div\n");
+	printf("   str\n");
+	printf("   addsub\n");
+	printf("   powmod\n");
+	printf("   gcd\n");
+	printf("   root\n");
+	printf("   bit\n");
+	printf("   parallel [threads..]\n");
+	printf("   comb\n");
+	printf("   fixed\n");
+	printf("   native\n");
+	printf("   conv\n");
+	printf("   bytes\n");
+	printf("   view\n");
+	printf("   compare\n");
+	printf("   hash [count]\n");
+	printf("   parse\n");
+	printf("   format\n");
+	printf("   suite [--max digits] [--time sec] [--tag name] [--json path]\n");
+	return 0;
+}
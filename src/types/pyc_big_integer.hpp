@@ -20,11 +20,35 @@
 
 
 #include <string_view>
-// #include <string>
+#include <string>
 #include <vector>
 #include <utility> // in_range
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include <memory_resource>
+#include <climits>
+#include <numeric> // gcd
+#include <functional> // bit_and
+#include <bit>
+#include <compare>
+#include <span>
+#include <istream>
+#include <ostream>
+#include <cstddef> // byte
+#include <concepts>
+#include <type_traits>
+#include <cmath> // lgamma
+#include <cfloat>
+#include <limits>
+#include <version>
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
 
 #include "pyc_compare.hpp"
+#include "pyc_big_integer_kernel.hpp"
 
 
 //============================================================================
@@ -40,6 +64,11 @@ namespace com::cafrii::pyc {
 
 //============================================================================
 
+// lazy expression node. see pyc_big_integer_expr.hpp
+template <typename E> class BigIntExpr;
+// read only view over limbs. see pyc_big_integer_view.hpp
+class BigIntView;
+
 /*
     there are many similar implementations for open internet.
     - https://beeslog.tistory.com/214
@@ -59,65 +88,183 @@ namespace com::cafrii::pyc {
 class BigInt
 {
     // class 내부에 공통적으로 영향을 끼치는 using namespace 대신, 꼭 필요한 일부 타입만 차용한다.
-    using Digit = uint8_t;
-        // actually, any type T where digit 0..9 can be stored is allowed.
-    using DgtVec = std::vector<Digit>;
+    using Limb = mpn::Limb;
+        // base 2^32 word, or one decimal digit if PYCFG_BIGINT_DECIMAL_DIGIT.
+    using LimbVec = mpn::LimbVec;
+        // scratch buffer
+    using LimbBuf = mpn::LimbBuf;
+        // storage of magnitude. small number is stored inline, without heap.
 
     using string = std::string;
     using cstring = const std::string &;
 
+    template <typename E> friend class BigIntExpr;
+    friend class ModContext;
+    friend class BigIntView;
+
 protected:
     /*
         number is stored as sign-flag and magnitude.
 
-        each digit in magnitude is stored as one element of vector array.
-        big number is stored reverse order.
-        for example, integer 2025 is stored as { 5, 2, 0, 2 }.
+        magnitude is stored as array of limbs, in base mpn::kBase.
+        big number is stored reverse order. (least significant limb first)
+        for example, integer 2^40 + 5 is stored as { 5, 256 } with 2^32 base,
+        and integer 2025 is stored as { 5, 2, 0, 2 } with legacy decimal digit.
 
         unnecessary trailing 0 is not allowed.
             ex: {3,2,1,0,0} is not allowed. it should be {3,2,1}.
-        in case of zero, magnitude contains one zero digit. {0}.
+        in case of zero, magnitude contains one zero limb. {0}.
 
         negative zero is not allowed. ex: {0} with m_sign=true is not allowed.
 
+        up to 2 limbs (64 bits) are stored inline, so int64 range arithmetic
+        does not allocate. there is no vtable, and sizeof(BigInt) is 24.
+        m_sign is placed in tail padding of m_limbs, by [[no_unique_address]].
     */
+    [[no_unique_address]] LimbBuf m_limbs;
     bool m_sign = false;  // true if negative
-    DgtVec m_digits;
 
     // internall accessor. it does not check boundness!
-    Digit& operator[](int k) { return m_digits[k]; }
-    const Digit& operator[](int k) const { return m_digits[k]; }
+    Limb& operator[](int k) { return m_limbs[k]; }
+    const Limb& operator[](int k) const { return m_limbs[k]; }
 
 public:
     // debugging
+    // decimal string. opts is python format spec, same as Format().
     string ToStr(cstring opts="") const;
     string Describe() const;
 
+public:
+    /*
+        python format spec of int.
+            [[fill]align][sign][#][0][width][grouping][type]
+        align: '<', '>', '=', '^'. sign: '+', '-', ' '. grouping: ',' or '_'.
+        type: 'd', 'n' (same as 'd'), 'x', 'X', 'o', 'b'. fill is one char.
+    */
+    struct FormatSpec {
+        char fill = ' ';
+        char align = 0;     // 0 is right, for number.
+        char sign = '-';
+        bool alt = false;   // '#', base prefix.
+        char group = 0;
+        char type = 'd';
+        int width = 0;
+
+        // returns error message, or nullptr if ok. constexpr for std::format check.
+        static constexpr const char* Parse(std::string_view s, FormatSpec& spec);
+        // number base of type, and bits per digit. (0 for decimal)
+        constexpr int Bits() const { return type == 'x' || type == 'X' ? 4 : type == 'o' ? 3 : type == 'b' ? 1 : 0; }
+    };
+
+    // formatted string. throws std::invalid_argument if spec is not valid.
+    string Format(std::string_view spec) const;
+    // buffer size enough for FormatTo(). it is the exact length for power of 2 bases,
+    // and a few more for decimal.
+    size_t FormattedSize(const FormatSpec& spec) const;
+    // writes formatted text into buf of FormattedSize(). returns its length.
+    // digits are made in place, without intermediate string.
+    size_t FormatTo(char* buf, const FormatSpec& spec) const;
+
+    // pieces of formatted text, in order: fill * left, prefix, fill * mid, body, fill * right
+    struct FormatParts {
+        long long left = 0, mid = 0, right = 0;
+        char prefix[4] = {};    // sign and base prefix
+        int prefixLen = 0;
+        const char* body = nullptr;     // digits, with separators and zero padding
+        long long bodyLen = 0;
+        size_t Size() const { return (size_t)(left + prefixLen + mid + bodyLen + right); }
+    };
+    // makes body in work of FormattedSize(). fill is not written, so that sink
+    // (stream, output iterator) takes the pieces as they are, without assembly.
+    FormatParts Layout(char* work, const FormatSpec& spec) const;
+
+    /*
+        work buffer of Layout() for output to stream or iterator, kept per thread.
+        nothing is allocated per call once it is grown. buffer over kKeep
+        (or nested use of it) takes its own heap block, not to keep big one forever.
+    */
+    class FormatBuffer
+    {
+    public:
+        static constexpr size_t kKeep = 1 << 20;
+        explicit FormatBuffer(size_t n);
+        ~FormatBuffer();
+        FormatBuffer(const FormatBuffer&) = delete;
+        FormatBuffer& operator=(const FormatBuffer&) = delete;
+        char* data() { return m_p; }
+    private:
+        char* m_p;
+        bool m_local = false;
+        std::string m_heap;
+    };
+
 public:
     // static const int kDefWidth = 8; // not used.
 
+public:
+    /*
+        allocator-aware, with std::pmr.
+        without allocator, std::pmr::get_default_resource() is used.
+        copy constructor takes the default resource, like std::pmr containers.
+        Clone() keeps the resource of source, and BigInt(x, alloc) chooses one.
+        operator results come from Clone() of the left operand,
+        so that temporaries of an expression (a + b - c) stay on a's resource.
+        resource never changes after construction, even by assignment.
+    */
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    allocator_type get_allocator() const { return allocator_type(m_limbs.resource()); }
+
 public:
     // ctor
     BigInt();
-    BigInt(long long nr);
-    BigInt(int nr): BigInt((long long)nr) {}
+    explicit BigInt(const allocator_type& alloc);
+    // any native integer type, signed or unsigned.
     // BigInt(0) will be treated as integer 0, not 'NULL'.
+    template <std::integral T>
+    BigInt(T nr, const allocator_type& alloc = {}): BigInt(NativeNeg(nr), NativeMag(nr), alloc) {}
 
-    BigInt(const string& s);
-    BigInt(const char* cs): BigInt(string(cs)) {}
+    BigInt(const string& s, const allocator_type& alloc = {});
+    BigInt(const char* cs, const allocator_type& alloc = {}): BigInt(string(cs), alloc) {}
 
-    // dtor
-    virtual ~BigInt() {}
+    // dtor. BigInt is a value type and not designed for derivation.
+    ~BigInt() = default;
 
     // copy ctor
     BigInt(const BigInt& other);
-    // move ctor
-    BigInt(BigInt&& other);
+    BigInt(const BigInt& other, const allocator_type& alloc);
+    // move ctor. moved-from object becomes zero.
+    BigInt(BigInt&& other) noexcept;
+    BigInt(BigInt&& other, const allocator_type& alloc);
+
+    // evaluate lazy expression. defined in pyc_big_integer_expr.hpp
+    template <typename E>
+    BigInt(const BigIntExpr<E>& expr, const allocator_type& alloc = {});
+
+protected:
+    // from sign and 64-bit magnitude. no need to normalize.
+    BigInt(bool bNeg, unsigned long long mag, const allocator_type& alloc);
+
+    // sign and magnitude of native integer. |LLONG_MIN| fits in unsigned long long.
+    template <std::integral T>
+    static constexpr bool NativeNeg(T v) {
+        if constexpr (std::is_signed_v<T>) return v < 0;
+        else return false;
+    }
+    template <std::integral T>
+    static constexpr unsigned long long NativeMag(T v) {
+        return NativeNeg(v) ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+    }
+    template <std::integral T>
+    static constexpr bool FitsLongLong(T v) {
+        return std::is_signed_v<T> || NativeMag(v) <= (unsigned long long)LLONG_MAX;
+    }
 
 public:
     // assign, move
     BigInt& operator=(const BigInt& other);
-    BigInt& operator=(BigInt&& other) noexcept;
+    BigInt& operator=(BigInt&& other);
+    template <typename E>
+    BigInt& operator=(const BigIntExpr<E>& expr);
 
 public:
     // representation
@@ -127,19 +274,23 @@ public:
     // returns actually allocated memory sizes
     int Capacity() const;
 
-    // number of net digits.
-    int Width() const { return Width(m_digits); }
-    static int Width(const DgtVec& digits);
+    // number of net decimal digits.
+    int Width() const;
+
+    // number of net limbs.
+    int Size() const { return Size(m_limbs); }
+    static int Size(const LimbBuf& limbs);
 
     // return cloned-copy
-    BigInt Clone() const { return *this; }
+    // copy on same resource. (copy constructor takes default resource, like std::pmr)
+    BigInt Clone() const { return BigInt(*this, get_allocator()); }
 
     BigInt&& Move() { return std::move(*this); }
 
 public:
     // unary arithmetic
-    BigInt operator+() const { return *this; };
-    BigInt operator-() const { return Clone().Inv_(); };
+    BigInt operator+() const { return Clone(); };
+    BigInt operator-() const { BigInt r = Clone(); r.Inv_(); return r; };
 
     BigInt Abs() const;
 
@@ -161,50 +312,402 @@ public:
     BigInt& operator+=(const BigInt& rhs) {
         return Add_(rhs);
     }
-    friend BigInt operator+(BigInt lhs, const BigInt& rhs) {
-        lhs += rhs; return lhs;
+    friend BigInt operator+(const BigInt& lhs, const BigInt& rhs) {
+        BigInt r = lhs.Clone(); r += rhs; return r;
+    }
+    friend BigInt operator+(BigInt&& lhs, const BigInt& rhs) {
+        lhs += rhs; return std::move(lhs);
     }
     BigInt& operator-=(const BigInt& rhs) {
         return Subtract_(rhs);
     }
-    friend BigInt operator-(BigInt lhs, const BigInt& rhs) {
-        lhs -= rhs; return lhs;
+    friend BigInt operator-(const BigInt& lhs, const BigInt& rhs) {
+        BigInt r = lhs.Clone(); r -= rhs; return r;
+    }
+    friend BigInt operator-(BigInt&& lhs, const BigInt& rhs) {
+        lhs -= rhs; return std::move(lhs);
+    }
+    BigInt& operator*=(const BigInt& rhs) {
+        return Mul_(rhs);
+    }
+    friend BigInt operator*(const BigInt& lhs, const BigInt& rhs) {
+        BigInt r = lhs.Clone(); r *= rhs; return r;
+    }
+    friend BigInt operator*(BigInt&& lhs, const BigInt& rhs) {
+        lhs *= rhs; return std::move(lhs);
+    }
+    // division and modulo follow python semantics. (floor division)
+    //   -7 / 2 == -4, -7 % 2 == 1, 7 % -2 == -1
+    BigInt& operator/=(const BigInt& rhs) {
+        return FloorDiv_(rhs);
+    }
+    friend BigInt operator/(const BigInt& lhs, const BigInt& rhs) {
+        BigInt r = lhs.Clone(); r /= rhs; return r;
+    }
+    friend BigInt operator/(BigInt&& lhs, const BigInt& rhs) {
+        lhs /= rhs; return std::move(lhs);
+    }
+    BigInt& operator%=(const BigInt& rhs) {
+        return Mod_(rhs);
+    }
+    // no rvalue overload, which would be ambiguous with native divisor below.
+    friend BigInt operator%(const BigInt& lhs, const BigInt& rhs) {
+        BigInt r = lhs.Clone(); r %= rhs; return r;
+    }
+
+    /*
+        native integer operand, of any integral type.
+        it is not converted to temporary BigInt. single limb kernels are used,
+        and nothing is allocated unless result grows out of inline storage.
+    */
+    template <std::integral T>
+    BigInt& operator+=(T rhs) {
+        return Add_(rhs);
+    }
+    template <std::integral T>
+    friend BigInt operator+(const BigInt& lhs, T rhs) {
+        BigInt r = lhs.Clone(); r += rhs; return r;
+    }
+    template <std::integral T>
+    friend BigInt operator+(BigInt&& lhs, T rhs) {
+        lhs += rhs; return std::move(lhs);
+    }
+    template <std::integral T>
+    friend BigInt operator+(T lhs, const BigInt& rhs) {
+        BigInt r = rhs.Clone(); r += lhs; return r;
+    }
+    template <std::integral T>
+    friend BigInt operator+(T lhs, BigInt&& rhs) {
+        rhs += lhs; return std::move(rhs);
+    }
+    template <std::integral T>
+    BigInt& operator-=(T rhs) {
+        return Subtract_(rhs);
+    }
+    template <std::integral T>
+    friend BigInt operator-(const BigInt& lhs, T rhs) {
+        BigInt r = lhs.Clone(); r -= rhs; return r;
+    }
+    template <std::integral T>
+    friend BigInt operator-(BigInt&& lhs, T rhs) {
+        lhs -= rhs; return std::move(lhs);
+    }
+    template <std::integral T>
+    friend BigInt operator-(T lhs, const BigInt& rhs) {
+        BigInt r = rhs.Clone(); r -= lhs; r.Inv_(); return r;
+    }
+    template <std::integral T>
+    friend BigInt operator-(T lhs, BigInt&& rhs) {
+        rhs -= lhs; rhs.Inv_(); return std::move(rhs);
+    }
+    template <std::integral T>
+    BigInt& operator*=(T rhs) {
+        return Mul_(rhs);
+    }
+    template <std::integral T>
+    friend BigInt operator*(const BigInt& lhs, T rhs) {
+        BigInt r = lhs.Clone(); r *= rhs; return r;
+    }
+    template <std::integral T>
+    friend BigInt operator*(BigInt&& lhs, T rhs) {
+        lhs *= rhs; return std::move(lhs);
+    }
+    template <std::integral T>
+    friend BigInt operator*(T lhs, const BigInt& rhs) {
+        BigInt r = rhs.Clone(); r *= lhs; return r;
+    }
+    template <std::integral T>
+    friend BigInt operator*(T lhs, BigInt&& rhs) {
+        rhs *= lhs; return std::move(rhs);
+    }
+    // divisor beyond long long (big unsigned one) falls back to BigInt division.
+    template <std::integral T>
+    BigInt& operator/=(T rhs) {
+        if (FitsLongLong(rhs)) DivMod_((long long)rhs);
+        else FloorDiv_(BigInt(rhs));
+        return *this;
+    }
+    template <std::integral T>
+    friend BigInt operator/(const BigInt& lhs, T rhs) {
+        BigInt r = lhs.Clone(); r /= rhs; return r;
+    }
+    template <std::integral T>
+    friend BigInt operator/(BigInt&& lhs, T rhs) {
+        lhs /= rhs; return std::move(lhs);
+    }
+    template <std::integral T>
+    BigInt& operator%=(T rhs) {
+        if (FitsLongLong(rhs)) return *this = Mod((long long)rhs);
+        return Mod_(BigInt(rhs));
+    }
+    // remainder always fits in divisor type. (long long, or unsigned long long)
+    template <std::integral T>
+    friend auto operator%(const BigInt& lhs, T rhs) {
+        using R = std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>;
+        if (FitsLongLong(rhs))
+            return R(lhs.Mod((long long)rhs));
+        uint32_t w[2] = {};
+        (lhs % BigInt(rhs)).GetWords(w, 2);
+        return R(w[0] | (unsigned long long)w[1] << 32);
+    }
+    // fused with lazy expression. defined in pyc_big_integer_expr.hpp
+    template <typename E>
+    BigInt& operator+=(const BigIntExpr<E>& rhs);
+    template <typename E>
+    BigInt& operator-=(const BigIntExpr<E>& rhs);
+protected:
+    BigInt& AddMag_(const LimbBuf& rhs, bool bInvSign=false, bool bNormalize=true);
+    BigInt& SubtractMag_(const LimbBuf& rhs,  bool bInvSign=false, bool bNormalize=true);
+    BigInt& SubtractFromMag_(const LimbBuf& rhs,  bool bInvSign=false, bool bNormalize=true);
+
+    // *this = sum of +-xs[i], in one pass. xs[i] may be *this.
+    BigInt& AssignSum_(const BigInt* const* xs, const bool* negs, int m);
+
+public:
+    /*
+        bitwise operators, with python semantics.
+        negative number behaves as infinite two's complement, ie, ~x == -x - 1.
+        shift by negative count throws std::domain_error.
+        right shift is floor division by power of 2. (-5 >> 1 == -3)
+    */
+    BigInt& operator&=(const BigInt& rhs) {
+        return BitOp_(rhs, '&');
+    }
+    friend BigInt operator&(const BigInt& lhs, const BigInt& rhs) {
+        BigInt r = lhs.Clone(); r &= rhs; return r;
+    }
+    friend BigInt operator&(BigInt&& lhs, const BigInt& rhs) {
+        lhs &= rhs; return std::move(lhs);
+    }
+    BigInt& operator|=(const BigInt& rhs) {
+        return BitOp_(rhs, '|');
+    }
+    friend BigInt operator|(const BigInt& lhs, const BigInt& rhs) {
+        BigInt r = lhs.Clone(); r |= rhs; return r;
+    }
+    friend BigInt operator|(BigInt&& lhs, const BigInt& rhs) {
+        lhs |= rhs; return std::move(lhs);
+    }
+    BigInt& operator^=(const BigInt& rhs) {
+        return BitOp_(rhs, '^');
+    }
+    friend BigInt operator^(const BigInt& lhs, const BigInt& rhs) {
+        BigInt r = lhs.Clone(); r ^= rhs; return r;
+    }
+    friend BigInt operator^(BigInt&& lhs, const BigInt& rhs) {
+        lhs ^= rhs; return std::move(lhs);
     }
+    BigInt operator~() const;
+
+    BigInt& operator<<=(long long cnt) {
+        return ShiftLeft_(cnt);
+    }
+    friend BigInt operator<<(const BigInt& lhs, long long cnt) {
+        BigInt r = lhs.Clone(); r <<= cnt; return r;
+    }
+    friend BigInt operator<<(BigInt&& lhs, long long cnt) {
+        lhs <<= cnt; return std::move(lhs);
+    }
+    BigInt& operator>>=(long long cnt) {
+        return ShiftRight_(cnt);
+    }
+    friend BigInt operator>>(const BigInt& lhs, long long cnt) {
+        BigInt r = lhs.Clone(); r >>= cnt; return r;
+    }
+    friend BigInt operator>>(BigInt&& lhs, long long cnt) {
+        lhs >>= cnt; return std::move(lhs);
+    }
+
+    // in-place shift. see operator<<, operator>>
+    BigInt& ShiftLeft_(long long cnt);
+    BigInt& ShiftRight_(long long cnt);
+
+    // python int.bit_length(), int.bit_count(). sign is ignored.
+    long long BitLength() const;
+    long long BitCount() const;
+    // bit k of infinite two's complement. same as (x >> k) & 1
+    bool TestBit(long long k) const;
+
+    // magnitude as base 2^32 words, least significant first. sign is ignored.
+    // w should have (BitLength() + 31) / 32 words. returns number of words written.
+    int GetWords(uint32_t* w, int n) const;
+    // in-place assign from magnitude words w[0..n) and sign.
+    BigInt& SetWords_(const uint32_t* w, int n, bool bNeg);
+
+public:
+    // serialization
+
+    // python int.to_bytes(). exactly out.size() bytes, two's complement if bSigned.
+    // throws std::overflow_error if it does not fit, or if negative and !bSigned.
+    void ToBytes(std::span<std::byte> out, std::endian order = std::endian::big, bool bSigned = false) const;
+    std::vector<std::byte> ToBytes(size_t length, std::endian order = std::endian::big, bool bSigned = false) const;
+    // python int.from_bytes().
+    static BigInt FromBytes(std::span<const std::byte> in, std::endian order = std::endian::big, bool bSigned = false);
+
+    /*
+        compact encoding, for storage and transfer.
+            varint (magnitude byte length << 1 | sign), magnitude bytes (little endian)
+        varint is LEB128 in shortest form: 7 bits per byte, low group first, high bit set if more follow.
+        magnitude has no leading zero byte, and zero is a single byte 0x00.
+        so encoding of a value is unique, and bytes are copied as is from limbs.
+    */
+    size_t EncodedSize() const;
+    // returns bytes written. throws std::length_error if out is too small.
+    size_t Encode(std::span<std::byte> out) const;
+    // one value from front of in, and bytes consumed into *used.
+    // throws std::invalid_argument if it is truncated or not canonical.
+    static BigInt Decode(std::span<const std::byte> in, size_t* used = nullptr);
+
+    // bulk version: varint count, then each value encoded as above.
+    static size_t EncodedSize(std::span<const BigInt> v);
+    static size_t EncodeAll(std::span<const BigInt> v, std::span<std::byte> out);
+    // appends decoded values to out. returns bytes consumed.
+    static size_t DecodeAll(std::span<const std::byte> in, std::vector<BigInt>& out);
 protected:
-    BigInt& AddMag_(const DgtVec& rhs, bool bInvSign=false, bool bNormalize=true);
-    BigInt& SubtractMag_(const DgtVec& rhs,  bool bInvSign=false, bool bNormalize=true);
+    // magnitude as little endian bytes into p[0..len). len should not be less than its byte length.
+    void GetMagBytes(std::byte* p, size_t len) const;
+    // in-place assign from little endian magnitude bytes p[0..len) and sign.
+    BigInt& SetMagBytes_(const std::byte* p, size_t len, bool bNeg);
+protected:
+    // op is one of '&', '|', '^'.
+    BigInt& BitOp_(const BigInt& rhs, char op);
 
 public:
     // in-place add/subtract
     BigInt& Add_(const BigInt& rhs);
     BigInt& Subtract_(const BigInt& rhs);
+    // in-place multiply. x*x is detected and calculated by squaring.
+    BigInt& Mul_(const BigInt& rhs);
+
+    // in-place add/subtract/multiply by native integer.
+    template <std::integral T>
+    BigInt& Add_(T rhs) { return AddNative_(NativeMag(rhs), NativeNeg(rhs)); }
+    template <std::integral T>
+    BigInt& Subtract_(T rhs) { return AddNative_(NativeMag(rhs), !NativeNeg(rhs)); }
+    template <std::integral T>
+    BigInt& Mul_(T rhs) { return MulNative_(NativeMag(rhs), NativeNeg(rhs)); }
+protected:
+    // add (or multiply) native magnitude with sign. limbs of it are on stack.
+    BigInt& AddNative_(unsigned long long mag, bool bNeg);
+    BigInt& MulNative_(unsigned long long mag, bool bNeg);
+    // add (or multiply) magnitude b[0..bn) with sign. b is read only, and may live outside of BigInt.
+    // (limbs of native integer on stack, or BigIntView) bn is 0 for zero.
+    BigInt& AddLimbs_(const Limb* b, int bn, bool bNeg);
+    BigInt& MulLimbs_(const Limb* b, int bn, bool bNeg);
+
+public:
+
+    // in-place floor division / modulo.
+    // all division functions throw std::domain_error if divisor is zero.
+    BigInt& FloorDiv_(const BigInt& rhs);
+    BigInt& Mod_(const BigInt& rhs);
+    // in-place floor division by native integer. returns the remainder.
+    long long DivMod_(long long rhs);
+    // remainder by native integer.
+    long long Mod(long long rhs) const;
+
+    // quotient and remainder in single pass. q or r can be nullptr if not needed.
+    // q and r may be same object as a or b.
+    static void DivMod(const BigInt& a, const BigInt& b, BigInt* q, BigInt* r);
+
+    // base ** exp. exp should not be negative. see also ModContext::Pow()
+    static BigInt Pow(const BigInt& base, const BigInt& exp);
+
+    // greatest common divisor, always non-negative. gcd(0, 0) == 0.
+    static BigInt Gcd(const BigInt& a, const BigInt& b);
+    // x such that a * x == 1 (mod m), with sign of m like % operator.
+    // throws std::domain_error if m is zero or a is not invertible.
+    static BigInt ModInverse(const BigInt& a, const BigInt& m);
+
+    // floor(sqrt(a)), python math.isqrt(). throws std::domain_error if a is negative.
+    // remainder a - s * s is given to rem, if not nullptr. (zero for perfect square)
+    static BigInt Sqrt(const BigInt& a, BigInt* rem = nullptr);
+    // floor(a ** (1/n)), n >= 1. throws std::domain_error if a is negative or n < 1.
+    static BigInt Root(const BigInt& a, int n);
+
+    // python math.factorial(), math.comb(), math.perm().
+    // throws std::domain_error if n or k is negative. comb and perm are zero if k > n.
+    static BigInt Factorial(const BigInt& n);
+    static BigInt Comb(const BigInt& n, const BigInt& k);
+    static BigInt Perm(const BigInt& n, const BigInt& k);
 
 public:
     // comparison operator
     bool Less(const BigInt& rhs) const;
     bool Equal(const BigInt& rhs) const;
+    // three-way comparison, in one pass. returns -1, 0, 1.
+    int Compare(const BigInt& rhs) const;
+    // three-way comparison with native integer. returns -1, 0, 1.
+    template <std::integral T>
+    int Compare(T rhs) const { return CompareNative(NativeMag(rhs), NativeNeg(rhs)); }
     // other binary comparison operators are at outside of this class.
 
+    // hash of value, for std::hash<BigInt>. same as std::hash<long long> in range of long long.
+    size_t Hash() const noexcept;
+protected:
+    // hash of magnitude a[0..n) with sign. n is 0 for zero. (shared with BigIntView)
+    static size_t HashLimbs(const Limb* a, int n, bool bNeg) noexcept;
+public:
+
 protected:
-    // compare magnitude only
-    bool LessMag(const DgtVec& rhs) const;
-    bool EqualMag(const DgtVec& rhs) const;
+    // compare magnitude only. both should be normalized,
+    // so that limb count of LimbBuf is used as is, without scan for high zero limbs.
+    int CompareMag(const LimbBuf& rhs) const;
+    bool LessMag(const LimbBuf& rhs) const { return CompareMag(rhs) < 0; }
+    bool EqualMag(const LimbBuf& rhs) const;
+    int CompareNative(unsigned long long mag, bool bNeg) const;
+    // a[0..n) with sign against native magnitude with sign. n is 0 for zero. (shared with BigIntView)
+    static int CompareLimbsNative(const Limb* a, int n, bool aNeg, unsigned long long mag, bool bNeg);
 
 public:
     // conversion
-#if 0
-    template <typename T>
+    // whether value is in range of native integer type T.
+    template <std::integral T>
     bool CanFit() const {
-        static_assert(std::numeric_limits<T>::is_integer, "T must be an integer type");
+        unsigned long long mag;
+        if (!GetMag64(mag))
+            return false;
+        using U = std::make_unsigned_t<T>;
+        if (!m_sign)
+            return mag <= (unsigned long long)std::numeric_limits<T>::max();
+        // |min| of signed T is max + 1.
+        return std::is_signed_v<T> && mag <= (unsigned long long)(U)std::numeric_limits<T>::max() + 1;
+    }
+    // value as T. throws std::overflow_error if it does not fit.
+    template <std::integral T>
+    T To() const {
+        T v;
+        if (!TryTo(v))
+            throw std::overflow_error("BigInt too large to convert to native integer");
+        return v;
+    }
+    // value into v, without exception. returns false (v unchanged) if it does not fit.
+    template <std::integral T>
+    bool TryTo(T& v) const {
+        if (!CanFit<T>())
+            return false;
+        unsigned long long mag = 0;
+        GetMag64(mag);
+        v = T(m_sign ? 0ULL - mag : mag);
+        return true;
+    }
+    int64_t ToInt64() const { return To<int64_t>(); }
+    uint64_t ToUInt64() const { return To<uint64_t>(); }
 
-        if (IsZero()) return true;
+    // nearest double, ties to even. python float(int).
+    // only top limbs are read, unless it is a tie.
+    // throws std::overflow_error if it is out of range of double.
+    double ToDouble() const;
 
-        const auto minVal = std::numeric_limits<T>::min();
-        const auto maxVal = std::numeric_limits<T>::max();
+    // a / b as double, correctly rounded. python true division.
+    // throws std::domain_error if b is zero, std::overflow_error if result is out of range.
+    static double TrueDiv(const BigInt& a, const BigInt& b);
 
-        // TODO..
-    }
-#endif
+protected:
+    // value of small number. caller should guarantee that it fits.
+    long long ToLongLong() const;
+    // magnitude into mag, if it fits in 64 bits.
+    bool GetMag64(unsigned long long& mag) const;
 
 protected:
     // strip unnecessary digits.
@@ -219,38 +722,290 @@ public:
     // other convenient tools
 
     BigInt Add(BigInt& rhs) {
-        return BigInt(*this).Add_(rhs);
+        BigInt r = Clone(); r.Add_(rhs); return r;
     }
 
 
 }; // BigInt
 
 
-// comparison operator
-inline bool operator< (const BigInt& lhs, const BigInt& rhs) {
-    return lhs.Less(rhs);
+// comparison operator. relational ones and != are synthesized. (c++20)
+inline bool operator==(const BigInt& lhs, const BigInt& rhs) {
+    return lhs.Equal(rhs);
 }
-inline bool operator> (const BigInt& lhs, const BigInt& rhs) {
-    return rhs < lhs;
+inline std::strong_ordering operator<=>(const BigInt& lhs, const BigInt& rhs) {
+    return lhs.Compare(rhs) <=> 0;
 }
-inline bool operator<=(const BigInt& lhs, const BigInt& rhs) {
-    return !(lhs > rhs);
+// with native integer. reversed and other relational ones are synthesized. (c++20)
+template <std::integral T>
+inline bool operator==(const BigInt& lhs, T rhs) {
+    return lhs.Compare(rhs) == 0;
 }
-inline bool operator>=(const BigInt& lhs, const BigInt& rhs) {
-    return !(lhs < rhs);
+template <std::integral T>
+inline std::strong_ordering operator<=>(const BigInt& lhs, T rhs) {
+    return lhs.Compare(rhs) <=> 0;
 }
 
-inline bool operator==(const BigInt& lhs, const BigInt& rhs) {
-    return lhs.Equal(rhs);
+
+// python divmod(). (a // b, a % b)
+inline std::pair<BigInt, BigInt> divmod(const BigInt& a, const BigInt& b) {
+    std::pair<BigInt, BigInt> res;
+    BigInt::DivMod(a, b, &res.first, &res.second);
+    return res;
+}
+inline std::pair<BigInt, long long> divmod(BigInt a, long long b) {
+    long long r = a.DivMod_(b);
+    return { std::move(a), r };
+}
+
+
+constexpr const char* BigInt::FormatSpec::Parse(std::string_view s, FormatSpec& spec)
+{
+    auto isAlign = [](char c) { return c == '<' || c == '>' || c == '=' || c == '^'; };
+    auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+    spec = FormatSpec();
+    size_t i = 0;
+    bool bFill = false;
+    if (s.size() >= 2 && isAlign(s[1])) {
+        spec.fill = s[0];
+        spec.align = s[1];
+        bFill = true;
+        i = 2;
+    }
+    else if (!s.empty() && isAlign(s[0]))
+        spec.align = s[i++];
+    if (i < s.size() && (s[i] == '+' || s[i] == '-' || s[i] == ' '))
+        spec.sign = s[i++];
+    if (i < s.size() && s[i] == 'z')
+        return "negative zero coercion (z) not allowed in integer format";
+    if (i < s.size() && s[i] == '#') {
+        spec.alt = true;
+        i++;
+    }
+    if (i < s.size() && s[i] == '0') {
+        // zero padding after sign. explicit fill or align is kept.
+        if (!bFill)
+            spec.fill = '0';
+        if (!spec.align)
+            spec.align = '=';
+        i++;
+    }
+    for (; i < s.size() && isDigit(s[i]); i++) {
+        if (spec.width > (INT_MAX - 9) / 10)
+            return "too big width in format";
+        spec.width = spec.width * 10 + (s[i] - '0');
+    }
+    if (i < s.size() && (s[i] == ',' || s[i] == '_'))
+        spec.group = s[i++];
+    if (i < s.size() && s[i] == '.')
+        return "precision not allowed in integer format";
+    if (i < s.size()) {
+        char t = s[i++];
+        if (t != 'd' && t != 'n' && t != 'x' && t != 'X' && t != 'o' && t != 'b')
+            return "unknown type in integer format";
+        spec.type = t;
+    }
+    if (i < s.size())
+        return "invalid integer format";
+    if (spec.group == ',' && spec.type != 'd')
+        return "cannot specify ',' with non-decimal type";
+    if (spec.group && spec.type == 'n')
+        return "cannot specify grouping with 'n'";
+    return nullptr;
+}
+
+/*
+    decimal by default. hex/oct by basefield, with showbase, uppercase and showpos.
+    width, fill and adjustfield (left, right, internal) are applied, and width is reset.
+    prefix of showbase is python style. ("0x", "0o")
+*/
+std::ostream& operator<<(std::ostream& os, const BigInt& a);
+
+
+/*
+    incremental parser of decimal literal, for text which comes in pieces.
+
+        BigIntParser p;
+        while (more data)
+            p.Feed(chunk);      // std::string_view
+        BigInt x = p.Finish();
+
+    same rules as BigInt(string): optional '+' or '-', and it stops at first non-digit.
+    python '_' separator between digits is accepted. ("1_000_000")
+    '_' not followed by a digit is not a separator, so it stops there.
+
+    digits are buffered up to PYCFG_BIGINT_PARSE_BLOCK, and each full block is
+    converted as it arrives. blocks of same size are merged like a binary counter,
+        hi * 10^digits(lo) + lo
+    so multiplications are balanced, and text is never kept as a whole.
+*/
+class BigIntParser
+{
+public:
+    explicit BigIntParser(const BigInt::allocator_type& alloc = {});
+
+    // feeds next piece. returns number of chars consumed, which is less than
+    // chunk size only if it stopped at a non-digit. nothing is consumed after stop.
+    size_t Feed(std::string_view chunk);
+    // true if it stopped at a non-digit.
+    bool Stopped() const { return m_state == kStopped; }
+    // number of digits so far.
+    long long Digits() const { return m_digits; }
+
+    // value of digits so far. zero if there is no digit. parser is reset for next one.
+    BigInt Finish();
+
+protected:
+    // block value and its number of digits
+    struct Block {
+        BigInt value;
+        long long digits;
+    };
+    void PushBlock(BigInt value, long long digits);
+    // 10^(kBlock * 2^k), by squaring.
+    const BigInt& BlockPow10(int k);
+
+    static constexpr int kBlock = PYCFG_BIGINT_PARSE_BLOCK;
+    enum State { kStart, kSign, kDigit, kUnderscore, kStopped };
+
+    BigInt::allocator_type m_alloc;
+    State m_state = kStart;
+    bool m_neg = false;
+    long long m_digits = 0;
+    std::string m_buf;  // digits of current block
+    std::vector<Block> m_stack;  // digits are decreasing powers of 2 multiple of kBlock
+    std::vector<BigInt> m_pow;
+};
+
+/*
+    reads decimal literal as BigInt(string), with '_' separator.
+    leading white spaces are skipped if skipws is set. digits are read from
+    stream buffer one by one, and terminating non-digit is not extracted.
+    failbit is set (and a is zero) if there is no digit.
+*/
+std::istream& operator>>(std::istream& is, BigInt& a);
+
+
+/*
+    precomputed modulus, for repeated modular exponentiation with same modulus.
+    see mpn::ModCtx. (montgomery for odd modulus, barrett otherwise)
+    it is read-only after construction, and can be shared between threads.
+*/
+class ModContext
+{
+public:
+    // throws std::domain_error if mod is zero.
+    explicit ModContext(const BigInt& mod);
+
+    const BigInt& Modulus() const { return m_mod; }
+
+    /*
+        python pow(base, exp, mod). result takes sign of mod, like % operator.
+        negative exp is allowed if base is invertible. (python 3.8)
+        with bConstTime, timing depends only on sizes of exp and mod.
+        (base should be already in range [0, |mod|) for full constant-time)
+    */
+    BigInt Pow(const BigInt& base, const BigInt& exp, bool bConstTime = false) const;
+
+protected:
+    BigInt m_mod;
+    BigInt m_abs;   // |mod|
+    mpn::ModCtx m_ctx;
+};
+
+
+// python pow(). exp should not be negative, unless mod is given.
+inline BigInt pow(const BigInt& base, const BigInt& exp) {
+    return BigInt::Pow(base, exp);
+}
+inline BigInt pow(const BigInt& base, const BigInt& exp, const BigInt& mod) {
+    return ModContext(mod).Pow(base, exp);
+}
+
+// python math.gcd(), math.lcm(). results are non-negative.
+inline BigInt gcd(const BigInt& a, const BigInt& b) {
+    return BigInt::Gcd(a, b);
+}
+inline BigInt lcm(const BigInt& a, const BigInt& b) {
+    if (a.IsZero() || b.IsZero())
+        return BigInt(0, a.get_allocator());
+    BigInt r = a / BigInt::Gcd(a, b) * b;
+    return r.IsNegative() ? -r : r;
+}
+// python pow(a, -1, m)
+inline BigInt mod_inverse(const BigInt& a, const BigInt& m) {
+    return BigInt::ModInverse(a, m);
+}
+// python math.isqrt(), and its n-th root version.
+inline BigInt isqrt(const BigInt& a) {
+    return BigInt::Sqrt(a);
+}
+inline BigInt iroot(const BigInt& a, int n) {
+    return BigInt::Root(a, n);
 }
-inline bool operator!=(const BigInt& lhs, const BigInt& rhs) {
-    return !(lhs == rhs);
+// python true division. a / b of BigInt is floor division.
+inline double truediv(const BigInt& a, const BigInt& b) {
+    return BigInt::TrueDiv(a, b);
+}
+// python int.to_bytes(), int.from_bytes().
+inline std::vector<std::byte> to_bytes(const BigInt& a, size_t length, std::endian order = std::endian::big, bool bSigned = false) {
+    return a.ToBytes(length, order, bSigned);
+}
+inline BigInt from_bytes(std::span<const std::byte> in, std::endian order = std::endian::big, bool bSigned = false) {
+    return BigInt::FromBytes(in, order, bSigned);
+}
+// python math.factorial(), math.comb(), math.perm().
+inline BigInt factorial(const BigInt& n) {
+    return BigInt::Factorial(n);
+}
+inline BigInt comb(const BigInt& n, const BigInt& k) {
+    return BigInt::Comb(n, k);
+}
+inline BigInt perm(const BigInt& n, const BigInt& k) {
+    return BigInt::Perm(n, k);
+}
+inline BigInt perm(const BigInt& n) {
+    return BigInt::Factorial(n);
 }
 
 
 //============================================================================
 }; // namespace com::cafrii::pyc
 
+// BigInt as key of unordered containers.
+template <>
+struct std::hash<com::cafrii::pyc::BigInt> {
+    size_t operator()(const com::cafrii::pyc::BigInt& a) const noexcept { return a.Hash(); }
+};
+
+#if defined(__cpp_lib_format)
+// std::format("{:+,}", a). spec is same as BigInt::Format().
+template <>
+struct std::formatter<com::cafrii::pyc::BigInt, char> {
+    com::cafrii::pyc::BigInt::FormatSpec spec;
+
+    constexpr auto parse(std::format_parse_context& ctx) {
+        auto it = ctx.begin();
+        while (it != ctx.end() && *it != '}')
+            ++it;
+        if (const char* err = spec.Parse(std::string_view(ctx.begin(), it), spec))
+            throw std::format_error(err);
+        return it;
+    }
+    // pieces go to output iterator directly. digits are made in buffer of this thread.
+    template <typename FormatContext>
+    auto format(const com::cafrii::pyc::BigInt& a, FormatContext& ctx) const {
+        com::cafrii::pyc::BigInt::FormatBuffer work(a.FormattedSize(spec));
+        auto parts = a.Layout(work.data(), spec);
+        auto out = std::fill_n(ctx.out(), parts.left, spec.fill);
+        out = std::copy(parts.prefix, parts.prefix + parts.prefixLen, out);
+        out = std::fill_n(out, parts.mid, spec.fill);
+        out = std::copy(parts.body, parts.body + parts.bodyLen, out);
+        return std::fill_n(out, parts.right, spec.fill);
+    }
+};
+#endif
+
 //============================================================================
 
 #ifdef __PYC_LIB_IMPLEMENTATION
@@ -259,6 +1014,45 @@ namespace com::cafrii::pyc {
 //============================================================================
 
 
+namespace {
+
+// magnitude of limbs[0..n), which should fit in 64 bits.
+unsigned long long LimbsToU64(const mpn::LimbBuf& limbs, int n)
+{
+    unsigned long long mag = 0;
+    for (int k=n-1; k>=0; k--)
+        mag = mag * mpn::kBase + limbs[k];
+    return mag;
+}
+
+// limbs of 64-bit magnitude at most.
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+constexpr int kU64Limbs = 20;
+#else
+constexpr int kU64Limbs = 2;
+#endif
+
+// w[0..n) = mag, returns n. zero gives no limb.
+int U64ToLimbArray(mpn::Limb* w, unsigned long long mag)
+{
+    int n = 0;
+    for (; mag; mag /= mpn::kBase)
+        w[n++] = mpn::Limb(mag % mpn::kBase);
+    return n;
+}
+
+void U64ToLimbs(mpn::LimbBuf& limbs, unsigned long long mag)
+{
+    limbs.resize(0);
+    do {
+        limbs.push_back(mpn::Limb(mag % mpn::kBase));
+        mag /= mpn::kBase;
+    } while (mag);
+}
+
+} // namespace
+
+
 //-------------------------------------
 // ctor/dtor
 
@@ -266,40 +1060,52 @@ namespace com::cafrii::pyc {
     default ctor
 */
 BigInt::BigInt():
-    m_sign(false), m_digits({0})
+    m_limbs({0}), m_sign(false)
+{
+}
+BigInt::BigInt(const allocator_type& alloc):
+    m_limbs(alloc.resource()), m_sign(false)
 {
+    m_limbs.assign(1, 0);
 }
 
 /*
     copy/move ctor
 */
 BigInt::BigInt(const BigInt& other):
-    m_sign(other.m_sign), m_digits(other.m_digits)
+    m_limbs(other.m_limbs), m_sign(other.m_sign)
+{
+}
+BigInt::BigInt(const BigInt& other, const allocator_type& alloc):
+    m_limbs(alloc.resource()), m_sign(other.m_sign)
+{
+    m_limbs = other.m_limbs;
+}
+BigInt::BigInt(BigInt&& other) noexcept:
+    m_limbs(std::move(other.m_limbs)), m_sign(other.m_sign)
 {
+    other.m_sign = false;
+    other.m_limbs.assign(1, 0);
 }
-BigInt::BigInt(BigInt&& other):
-    m_sign(other.m_sign), m_digits(std::move(other.m_digits))
+// storage is moved only if it is on same resource. otherwise copied.
+BigInt::BigInt(BigInt&& other, const allocator_type& alloc):
+    m_limbs(alloc.resource())
 {
+    *this = std::move(other);
 }
 
 
 /*
     number to big integer
 
-    UINT64_MAX is 18446744073709551615.
-    maximum 20 digits at most.
+    magnitude of LLONG_MIN does not fit in long long,
+    so it is calculated in unsigned type.
 */
-BigInt::BigInt(long long num)
+BigInt::BigInt(bool bNeg, unsigned long long mag, const allocator_type& alloc):
+    m_limbs(alloc.resource())
 {
-    if (num < 0) {
-        m_sign = true;
-        num = -num;
-    }
-    m_digits.reserve(20); // note that it does not increase m_digits vector memory!
-    do {
-        m_digits.push_back(num % 10);
-        num /= 10;
-    } while (num);
+    m_sign = bNeg && mag != 0;
+    U64ToLimbs(m_limbs, mag);
     // no need to normalize.
 }
 
@@ -307,9 +1113,9 @@ BigInt::BigInt(long long num)
     string to big integer
     accept string only until it is valid digit number.
 
-    initial + sign is allowed.
+    initial + sign is allowed. python '_' separator between digits is allowed.
 */
-BigInt::BigInt(const string& sn): BigInt()
+BigInt::BigInt(const string& sn, const allocator_type& alloc): BigInt(alloc)
 {
     bool bNegative = false;
     auto beg = sn.begin();
@@ -327,12 +1133,27 @@ BigInt::BigInt(const string& sn): BigInt()
             [](char c){ return !InRange<char>(c, '0', '9'); });
     if (it == beg)
         return; // there is no valid digit in provided string.
-    auto len = (it - beg);
-    Extend_(len);
-    Digit* p = &(*this)[len-1];
-    for (auto it2=beg; it2!=it; it2++) {
-        *p-- = (*it2) - '0';
+    if (it + 1 < sn.end() && *it == '_' && InRange<char>(it[1], '0', '9')) {
+        // python digit separator. rare, so it is left to streaming parser.
+        BigIntParser p(alloc);
+        p.Feed(sn);
+        *this = p.Finish();
+        return;
     }
+    int len = (int)(it - beg);
+
+    // divide-and-conquer above PYCFG_BIGINT_STR_DC_CUTOFF. see mpn::SetStr()
+    // small number is parsed in stack, to keep it inline.
+    int cap = mpn::LimbsForDigits(len);
+    Limb local[8] = {};
+    LimbVec heap;
+    Limb* r = local;
+    if (cap > 8) {
+        heap.resize(cap);
+        r = heap.data();
+    }
+    int n = mpn::SetStr(r, &*beg, len);
+    m_limbs.assign(r, r + std::max(n, 1));
     m_sign = bNegative;
     Normalize_();
 }
@@ -347,8 +1168,8 @@ BigInt::BigInt(const string& sn): BigInt()
 bool BigInt::IsZero() const
 {
     return
-        m_digits.empty() || // <- actually this is illegal state.
-        (m_digits.size() == 1 && m_digits[0] == 0) ||
+        m_limbs.empty() || // <- actually this is illegal state.
+        (m_limbs.size() == 1 && m_limbs[0] == 0) ||
         false;
 }
 
@@ -359,31 +1180,47 @@ bool BigInt::IsZero() const
 */
 int BigInt::Capacity() const
 {
-    return (int)m_digits.size();
+    return m_limbs.capacity();
+}
+
+/*
+    returns number of decimal digits, except sign.
+    ex: Width(123) == 3, Width(-10) == 2
+    purely zero "0" will count as 1. ie, Width() always > 0.
+
+    with binary limbs, it is not a trivial operation.
+    multi-limb number is converted to decimal string to count digits.
+*/
+int BigInt::Width() const
+{
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    return Size();
+#else
+    if (Size() == 1) {
+        int w = 1;
+        for (Limb v = m_limbs[0]; v >= 10; v /= 10) w++;
+        return w;
+    }
+    return (int)ToStr().size() - (m_sign ? 1 : 0);
+#endif
 }
 
 /*
     returns actually used memory sizes (unit: number of elements)
     this count will skip trailing zeros in memory order.
-    ex: Width("00123") == 3
-        Width("12340") == 5
-        Width("000") == 1
-    purely zero "0" will count as 1. ie, Width() always > 0.
+    ex: Size({3,2,1,0,0}) == 3
+        Size({0,0,0}) == 1
+    purely zero will count as 1. ie, Size() always > 0.
 
     부호는 제외하고, 절대값 숫자의 표현 크기를 계산한다.
-    뒤집혀 저장된 상태에서, 끝자리 0을 제외한 실제로 0아닌 숫자의 길이를 리턴한다.
-    Width() 리턴값은 항상 >= 1 이다.
+    뒤집혀 저장된 상태에서, 끝자리 0을 제외한 실제로 0아닌 limb 의 갯수를 리턴한다.
+    Size() 리턴값은 항상 >= 1 이다.
 */
 // static
-int BigInt::Width(const DgtVec& digits)
+int BigInt::Size(const LimbBuf& limbs)
 {
-    int k = digits.size()-1;
-    for (; k>=0 && !digits[k]; k--) (void)0;
-    // k is the last index which is trailing non-zero.
-    // if there are no non-zero digit, it will be -1.
-    // k는 0아닌 숫자를 포함하는 마지막 요소 인덱스. 0아닌 숫자가 없으면 -1.
-    if (k < 0) k = 0;
-    return k+1; // convert index to length
+    int n = mpn::NormSize(limbs.data(), (int)limbs.size());
+    return n > 0 ? n : 1;
 }
 
 
@@ -405,7 +1242,7 @@ BigInt& BigInt::operator=(const BigInt& other)
         return *this;
 
     // resource reuse will be considered in vector class level.
-    m_digits = other.m_digits;
+    m_limbs = other.m_limbs;
     m_sign = other.m_sign;
     return *this;
 }
@@ -414,15 +1251,19 @@ BigInt& BigInt::operator=(const BigInt& other)
     표준 move assign은 이동된 객체를 유효한 상태(즉, 클래스 불변성이 그대로 유지된 상태)로 남겨두고,
     아무것도 하지 않거나, 최소한 자체 할당 시 객체를 유효한 상태로 남겨두고,
     비-const를 참조하여 lh를 반환하며, noexcept가 될 것으로 예상됩니다:
+
+    다만 memory resource 가 서로 다르면 복사가 필요하므로 noexcept 가 아니다.
 */
-BigInt& BigInt::operator=(BigInt&& other) noexcept
+BigInt& BigInt::operator=(BigInt&& other)
 {
     // Guard self assignment
     if (this == &other)
         return *this; // delete[]/size=0 would also be ok
 
-    m_digits = std::move(other.m_digits);
+    m_limbs = std::move(other.m_limbs);
     m_sign = other.m_sign;
+    other.m_sign = false;
+    other.m_limbs.assign(1, 0);
     return *this;
 }
 
@@ -436,7 +1277,9 @@ BigInt& BigInt::operator=(BigInt&& other) noexcept
 */
 BigInt BigInt::Abs() const
 {
-    return Clone().Sign_(false);
+    BigInt r = Clone();
+    r.Sign_(false);
+    return r;
 }
 
 /*
@@ -465,26 +1308,26 @@ BigInt& BigInt::Sign_(bool bSign)
 // prefix increment
 BigInt& BigInt::operator++()
 {
-    Add_(BigInt("1"));
+    AddNative_(1, false);
     return *this; // return new value by reference
 }
 // postfix increment
 BigInt BigInt::operator++(int)
 {
-    BigInt old = *this; // copy old value
+    BigInt old = Clone(); // copy old value
     operator++();  // prefix increment
     return old;    // return old value
 }
 // prefix decrement
 BigInt& BigInt::operator--()
 {
-    Subtract_(BigInt("1"));
+    AddNative_(1, true);
     return *this;
 }
 // postfix decrement
 BigInt BigInt::operator--(int)
 {
-    BigInt old = *this; // copy old value
+    BigInt old = Clone(); // copy old value
     operator--();  // prefix decrement
     return old;    // return old value
 }
@@ -503,27 +1346,22 @@ BigInt BigInt::operator--(int)
 
     result is returned after normalization (can be optionally disabled).
 */
-BigInt& BigInt::AddMag_(const DgtVec& digits, bool bInvSign, bool bNormalize)
-{
-    // assume digits digit vector is normalized.
-    int len2 = (int)digits.size();
-    int len = std::max((int)m_digits.size(), len2);
-    this->Extend_(len + 1);
-
-    int carry = 0;
-    for (int k=0; k<len; k++) {
-        int operand = k < len2 ? digits[k] : 0;
-        m_digits[k] += (operand + carry);
-        if (m_digits[k] < 10)
-            carry = 0;
-        else {
-            m_digits[k] = m_digits[k] % 10;
-            carry = 1;
-        }
-    }
+BigInt& BigInt::AddMag_(const LimbBuf& limbs, bool bInvSign, bool bNormalize)
+{
+    // assume limbs vector is normalized.
+    int len1 = Size();
+    int len2 = Size(limbs);
+    int len = std::max(len1, len2);
+    this->Extend_(len);
+
+    // zero-extended limbs of this are already in place. add them up to len2.
+    Limb carry = mpn::Add(&m_limbs[0], &m_limbs[0], len, limbs.data(), len2);
+    // grow only if needed, to keep small number inline.
     if (carry) {
-        m_digits[len] = 1;
+        m_limbs.resize(len);
+        m_limbs.push_back(carry);
     }
+
     if (bInvSign) Inv_();
     if (bNormalize) Normalize_();
     return *this;
@@ -535,59 +1373,17 @@ BigInt& BigInt::AddMag_(const DgtVec& digits, bool bInvSign, bool bNormalize)
 */
 BigInt& BigInt::Add_(const BigInt& rhs)
 {
-#if 0
-    if (!m_sign && rhs.m_sign) { // positive + negative
-        // (NOT OPTIMUM!)
-        //    return Subtract_(-rhs);
-        //
-        // if use just use Subtract_(), rhs is cloned twice!!
-        //   ex: 3 + (-5) = 3 - cloned(5) = clone(clone(5)) - 3
-        // so, SubtractMag_ is preferred after checking.
-        //
-        if (LessMag(rhs.m_digits)) {
-            // ex: 3 + (-5) = cloned(-5) - 3 = -(cloned(5) - 3)
-            auto res = rhs; // copy
-            *this = res.SubtractMag_(m_digits, false).Move();
-            return *this;
-        }
-        else {
-            // ex: 5 + (-3) = 5 - 3
-            return SubtractMag_(rhs.m_digits, false);
-        }
-    }
-    if (m_sign && !rhs.m_sign) { // negative + positive
-        // return Inv_().Subtract_(rhs).Inv_();
-        if (LessMag(rhs.m_digits)) {
-            // ex: -3 + 5 => -(cloned(5) - 3)
-            auto res = rhs; // copy
-            *this = res.SubtractMag_(m_digits, false).Move();
-            return *this;
-        }
-        else {
-            // ex: -5 + 3 => -(5 - 3)
-            return SubtractMag_(rhs.m_digits, false);
-        }
-    }
-    // two signs are equal.
-    return AddMag_(rhs.m_digits, false); // keeping sign flag
-
-#else
     if (m_sign == rhs.m_sign) { // same sign
-        return AddMag_(rhs.m_digits);
+        return AddMag_(rhs.m_limbs);
     }
     // different sign
-    if (LessMag(rhs.m_digits)) { // rhs has bigger magnitude
-        // -11 + 222
-        auto bigger = rhs; // copy
-        printf("bigger %s\n", bigger.ToStr().c_str());
-        *this = bigger.SubtractMag_(m_digits).Move();
-        return *this;
+    if (LessMag(rhs.m_limbs)) { // rhs has bigger magnitude
+        // -11 + 222 => +(222 - 11)
+        return SubtractFromMag_(rhs.m_limbs, true);
     }
     else {
-        return SubtractMag_(rhs.m_digits, false);
+        return SubtractMag_(rhs.m_limbs, false);
     }
-
-#endif
 } // Add_
 
 /*
@@ -595,134 +1391,1698 @@ BigInt& BigInt::Add_(const BigInt& rhs)
     warning:
         it should be called only when
         this magnitude is greater than or equal to others.
+        otherwise throws std::logic_error before this is modified.
 */
-BigInt& BigInt::SubtractMag_(const DgtVec& digits, bool bInvSign, bool bNormalize)
+BigInt& BigInt::SubtractMag_(const LimbBuf& limbs, bool bInvSign, bool bNormalize)
 {
-    if (LessMag(digits)) {
-        throw("underflow!");
-        return *this;
-    }
-    int len2 = Width(digits);
-    int len = std::max(Width(), len2);
-    this->Extend_(len + 1);
-
-    int val, carry = 0;
-    for (int k=0; k<len; k++) {
-        int operand = k < len2 ? digits[k] : 0;
-        val = m_digits[k] - operand + carry;
-        if (val >= 0) {
-            m_digits[k] = val;
-            carry = 0;
-        }
-        else {
-            m_digits[k] = val + 10;
-            carry = -1;
-        }
-    }
-    // if (carry) ... // it should not happen.
+    if (LessMag(limbs))
+        throw std::logic_error("BigInt magnitude underflow");
+    int len2 = Size(limbs);
+    int len = Size();
+
+    mpn::Sub(&m_limbs[0], &m_limbs[0], len, limbs.data(), len2);
+    // there is no borrow, since this >= limbs.
+
     if (bInvSign) Inv_();
     if (bNormalize) Normalize_();
     return *this;
 } // SubtractMag_
 
-
 /*
-    in-place subtract operation.
-
+    in-place reverse subtract magnitude-only operation. ie, this = limbs - this.
+    it saves cloning of the bigger operand.
+    warning:
+        it should be called only when
+        this magnitude is less than or equal to others.
+        otherwise throws std::logic_error before this is modified.
 */
-BigInt& BigInt::Subtract_(const BigInt& rhs)
+BigInt& BigInt::SubtractFromMag_(const LimbBuf& limbs, bool bInvSign, bool bNormalize)
 {
-    // different sign
-#if 0
-    if (!m_sign && rhs.m_sign) { // positive - negative
-        return AddMag_(rhs.m_digits, false);
-    }
-    else if (m_sign && !rhs.m_sign) { // negative - positive
-        return AddMag_(rhs.m_digits, false);
-    }
-#else
-    if (!m_sign == rhs.m_sign) { // different sign
-        // final sign always follows first operand (this).
-        return AddMag_(rhs.m_digits);
-    }
-#endif
-    // same sign
-    if (LessMag(rhs.m_digits)) {
-        auto bigger = rhs; // copy
-        *this = bigger.SubtractMag_(m_digits, true).Move(); // invert sign
-        return *this;
-    }
-    else {
-        return SubtractMag_(rhs.m_digits, false);
-    }
-} // Subtract_
+    if (CompareMag(limbs) > 0)
+        throw std::logic_error("BigInt magnitude underflow");
+    int len2 = Size(limbs);
+    this->Extend_(len2);
 
+    // zero-extended limbs of this are already in place.
+    mpn::SubN(&m_limbs[0], limbs.data(), &m_limbs[0], len2);
+    // there is no borrow, since this <= limbs.
+
+    if (bInvSign) Inv_();
+    if (bNormalize) Normalize_();
+    return *this;
+} // SubtractFromMag_
 
-//-------------------------------------
 /*
-    comparison operator
+    in-place add of native magnitude with sign. subtract is add of negated one.
+    magnitude is put into limbs on stack, so nothing is allocated
+    unless result grows out of inline storage.
 */
+BigInt& BigInt::AddNative_(unsigned long long mag, bool bNeg)
+{
+    Limb w[kU64Limbs];
+    int wn = U64ToLimbArray(w, mag);
+    return AddLimbs_(w, wn, bNeg);
+} // AddNative_
 
 /*
-    compare magnitude only between this->digits and rhs.
-    return true if this->digits are less than rhs.
+    in-place add of read only magnitude b[0..bn) with sign.
+    if |this| < |b|, this = b - this with zero-extended limbs of this in place,
+    same as SubtractFromMag_().
+*/
+BigInt& BigInt::AddLimbs_(const Limb* b, int bn, bool bNeg)
+{
+    if (bn == 0)
+        return *this;
+    if (IsZero()) {
+        m_limbs.assign(b, b + bn);
+        m_sign = bNeg;
+        return *this;
+    }
+    int n = Size();
+    if (m_sign == bNeg) {
+        // zero-extended to len, so that b is never longer.
+        int len = std::max(n, bn);
+        Extend_(len);
+        Limb carry = mpn::Add(&m_limbs[0], &m_limbs[0], len, b, bn);
+        if (carry) {
+            m_limbs.resize(len);
+            m_limbs.push_back(carry);
+        }
+        return Normalize_();
+    }
+    if (mpn::Cmp(&m_limbs[0], n, b, bn) >= 0) {
+        mpn::Sub(&m_limbs[0], &m_limbs[0], n, b, bn);
+        return Normalize_();
+    }
+    // |this| < |b|, so n <= bn. sign follows rhs.
+    Extend_(bn);
+    mpn::SubN(&m_limbs[0], b, &m_limbs[0], bn);
+    m_sign = bNeg;
+    return Normalize_();
+} // AddLimbs_
+
+/*
+    n-ary add/subtract, for lazy expression. (see pyc_big_integer_expr.hpp)
+
+    all terms are summed by mpn::SumN() in single carry pass,
+    and result is normalized only once.
+    negative sum comes out as two's complement, so it is negated back:
+        -(c * B^n + low) where c < 0 is (-c - 1) * B^n + (B^n - low),
+        or (-c) * B^n if low is zero.
+*/
+BigInt& BigInt::AssignSum_(const BigInt* const* xs, const bool* negs, int m)
+{
+    // sizes are read before resize, since xs may include *this.
+    int n = 1;
+    for (int i=0; i<m; i++)
+        n = std::max(n, xs[i]->Size());
+    m_limbs.resize(n, 0);
+
+    mpn::SumTerm local[16];
+    mpn::ScratchVec<mpn::SumTerm> heap;
+    mpn::SumTerm* t = local;
+    if (m > 16) {
+        heap.resize(m);
+        t = heap.data();
+    }
+    for (int i=0; i<m; i++)
+        t[i] = { xs[i]->m_limbs.data(), xs[i]->Size(), negs[i] != xs[i]->m_sign };
+
+    int64_t carry = mpn::SumN(&m_limbs[0], n, t, m);
+    bool bSign = carry < 0;
+    if (bSign) {
+        Limb nz = mpn::NegN(&m_limbs[0], &m_limbs[0], n);
+        carry = -carry - (nz ? 1 : 0);
+    }
+    // carry is less than m, in magnitude.
+    while (carry > 0) {
+        m_limbs.push_back(Limb(carry % (int64_t)mpn::kBase));
+        carry /= (int64_t)mpn::kBase;
+    }
+    m_sign = bSign;
+    return Normalize_();
+} // AssignSum_
+
+
+/*
+    in-place subtract operation.
+
+*/
+BigInt& BigInt::Subtract_(const BigInt& rhs)
+{
+    if (!m_sign == rhs.m_sign) { // different sign
+        // final sign always follows first operand (this).
+        return AddMag_(rhs.m_limbs);
+    }
+    // same sign
+    if (LessMag(rhs.m_limbs)) {
+        // 11 - 222 => -(222 - 11)
+        return SubtractFromMag_(rhs.m_limbs, true); // invert sign
+    }
+    else {
+        return SubtractMag_(rhs.m_limbs, false);
+    }
+} // Subtract_
+
+
+/*
+    in-place multiply operation.
+
+    single limb multiplier is done in-place.
+    otherwise product is calculated into new limb vector, by mpn::Mul()
+    which selects schoolbook, karatsuba or toom-3 algorithm by size.
+*/
+BigInt& BigInt::Mul_(const BigInt& rhs)
+{
+    bool bSign = m_sign != rhs.m_sign;
+    if (IsZero() || rhs.IsZero()) {
+        m_limbs.assign(1, 0);
+        m_sign = false;
+        return *this;
+    }
+    int an = Size();
+    int bn = rhs.Size();
+
+    if (bn == 1) {
+        m_limbs.resize(an);
+        Limb carry = mpn::Mul1(&m_limbs[0], &m_limbs[0], an, rhs.m_limbs[0]);
+        if (carry) m_limbs.push_back(carry);
+    }
+    else if (an == 1) {
+        Limb m = m_limbs[0];
+        m_limbs.assign(bn, 0);
+        Limb carry = mpn::Mul1(&m_limbs[0], rhs.m_limbs.data(), bn, m);
+        if (carry) m_limbs.push_back(carry);
+    }
+    else {
+        // product goes to same resource, so that swap does not copy.
+        LimbBuf r(m_limbs.resource());
+        r.resize(an + bn);
+        if (this == &rhs || EqualMag(rhs.m_limbs))
+            mpn::Sqr(r.data(), m_limbs.data(), an);
+        else if (an >= bn)
+            mpn::Mul(r.data(), m_limbs.data(), an, rhs.m_limbs.data(), bn);
+        else
+            mpn::Mul(r.data(), rhs.m_limbs.data(), bn, m_limbs.data(), an);
+        m_limbs.swap(r);
+    }
+    m_sign = bSign;
+    Normalize_();
+    return *this;
+} // Mul_
+
+
+/*
+    in-place multiply by native magnitude with sign. limbs of it are on stack.
+*/
+BigInt& BigInt::MulNative_(unsigned long long mag, bool bNeg)
+{
+    Limb w[kU64Limbs];
+    int wn = U64ToLimbArray(w, mag);
+    return MulLimbs_(w, wn, bNeg);
+} // MulNative_
+
+/*
+    in-place multiply by read only magnitude b[0..bn) with sign.
+    single limb multiplier is done in-place by mpn::Mul1().
+*/
+BigInt& BigInt::MulLimbs_(const Limb* b, int bn, bool bNeg)
+{
+    if (IsZero() || bn == 0) {
+        m_limbs.assign(1, 0);
+        m_sign = false;
+        return *this;
+    }
+    bool bSign = m_sign != bNeg;
+    int n = Size();
+    if (bn == 1) {
+        m_limbs.resize(n);
+        Limb carry = mpn::Mul1(&m_limbs[0], &m_limbs[0], n, b[0]);
+        if (carry) m_limbs.push_back(carry);
+    }
+    else if (n == 1) {
+        Limb m = m_limbs[0];
+        m_limbs.assign(bn, 0);
+        Limb carry = mpn::Mul1(&m_limbs[0], b, bn, m);
+        if (carry) m_limbs.push_back(carry);
+    }
+    else {
+        LimbBuf r(m_limbs.resource());
+        r.resize(n + bn);
+        if (n >= bn)
+            mpn::Mul(r.data(), m_limbs.data(), n, b, bn);
+        else
+            mpn::Mul(r.data(), b, bn, m_limbs.data(), n);
+        m_limbs.swap(r);
+    }
+    m_sign = bSign;
+    return Normalize_();
+} // MulLimbs_
+
+
+/*
+    floor division (python semantics).
+
+    magnitude is divided by mpn::DivRem() first, which truncates toward zero.
+    if signs differ and remainder is not zero, it is adjusted toward -inf:
+        q = -(|q| + 1), r = sign(b) * (|b| - |r|)
+    so remainder always takes sign of divisor.
+*/
+void BigInt::DivMod(const BigInt& a, const BigInt& b, BigInt* q, BigInt* r)
+{
+    if (b.IsZero())
+        throw std::domain_error("division by zero");
+
+    const bool qSign = a.m_sign != b.m_sign;
+    const bool bSign = b.m_sign;
+    int an = a.Size();
+    int bn = b.Size();
+    // results are built on resource of destination.
+    LimbBuf ql(q ? q->m_limbs.resource() : a.m_limbs.resource());
+    LimbBuf rl(r ? r->m_limbs.resource() : a.m_limbs.resource());
+    if (a.LessMag(b.m_limbs)) {
+        ql.assign(1, 0);
+        rl.assign(a.m_limbs.begin(), a.m_limbs.begin() + an);
+    }
+    else if (an <= LimbBuf::kInline) {
+        // both fit in 64 bits. native division does not allocate.
+        unsigned long long x = LimbsToU64(a.m_limbs, an);
+        unsigned long long y = LimbsToU64(b.m_limbs, bn);
+        U64ToLimbs(ql, x / y);
+        U64ToLimbs(rl, x % y);
+    }
+    else {
+        ql.resize(an - bn + 1);
+        rl.resize(bn);
+        mpn::DivRem(ql.data(), rl.data(), a.m_limbs.data(), an, b.m_limbs.data(), bn);
+    }
+    bool rSign = a.m_sign;
+    if (qSign && mpn::NormSize(rl.data(), (int)rl.size()) > 0) {
+        const Limb one = 1;
+        if (mpn::Add(ql.data(), ql.data(), (int)ql.size(), &one, 1))
+            ql.push_back(1);
+        // rl.size() <= bn
+        LimbBuf t(rl.resource());
+        t.assign(b.m_limbs.begin(), b.m_limbs.begin() + bn);
+        mpn::Sub(t.data(), t.data(), bn, rl.data(), (int)rl.size());
+        rl.swap(t);
+        rSign = bSign;
+    }
+    // all inputs are consumed. now it is safe to overwrite a or b.
+    if (q) {
+        q->m_limbs.swap(ql);
+        q->m_sign = qSign;
+        q->Normalize_();
+    }
+    if (r) {
+        r->m_limbs.swap(rl);
+        r->m_sign = rSign;
+        r->Normalize_();
+    }
+} // DivMod
+
+BigInt& BigInt::FloorDiv_(const BigInt& rhs)
+{
+    DivMod(*this, rhs, this, nullptr);
+    return *this;
+}
+
+BigInt& BigInt::Mod_(const BigInt& rhs)
+{
+    DivMod(*this, rhs, nullptr, this);
+    return *this;
+}
+
+/*
+    divisor less than one limb is divided in-place by mpn::DivRem1().
+    otherwise it falls back to DivMod().
+*/
+long long BigInt::DivMod_(long long rhs)
+{
+    if (rhs == 0)
+        throw std::domain_error("division by zero");
+    const bool bSign = rhs < 0;
+    const unsigned long long d = bSign ? 0ULL - (unsigned long long)rhs : rhs;
+    if (d >= mpn::kBase) {
+        BigInt r;
+        DivMod(*this, BigInt(rhs), this, &r);
+        return r.ToLongLong();
+    }
+
+    int n = Size();
+    unsigned long long rem = mpn::DivRem1(&m_limbs[0], &m_limbs[0], n, Limb(d));
+    if (rem && m_sign != bSign) {
+        const Limb one = 1;
+        if (mpn::Add(&m_limbs[0], &m_limbs[0], n, &one, 1)) {
+            m_limbs.resize(n);
+            m_limbs.push_back(1);
+        }
+        rem = d - rem;
+    }
+    m_sign = m_sign != bSign;
+    Normalize_();
+    return bSign ? -(long long)rem : (long long)rem;
+} // DivMod_
+
+long long BigInt::Mod(long long rhs) const
+{
+    if (rhs == 0)
+        throw std::domain_error("division by zero");
+    const bool bSign = rhs < 0;
+    const unsigned long long d = bSign ? 0ULL - (unsigned long long)rhs : rhs;
+    if (d >= mpn::kBase) {
+        BigInt r;
+        DivMod(*this, BigInt(rhs), nullptr, &r);
+        return r.ToLongLong();
+    }
+
+    mpn::DLimb rem = 0;
+    for (int k=Size()-1; k>=0; k--)
+        rem = (rem * mpn::kBase + m_limbs[k]) % d;
+    if (rem && m_sign != bSign)
+        rem = d - rem;
+    return bSign ? -(long long)rem : (long long)rem;
+} // Mod
+
+
+/*
+    left-to-right binary exponentiation. squaring is detected by Mul_().
+    result size is estimated first, so that absurd exponent fails early.
+*/
+BigInt BigInt::Pow(const BigInt& base, const BigInt& exp)
+{
+    if (exp.m_sign)
+        throw std::domain_error("negative exponent");
+    if (exp.IsZero())
+        return BigInt(1, base.get_allocator());
+    // 0, 1, -1
+    if (base.Size() == 1 && base.m_limbs[0] <= 1) {
+        bool bOdd = exp.m_limbs[0] % 2 != 0; // kBase is even
+        return (base.m_sign && !bOdd) ? BigInt(1, base.get_allocator()) : base;
+    }
+    int en = exp.Size();
+    unsigned long long e = LimbsToU64(exp.m_limbs, std::min(en, LimbBuf::kInline));
+    if (en > LimbBuf::kInline || e > (unsigned long long)(INT_MAX / 2) / base.Size())
+        throw std::overflow_error("exponent too large");
+
+    int top = 63;
+    while (!((e >> top) & 1)) top--;
+    BigInt res = base.Clone();
+    for (int k=top-1; k>=0; k--) {
+        res.Mul_(res);
+        if ((e >> k) & 1)
+            res.Mul_(base);
+    }
+    return res;
+} // Pow
+
+
+/*
+    see mpn::Gcd(). native gcd for small numbers, without allocation.
+*/
+BigInt BigInt::Gcd(const BigInt& a, const BigInt& b)
+{
+    int an = a.Size(), bn = b.Size();
+    BigInt res(a.get_allocator());
+    if (an <= LimbBuf::kInline && bn <= LimbBuf::kInline) {
+        U64ToLimbs(res.m_limbs, std::gcd(LimbsToU64(a.m_limbs, an), LimbsToU64(b.m_limbs, bn)));
+        return res;
+    }
+    res.m_limbs.resize(std::max(an, bn));
+    int n = mpn::Gcd(res.m_limbs.data(), a.m_limbs.data(), an, b.m_limbs.data(), bn);
+    res.m_limbs.resize(std::max(n, 1));
+    res.Normalize_();
+    return res;
+}
+
+/*
+    see mpn::ModInverse(). a is taken modulo |m| first.
+*/
+BigInt BigInt::ModInverse(const BigInt& a, const BigInt& m)
+{
+    if (m.IsZero())
+        throw std::domain_error("pow() 3rd argument cannot be 0");
+    BigInt res(a.get_allocator());
+    int mn = m.Size();
+    if (mn == 1 && m.m_limbs[0] == 1)
+        return res;
+
+    BigInt x = a.m_sign ? a % m.Abs() : a;
+    res.m_limbs.resize(mn);
+    int n = mpn::ModInverse(res.m_limbs.data(), x.m_limbs.data(), x.Size(), m.m_limbs.data(), mn);
+    if (n < 0)
+        throw std::domain_error("base is not invertible for the given modulus");
+    res.Normalize_();
+    if (m.m_sign && !res.IsZero())
+        res.Add_(m);
+    return res;
+} // ModInverse
+
+
+BigInt BigInt::Sqrt(const BigInt& a, BigInt* rem)
+{
+    if (a.m_sign)
+        throw std::domain_error("isqrt() argument must be nonnegative");
+    if (!rem || a.IsZero()) {
+        if (rem) *rem = a;
+        return Root(a, 2);
+    }
+    int an = a.Size(), rn = 0;
+    BigInt res(a.get_allocator());
+    LimbBuf r(rem->m_limbs.resource());
+    res.m_limbs.resize((an + 1) / 2);
+    r.resize((an + 1) / 2 + 1);
+    int sn = mpn::SqrtRem(res.m_limbs.data(), r.data(), a.m_limbs.data(), an, rn);
+    res.m_limbs.resize(sn);
+    r.resize(std::max(rn, 1));
+    rem->m_limbs.swap(r);
+    rem->m_sign = false;
+    return res;
+}
+
+/*
+    see mpn::Root(). small number is done in place, without allocation.
+*/
+BigInt BigInt::Root(const BigInt& a, int n)
+{
+    if (n < 1)
+        throw std::domain_error("root degree must be positive");
+    if (a.m_sign)
+        throw std::domain_error("root of negative number");
+    if (n == 1 || a.IsZero())
+        return a;
+    int an = a.Size();
+    BigInt res(a.get_allocator());
+    res.m_limbs.resize(an / n + 1);
+    int rn = mpn::Root(res.m_limbs.data(), a.m_limbs.data(), an, n);
+    res.m_limbs.resize(std::max(rn, 1));
+    return res;
+}
+
+
+//-------------------------------------
+// combinatorics
+
+namespace {
+
+// throws std::overflow_error if result of about 'bits' bits does not fit.
+void CheckResultBits(double bits)
+{
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    double limbs = bits * 0.30103; // log10(2)
+#else
+    double limbs = bits / mpn::kLimbBits;
+#endif
+    if (limbs > INT_MAX / 2)
+        throw std::overflow_error("result too large");
+}
+
+// log2(n!)
+double Log2Factorial(double n)
+{
+    return std::lgamma(n + 1) / std::log(2.0);
+}
+
+// odd primes up to n, by sieve of odd numbers only.
+std::vector<uint32_t> OddPrimes(uint32_t n)
+{
+    std::vector<uint32_t> primes;
+    if (n < 3)
+        return primes;
+    std::vector<uint8_t> composite((n - 1) / 2); // index i is for 2i+3
+    for (size_t i=0; i<composite.size(); i++) {
+        if (composite[i])
+            continue;
+        uint64_t p = 2*i + 3;
+        primes.push_back(uint32_t(p));
+        for (uint64_t q=p*p; q<=n; q+=2*p)
+            composite[(q - 3) / 2] = 1;
+    }
+    return primes;
+}
+
+// exponent of prime p in n!
+uint64_t Legendre(uint64_t n, uint64_t p)
+{
+    uint64_t e = 0;
+    while (n) {
+        n /= p;
+        e += n;
+    }
+    return e;
+}
+
+// v[0] * .. * v[n-1], by binary splitting. big multiplications get balanced operands.
+BigInt ProductTree(const long long* v, int n)
+{
+    if (n == 0)
+        return BigInt(1);
+    if (n == 1)
+        return BigInt(v[0]);
+    int h = n / 2;
+    BigInt r = ProductTree(v, h);
+    return r *= ProductTree(v + h, n - h);
+}
+
+/*
+    product of p[i] ^ e[i].
+    primes whose exponent has bit b set are multiplied by product tree into P_b,
+    and they are combined from top bit by squaring:
+        r = (..((P_top)^2 * P_top-1)^2 ..)^2 * P_0
+    so that every big multiplication is a squaring or a balanced one.
+    small primes are packed into one word, so leaves of the tree are full.
+*/
+BigInt PrimePowerProduct(const std::vector<uint32_t>& p, const std::vector<uint64_t>& e)
+{
+    uint64_t emax = 0;
+    for (uint64_t x : e) emax = std::max(emax, x);
+    BigInt r = 1;
+    std::vector<long long> v;
+    for (int b=std::bit_width(emax)-1; b>=0; b--) {
+        r.Mul_(r);
+        v.clear();
+        unsigned long long acc = 1;
+        for (size_t i=0; i<p.size(); i++) {
+            if (!((e[i] >> b) & 1))
+                continue;
+            if (acc > (1ULL << 62) / p[i]) {
+                v.push_back((long long)acc);
+                acc = 1;
+            }
+            acc *= p[i];
+        }
+        if (acc > 1)
+            v.push_back((long long)acc);
+        if (!v.empty())
+            r.Mul_(ProductTree(v.data(), (int)v.size()));
+    }
+    return r;
+}
+
+/*
+    n! / (a! * b!), a + b <= n, by prime factorization.
+    exponent of each prime is counted by legendre's formula, and the power
+    of two is applied by one shift at last.
+*/
+BigInt FactorialQuotient(uint32_t n, uint32_t a, uint32_t b)
+{
+    std::vector<uint32_t> primes = OddPrimes(n);
+    std::vector<uint64_t> e(primes.size());
+    for (size_t i=0; i<primes.size(); i++)
+        e[i] = Legendre(n, primes[i]) - Legendre(a, primes[i]) - Legendre(b, primes[i]);
+    BigInt r = PrimePowerProduct(primes, e);
+    r.ShiftLeft_((long long)(Legendre(n, 2) - Legendre(a, 2) - Legendre(b, 2)));
+    return r;
+}
+
+// lo * (lo+1) * .. * (lo+cnt-1), by binary splitting.
+BigInt RangeProduct(const BigInt& lo, long long cnt)
+{
+    if (cnt <= 8) {
+        BigInt r = 1, x = lo;
+        for (long long i=0; i<cnt; i++, x += 1)
+            r *= x;
+        return r;
+    }
+    long long h = cnt / 2;
+    BigInt r = RangeProduct(lo, h);
+    return r *= RangeProduct(lo + BigInt(h), cnt - h);
+}
+
+// factorization needs a sieve up to n, so it is used only if result is big enough.
+constexpr long long kFactorSieveMax = INT_MAX;
+bool UseFactorization(long long n, long long k)
+{
+    return n <= kFactorSieveMax && k >= n / 64;
+}
+// below this k, term by term is faster than any tree.
+constexpr long long kCombTermwiseMax = 16;
+
+} // namespace
+
+/*
+    small n is done in native integer.
+    otherwise by prime factorization. (see FactorialQuotient)
+*/
+BigInt BigInt::Factorial(const BigInt& n)
+{
+    if (n.m_sign)
+        throw std::domain_error("factorial() not defined for negative values");
+    if (n.Size() > LimbBuf::kInline || LimbsToU64(n.m_limbs, n.Size()) > (unsigned long long)kFactorSieveMax)
+        throw std::overflow_error("result too large");
+    long long x = n.ToLongLong();
+    if (x <= 20) {
+        long long r = 1;
+        for (long long i=2; i<=x; i++) r *= i;
+        return BigInt(r);
+    }
+    CheckResultBits(Log2Factorial((double)x));
+    return FactorialQuotient(uint32_t(x), 0, 0);
+}
+
+/*
+    C(n, k) == C(n, n - k), so smaller one is taken as k.
+    - small k: term by term. C(n, i) = C(n, i-1) * (n-i+1) / i is exact.
+    - k comparable to n: prime factorization of n! / (k! (n-k)!).
+    - k much smaller than n: product tree of n-k+1 .. n, divided by k!.
+*/
+BigInt BigInt::Comb(const BigInt& n, const BigInt& k)
+{
+    if (n.m_sign)
+        throw std::domain_error("n must be a non-negative integer");
+    if (k.m_sign)
+        throw std::domain_error("k must be a non-negative integer");
+    if (n.Less(k))
+        return BigInt(0);
+    BigInt nk = n - k;
+    const BigInt& m = nk.Less(k) ? nk : k;
+    if (m.IsZero())
+        return BigInt(1);
+    if (m.Size() > LimbBuf::kInline || LimbsToU64(m.m_limbs, m.Size()) > (unsigned long long)LLONG_MAX)
+        throw std::overflow_error("result too large");
+    long long mk = m.ToLongLong();
+
+    bool bSmallN = n.Size() <= LimbBuf::kInline && LimbsToU64(n.m_limbs, n.Size()) <= (unsigned long long)LLONG_MAX;
+    if (bSmallN) {
+        double nd = (double)n.ToLongLong();
+        CheckResultBits(Log2Factorial(nd) - Log2Factorial((double)mk) - Log2Factorial(nd - (double)mk));
+    }
+    else
+        CheckResultBits((double)mk * (double)n.BitLength());
+
+    if (mk < kCombTermwiseMax) {
+        BigInt r = n, x = n;
+        for (long long i=2; i<=mk; i++) {
+            x -= 1;
+            r *= x;
+            r.DivMod_(i);
+        }
+        return r;
+    }
+    if (bSmallN && UseFactorization(n.ToLongLong(), mk)) {
+        uint32_t x = uint32_t(n.ToLongLong());
+        return FactorialQuotient(x, uint32_t(mk), x - uint32_t(mk));
+    }
+    BigInt r = RangeProduct(n - BigInt(mk) + 1, mk);
+    DivMod(r, Factorial(BigInt(mk)), &r, nullptr);
+    return r;
+} // Comb
+
+/*
+    n! / (n-k)!, by prime factorization if k is comparable to n,
+    otherwise by product tree of n-k+1 .. n.
+*/
+BigInt BigInt::Perm(const BigInt& n, const BigInt& k)
+{
+    if (n.m_sign)
+        throw std::domain_error("n must be a non-negative integer");
+    if (k.m_sign)
+        throw std::domain_error("k must be a non-negative integer");
+    if (n.Less(k))
+        return BigInt(0);
+    if (k.IsZero())
+        return BigInt(1);
+    if (k.Size() > LimbBuf::kInline || LimbsToU64(k.m_limbs, k.Size()) > (unsigned long long)LLONG_MAX)
+        throw std::overflow_error("result too large");
+    long long mk = k.ToLongLong();
+    CheckResultBits((double)mk * (double)n.BitLength());
+
+    bool bSmallN = n.Size() <= LimbBuf::kInline && LimbsToU64(n.m_limbs, n.Size()) <= (unsigned long long)LLONG_MAX;
+    if (bSmallN && mk >= kCombTermwiseMax && UseFactorization(n.ToLongLong(), mk)) {
+        uint32_t x = uint32_t(n.ToLongLong());
+        return FactorialQuotient(x, x - uint32_t(mk), 0);
+    }
+    return RangeProduct(n - BigInt(mk) + 1, mk);
+} // Perm
+
+
+//-------------------------------------
+// bitwise
+
+namespace {
+
+/*
+    r[0..n) = a op b, on two's complement of n words. returns sign of result.
+    negative operand is complemented on the fly, and so is the result.
+    (each carry of +1 runs only through low zero words)
+    n = max(an, bn) is enough, except that magnitude of negative result
+    can be 2^(n*bits). then r is all zero, and bHigh is set for the next word.
+    r may be same as a or b.
+*/
+template <typename W, typename Op>
+bool BitOpWords(W* r, int n, const W* a, int an, bool sa, const W* b, int bn, bool sb, Op op, bool& bHigh)
+{
+    const bool neg = op(sa, sb);
+    W ca = 1, cb = 1, cr = 1;
+    for (int k=0; k<n; k++) {
+        W x = k < an ? a[k] : 0, y = k < bn ? b[k] : 0;
+        if (sa) { x = W(~x + ca); ca = ca && x == 0; }
+        if (sb) { y = W(~y + cb); cb = cb && y == 0; }
+        W z = op(x, y);
+        if (neg) { z = W(~z + cr); cr = cr && z == 0; }
+        r[k] = z;
+    }
+    bHigh = neg && cr;
+    return neg;
+}
+
+template <typename W>
+bool BitOpWords(W* r, int n, const W* a, int an, bool sa, const W* b, int bn, bool sb, char op, bool& bHigh)
+{
+    if (op == '&')
+        return BitOpWords(r, n, a, an, sa, b, bn, sb, std::bit_and<>(), bHigh);
+    if (op == '|')
+        return BitOpWords(r, n, a, an, sa, b, bn, sb, std::bit_or<>(), bHigh);
+    return BitOpWords(r, n, a, an, sa, b, bn, sb, std::bit_xor<>(), bHigh);
+}
+
+// bit k of two's complement of -a.
+template <typename W>
+bool TestBitNeg(const W* a, int n, long long k)
+{
+    constexpr int kBits = sizeof(W) * 8;
+    long long w = k / kBits;
+    if (w >= n)
+        return true;
+    // words below lowest non-zero one stay zero, and it is negated. others are complemented.
+    int z = 0;
+    while (a[z] == 0) z++;
+    W x = w < z ? W(0) : w == z ? W(0 - a[w]) : W(~a[w]);
+    return (x >> (k % kBits)) & 1;
+}
+
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+// binary words of magnitude, since decimal digits can not be masked.
+using Word = uint32_t;
+using WordVec = mpn::ScratchVec<Word>;
+
+// by repeated division by 2^32.
+WordVec ToWords(const mpn::LimbBuf& limbs, int n)
+{
+    mpn::LimbVec q(limbs.begin(), limbs.begin() + n);
+    WordVec w;
+    while (n > 0) {
+        uint64_t rem = 0;
+        for (int k=n-1; k>=0; k--) {
+            rem = rem * mpn::kBase + q[k];
+            q[k] = mpn::Limb(rem >> 32);
+            rem &= 0xFFFFFFFFu;
+        }
+        w.push_back(Word(rem));
+        n = mpn::NormSize(q.data(), n);
+    }
+    return w;
+}
+
+// by horner's method, multiplying 2^32 from the top word.
+void FromWords(mpn::LimbBuf& limbs, const Word* w, int n)
+{
+    limbs.assign(1, 0);
+    for (int i=n-1; i>=0; i--) {
+        uint64_t carry = w[i];
+        for (int k=0; k<limbs.size(); k++) {
+            carry += (uint64_t)limbs[k] << 32;
+            limbs[k] = mpn::Limb(carry % mpn::kBase);
+            carry /= mpn::kBase;
+        }
+        for (; carry; carry /= mpn::kBase)
+            limbs.push_back(mpn::Limb(carry % mpn::kBase));
+    }
+}
+#endif
+
+} // namespace
+
+BigInt& BigInt::BitOp_(const BigInt& rhs, char op)
+{
+    int an = Size(), bn = rhs.Size();
+    bool bHigh;
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    WordVec a = ToWords(m_limbs, an), b = ToWords(rhs.m_limbs, bn);
+    int n = (int)std::max(a.size(), b.size());
+    WordVec r(n);
+    m_sign = BitOpWords(r.data(), n, a.data(), (int)a.size(), m_sign, b.data(), (int)b.size(), rhs.m_sign, op, bHigh);
+    if (bHigh) r.push_back(1);
+    FromWords(m_limbs, r.data(), (int)r.size());
+#else
+    // in place. rhs may be *this, and it is read before written.
+    int n = std::max(an, bn);
+    m_limbs.resize(n);
+    m_sign = BitOpWords(m_limbs.data(), n, m_limbs.data(), an, m_sign, rhs.m_limbs.data(), bn, rhs.m_sign, op, bHigh);
+    if (bHigh) m_limbs.push_back(1);
+#endif
+    return Normalize_();
+}
+
+// -x - 1
+BigInt BigInt::operator~() const
+{
+    BigInt res = Clone();
+    res.Inv_();
+    res.Subtract_(BigInt(1, get_allocator()));
+    return res;
+}
+
+BigInt& BigInt::ShiftLeft_(long long cnt)
+{
+    if (cnt < 0)
+        throw std::domain_error("negative shift count");
+    if (IsZero() || cnt == 0)
+        return *this;
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    return Mul_(Pow(2, cnt));
+#else
+    long long limbs = cnt / mpn::kLimbBits;
+    int bits = int(cnt % mpn::kLimbBits), n = Size();
+    if (limbs > INT_MAX - n - 1)
+        throw std::overflow_error("shift count too large");
+    m_limbs.resize(n + (int)limbs + 1);
+    Limb* p = m_limbs.data();
+    if (bits)
+        p[n + limbs] = mpn::Lshift(p + limbs, p, n, bits);
+    else {
+        std::copy_backward(p, p + n, p + n + limbs);
+        p[n + limbs] = 0;
+    }
+    std::fill(p, p + limbs, Limb(0));
+    return Normalize_();
+#endif
+}
+
+/*
+    magnitude is shifted, and negative one is rounded toward -inf,
+    by adding 1 to it if any of 1 bits is shifted out.
+*/
+BigInt& BigInt::ShiftRight_(long long cnt)
+{
+    if (cnt < 0)
+        throw std::domain_error("negative shift count");
+    if (IsZero() || cnt == 0)
+        return *this;
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    return FloorDiv_(Pow(2, cnt));
+#else
+    int n = Size();
+    if (cnt >= (long long)n * mpn::kLimbBits) {
+        // all bits are shifted out.
+        m_limbs.assign(1, m_sign ? 1 : 0);
+        return *this;
+    }
+    int limbs = int(cnt / mpn::kLimbBits), bits = int(cnt % mpn::kLimbBits);
+    Limb* p = m_limbs.data();
+    bool bLost = false;
+    for (int k=0; k<limbs && !bLost; k++)
+        bLost = p[k] != 0;
+    if (bits)
+        bLost |= mpn::Rshift(p, p + limbs, n - limbs, bits) != 0;
+    else
+        std::copy(p + limbs, p + n, p);
+    m_limbs.resize(n - limbs);
+    if (m_sign && bLost) {
+        m_limbs.push_back(0);
+        Limb one = 1;
+        mpn::Add(m_limbs.data(), m_limbs.data(), m_limbs.size(), &one, 1);
+    }
+    return Normalize_();
+#endif
+}
+
+long long BigInt::BitLength() const
+{
+    int n = Size();
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    WordVec w = ToWords(m_limbs, n);
+    n = (int)w.size();
+    return n ? 32LL * (n - 1) + std::bit_width(w[n - 1]) : 0;
+#else
+    return mpn::kLimbBits * (n - 1LL) + std::bit_width(m_limbs[n - 1]);
+#endif
+}
+
+long long BigInt::BitCount() const
+{
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    long long c = 0;
+    for (Word x : ToWords(m_limbs, Size()))
+        c += std::popcount(x);
+    return c;
+#else
+    return mpn::PopCount(m_limbs.data(), Size());
+#endif
+}
+
+bool BigInt::TestBit(long long k) const
+{
+    if (k < 0)
+        throw std::domain_error("negative bit index");
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    WordVec w = ToWords(m_limbs, Size());
+    const Word* a = w.data();
+    int n = (int)w.size();
+    constexpr int kBits = 32;
+#else
+    const Limb* a = m_limbs.data();
+    int n = Size();
+    constexpr int kBits = mpn::kLimbBits;
+#endif
+    if (m_sign)
+        return TestBitNeg(a, n, k);
+    return k / kBits < n && ((a[k / kBits] >> (k % kBits)) & 1);
+}
+
+int BigInt::GetWords(uint32_t* w, int n) const
+{
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    WordVec v = ToWords(m_limbs, Size());
+    int wn = (int)v.size();
+    if (wn > n)
+        throw std::length_error("word buffer too small");
+    std::copy(v.begin(), v.end(), w);
+#else
+    int wn = IsZero() ? 0 : Size();
+    if (wn > n)
+        throw std::length_error("word buffer too small");
+    std::copy(m_limbs.begin(), m_limbs.begin() + wn, w);
+#endif
+    return wn;
+}
+
+BigInt& BigInt::SetWords_(const uint32_t* w, int n, bool bNeg)
+{
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    FromWords(m_limbs, w, n);
+#else
+    m_limbs.assign(w, w + n);
+    if (n == 0)
+        m_limbs.assign(1, 0);
+#endif
+    m_sign = bNeg;
+    return Normalize_();
+}
+
+
+//-------------------------------------
+// serialization
+
+namespace {
+
+// little endian bytes p[0..len) of words w[0..n). bytes above words are zero.
+void WordsToBytes(const uint32_t* w, int n, std::byte* p, size_t len)
+{
+    size_t nb = std::min(len, (size_t)n * 4);
+    if constexpr (std::endian::native == std::endian::little)
+        std::memcpy(p, w, nb);
+    else
+        for (size_t k=0; k<nb; k++)
+            p[k] = std::byte(w[k / 4] >> (8 * (k % 4)));
+    std::memset(p + nb, 0, len - nb);
+}
+
+// words w[0..(len+3)/4) of little endian bytes p[0..len).
+void BytesToWords(const std::byte* p, size_t len, uint32_t* w)
+{
+    size_t n = (len + 3) / 4;
+    if (n == 0)
+        return;
+    w[n - 1] = 0;
+    if constexpr (std::endian::native == std::endian::little)
+        std::memcpy(w, p, len);
+    else {
+        std::fill(w, w + n, 0u);
+        for (size_t k=0; k<len; k++)
+            w[k / 4] |= uint32_t(p[k]) << (8 * (k % 4));
+    }
+}
+
+// two's complement of little endian bytes, in place.
+// zero bytes below lowest non-zero one stay zero, and it is negated. others are complemented.
+void NegateBytes(std::byte* p, size_t len)
+{
+    size_t k = 0;
+    while (k < len && p[k] == std::byte{0})
+        k++;
+    if (k == len)
+        return;
+    p[k] = std::byte(0u - unsigned(p[k]));
+    for (k++; k<len; k++)
+        p[k] = ~p[k];
+}
+
+size_t VarintSize(uint64_t v)
+{
+    return (std::bit_width(v | 1) + 6) / 7;
+}
+
+size_t PutVarint(std::byte* p, uint64_t v)
+{
+    size_t n = 0;
+    for (; v >= 0x80; v >>= 7)
+        p[n++] = std::byte(v | 0x80);
+    p[n++] = std::byte(v);
+    return n;
+}
+
+// returns bytes consumed. throws std::invalid_argument if truncated, longer than 64 bits,
+// or overlong. (last group is zero, ie. {0x82, 0x00} for 2)
+size_t GetVarint(std::span<const std::byte> in, uint64_t& v)
+{
+    v = 0;
+    for (size_t n=0; n<in.size() && n<10; n++) {
+        uint64_t b = uint64_t(in[n]);
+        if (n == 9 && b > 1)
+            break;
+        v |= (b & 0x7F) << (7 * n);
+        if (!(b & 0x80)) {
+            if (n > 0 && b == 0)
+                throw std::invalid_argument("non-canonical BigInt encoding");
+            return n + 1;
+        }
+    }
+    throw std::invalid_argument(in.size() < 10 ? "truncated BigInt encoding" : "invalid varint in BigInt encoding");
+}
 
-    assume both digitvec is normalized.
+} // namespace
+
+void BigInt::GetMagBytes(std::byte* p, size_t len) const
+{
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    WordVec w = ToWords(m_limbs, Size());
+    WordsToBytes(w.data(), (int)w.size(), p, len);
+#else
+    WordsToBytes(m_limbs.data(), IsZero() ? 0 : Size(), p, len);
+#endif
+}
+
+BigInt& BigInt::SetMagBytes_(const std::byte* p, size_t len, bool bNeg)
+{
+    if (len / 4 >= INT_MAX)
+        throw std::length_error("too many bytes for BigInt");
+    int n = int((len + 3) / 4);
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    WordVec w(n);
+    BytesToWords(p, len, w.data());
+    FromWords(m_limbs, w.data(), n);
+#else
+    m_limbs.resize(std::max(n, 1));
+    m_limbs[0] = 0;
+    BytesToWords(p, len, m_limbs.data());
+#endif
+    m_sign = bNeg;
+    return Normalize_();
+}
+
+/*
+    magnitude is written, and negated in place for negative number.
+    sign bit of the result tells if it fits, same as python.
+    out is unspecified if it throws.
 */
-bool BigInt::LessMag(const DgtVec& rhs) const
+void BigInt::ToBytes(std::span<std::byte> out, std::endian order, bool bSigned) const
 {
-    int width1 = Width();
-    int width2 = Width(rhs);
-    if (width1 < width2)
-        return true;
-    else if (width1 > width2)
-        return false;
+    if (m_sign && !bSigned)
+        throw std::overflow_error("can't convert negative int to unsigned");
+    const size_t len = out.size();
+    if ((unsigned long long)(BitLength() + 7) / 8 > len)
+        throw std::overflow_error("int too big to convert");
+    std::byte* p = out.data();
+    GetMagBytes(p, len);
+    if (m_sign)
+        NegateBytes(p, len);
+    if (bSigned && !IsZero() && ((p[len - 1] & std::byte{0x80}) != std::byte{0}) != m_sign)
+        throw std::overflow_error("int too big to convert");
+    if (order == std::endian::big)
+        std::reverse(p, p + len);
+}
 
-    auto &v1 = m_digits;
-    auto &v2 = rhs;
+std::vector<std::byte> BigInt::ToBytes(size_t length, std::endian order, bool bSigned) const
+{
+    std::vector<std::byte> v(length);
+    ToBytes(std::span<std::byte>(v), order, bSigned);
+    return v;
+}
+
+BigInt BigInt::FromBytes(std::span<const std::byte> in, std::endian order, bool bSigned)
+{
+    const size_t len = in.size();
+    const bool bBig = order == std::endian::big;
+    const bool bNeg = bSigned && len && ((in[bBig ? 0 : len - 1] & std::byte{0x80}) != std::byte{0});
+    BigInt r;
+    if (!bBig && !bNeg) {
+        r.SetMagBytes_(in.data(), len, false);
+        return r;
+    }
+    // little endian magnitude in scratch.
+    mpn::ScratchVec<std::byte> tmp(in.begin(), in.end());
+    if (bBig)
+        std::reverse(tmp.begin(), tmp.end());
+    if (bNeg)
+        NegateBytes(tmp.data(), len);
+    r.SetMagBytes_(tmp.data(), len, bNeg);
+    return r;
+}
 
-    // lexicographical_compare returns true
-    // if the first range is lexicographically less than the second.
-    return std::lexicographical_compare(
-        v1.rbegin(), v1.rend(),
-        v2.rbegin(), v2.rend());
+size_t BigInt::EncodedSize() const
+{
+    uint64_t nb = uint64_t(BitLength() + 7) / 8;
+    return VarintSize(nb << 1 | m_sign) + nb;
 }
 
-bool BigInt::EqualMag(const DgtVec& rhs) const
+size_t BigInt::Encode(std::span<std::byte> out) const
 {
-    int width1 = Width();
-    int width2 = Width(rhs);
-    if (width1 != width2)
-        return false;
+    uint64_t nb = uint64_t(BitLength() + 7) / 8;
+    uint64_t head = nb << 1 | m_sign;
+    size_t hn = VarintSize(head);
+    if (out.size() < hn + nb)
+        throw std::length_error("buffer too small for BigInt encoding");
+    PutVarint(out.data(), head);
+    GetMagBytes(out.data() + hn, nb);
+    return hn + nb;
+}
+
+BigInt BigInt::Decode(std::span<const std::byte> in, size_t* used)
+{
+    uint64_t head;
+    size_t hn = GetVarint(in, head);
+    uint64_t nb = head >> 1;
+    bool bNeg = head & 1;
+    if (nb > in.size() - hn)
+        throw std::invalid_argument("truncated BigInt encoding");
+    const std::byte* p = in.data() + hn;
+    // leading zero byte, or negative zero.
+    if (nb ? p[nb - 1] == std::byte{0} : bNeg)
+        throw std::invalid_argument("non-canonical BigInt encoding");
+    BigInt r;
+    r.SetMagBytes_(p, nb, bNeg);
+    if (used)
+        *used = hn + nb;
+    return r;
+}
+
+size_t BigInt::EncodedSize(std::span<const BigInt> v)
+{
+    size_t n = VarintSize(v.size());
+    for (const BigInt& x : v)
+        n += x.EncodedSize();
+    return n;
+}
+
+size_t BigInt::EncodeAll(std::span<const BigInt> v, std::span<std::byte> out)
+{
+    size_t n = VarintSize(v.size());
+    if (out.size() < n)
+        throw std::length_error("buffer too small for BigInt encoding");
+    PutVarint(out.data(), v.size());
+    for (const BigInt& x : v)
+        n += x.Encode(out.subspan(n));
+    return n;
+}
+
+size_t BigInt::DecodeAll(std::span<const std::byte> in, std::vector<BigInt>& out)
+{
+    uint64_t cnt;
+    size_t n = GetVarint(in, cnt);
+    // each value takes one byte at least, so broken count can not reserve too much.
+    if (cnt > in.size() - n)
+        throw std::invalid_argument("truncated BigInt encoding");
+    out.reserve(out.size() + cnt);
+    for (uint64_t i=0; i<cnt; i++) {
+        size_t used;
+        out.push_back(Decode(in.subspan(n), &used));
+        n += used;
+    }
+    return n;
+}
+
+
+//-------------------------------------
+// streaming parser
+
+BigIntParser::BigIntParser(const BigInt::allocator_type& alloc):
+    m_alloc(alloc)
+{
+}
+
+size_t BigIntParser::Feed(std::string_view chunk)
+{
+    size_t k = 0;
+    for (; k < chunk.size() && m_state != kStopped; k++) {
+        char c = chunk[k];
+        if (m_state == kStart && (c == '-' || c == '+')) {
+            m_neg = c == '-';
+            m_state = kSign;
+            continue;
+        }
+        if (m_state == kDigit && c == '_') {
+            m_state = kUnderscore;
+            continue;
+        }
+        if (!InRange<char>(c, '0', '9')) {
+            // '_' of this chunk is given back. one of previous chunk is already taken.
+            if (m_state == kUnderscore && k > 0)
+                k--;
+            m_state = kStopped;
+            break;
+        }
+        m_state = kDigit;
+        m_buf.push_back(c);
+        m_digits++;
+        if ((int)m_buf.size() == kBlock) {
+            PushBlock(BigInt(m_buf, m_alloc), kBlock);
+            m_buf.clear();
+        }
+    }
+    return k;
+}
+
+/*
+    merge with the top while it has same number of digits.
+    so stack has at most log2(blocks) entries, with decreasing sizes.
+*/
+void BigIntParser::PushBlock(BigInt value, long long digits)
+{
+    for (int k=0; !m_stack.empty() && m_stack.back().digits == digits; k++) {
+        BigInt hi = std::move(m_stack.back().value);
+        m_stack.pop_back();
+        hi *= BlockPow10(k);
+        hi += value;
+        value = std::move(hi);
+        digits *= 2;
+    }
+    m_stack.push_back({ std::move(value), digits });
+}
+
+const BigInt& BigIntParser::BlockPow10(int k)
+{
+    if (m_pow.empty())
+        m_pow.push_back(BigInt::Pow(BigInt(10, m_alloc), kBlock));
+    while ((int)m_pow.size() <= k)
+        m_pow.push_back(m_pow.back() * m_pow.back());
+    return m_pow[k];
+}
+
+BigInt BigIntParser::Finish()
+{
+    BigInt r(m_alloc);
+    if (m_stack.empty())
+        r = BigInt(m_buf, m_alloc);
+    else {
+        // fold from the most significant one: r = r * 10^digits(next) + next
+        r = std::move(m_stack[0].value);
+        for (size_t i=1; i<m_stack.size(); i++) {
+            r *= BlockPow10(std::countr_zero((unsigned long long)(m_stack[i].digits / kBlock)));
+            r += m_stack[i].value;
+        }
+        if (!m_buf.empty()) {
+            r *= BigInt::Pow(BigInt(10, m_alloc), (long long)m_buf.size());
+            r += BigInt(m_buf, m_alloc);
+        }
+    }
+    if (m_neg)
+        r = -r;
+    m_state = kStart;
+    m_neg = false;
+    m_digits = 0;
+    m_buf.clear();
+    m_stack.clear();
+    return r;
+}
+
+/*
+    chars are extracted by sbumpc() only after they are accepted.
+    '_' is accepted before the next char is known, so it is put back if not followed by digit.
+*/
+std::istream& operator>>(std::istream& is, BigInt& a)
+{
+    std::istream::sentry guard(is);
+    if (!guard)
+        return is;
+    std::streambuf* sb = is.rdbuf();
+    BigIntParser p(a.get_allocator());
+    std::ios_base::iostate st = std::ios_base::goodbit;
+    for (;;) {
+        int c = sb->sgetc();
+        if (c == std::char_traits<char>::eof()) {
+            st |= std::ios_base::eofbit;
+            break;
+        }
+        char ch = (char)c;
+        if (p.Feed(std::string_view(&ch, 1)) == 0)
+            break;
+        sb->sbumpc();
+        if (ch == '_') {
+            c = sb->sgetc();
+            if (c == std::char_traits<char>::eof() || !InRange<char>((char)c, '0', '9')) {
+                sb->sungetc();
+                break;
+            }
+        }
+    }
+    if (p.Digits() == 0)
+        st |= std::ios_base::failbit;
+    a = p.Finish();
+    is.setstate(st);
+    return is;
+}
+
+
+//-------------------------------------
+// ModContext
+
+ModContext::ModContext(const BigInt& mod):
+    m_mod(mod), m_abs(mod.Abs())
+{
+    if (mod.IsZero())
+        throw std::domain_error("pow() 3rd argument cannot be 0");
+    m_ctx = mpn::ModCtx(m_abs.m_limbs.data(), m_abs.Size());
+}
+
+/*
+    base is reduced to [0, |mod|) first, then mpn::PowMod().
+    result is moved into (mod, 0] if mod is negative.
+*/
+BigInt ModContext::Pow(const BigInt& base, const BigInt& exp, bool bConstTime) const
+{
+    if (exp.m_sign)
+        return Pow(BigInt::ModInverse(base, m_abs), -exp, bConstTime);
+    BigInt res(base.get_allocator());
+    if (m_abs.Size() == 1 && m_abs.m_limbs[0] == 1)
+        return res;
+
+    BigInt b(base.get_allocator());
+    BigInt::DivMod(base, m_abs, nullptr, &b);
+    int n = m_ctx.Size();
+    res.m_limbs.resize(n);
+    mpn::PowMod(res.m_limbs.data(), b.m_limbs.data(), b.Size(),
+        exp.m_limbs.data(), exp.Size(), m_ctx, bConstTime);
+    res.Normalize_();
+    if (m_mod.m_sign && !res.IsZero())
+        res.Add_(m_mod);
+    return res;
+} // ModContext::Pow
+
+
+//-------------------------------------
+/*
+    comparison operator
+*/
+
+/*
+    compare magnitude only between this->limbs and rhs.
+    both are normalized, so that limb counts are exact, and mpn::Cmp() starts
+    from the top limb without scan.
+*/
+int BigInt::CompareMag(const LimbBuf& rhs) const
+{
+    return mpn::Cmp(m_limbs.data(), (int)m_limbs.size(), rhs.data(), (int)rhs.size());
+}
+
+bool BigInt::EqualMag(const LimbBuf& rhs) const
+{
+    return m_limbs.size() == rhs.size() &&
+        std::memcmp(m_limbs.data(), rhs.data(), m_limbs.size() * sizeof(Limb)) == 0;
+}
+
+/*
+    three-way comparison with native magnitude and sign, without temporary.
+    magnitude is put into limbs on stack.
+*/
+int BigInt::CompareNative(unsigned long long mag, bool bNeg) const
+{
+    return CompareLimbsNative(m_limbs.data(), IsZero() ? 0 : Size(), m_sign, mag, bNeg);
+}
 
-    return std::memcmp(&m_digits[0], &rhs[0], width1) == 0;
+int BigInt::CompareLimbsNative(const Limb* a, int n, bool aNeg, unsigned long long mag, bool bNeg)
+{
+    if (mag == 0)
+        bNeg = false;
+    if (aNeg != bNeg)
+        return aNeg ? -1 : 1;
+    Limb w[kU64Limbs];
+    int wn = U64ToLimbArray(w, mag);
+    int c = mpn::Cmp(a, n, w, wn);
+    return aNeg ? -c : c;
 }
 
 
 /*
-    if (*this < rhs) return true
+    negative one has reversed order of magnitude.
+    ex: -5 < -3, since 5 > 3
 */
+int BigInt::Compare(const BigInt& rhs) const
+{
+    if (m_sign != rhs.m_sign)
+        return m_sign ? -1 : 1;
+    int c = CompareMag(rhs.m_limbs);
+    return m_sign ? -c : c;
+}
+
 bool BigInt::Less(const BigInt& rhs) const
 {
-    if (!m_sign && !rhs.m_sign) // both positive
-        return LessMag(rhs.m_digits);
-    else if (m_sign && rhs.m_sign) // both negative
-        // ex: -5 <? -3  => 3 <? 5 => true
-        //     -4 <? -4  => 4 <? 4 => false
-        return rhs.LessMag(m_digits);
-    else // different sign
-        return m_sign;
+    return Compare(rhs) < 0;
 }
 
 bool BigInt::Equal(const BigInt& rhs) const
 {
-    return m_sign == rhs.m_sign && EqualMag(rhs.m_digits);
+    return m_sign == rhs.m_sign && EqualMag(rhs.m_limbs);
 }
 
 
 //-------------------------------------
 // conversion
 
+/*
+    accumulate limbs from the top. no overflow check.
+*/
+long long BigInt::ToLongLong() const
+{
+    unsigned long long mag = LimbsToU64(m_limbs, Size());
+    return m_sign ? (long long)(0ULL - mag) : (long long)mag;
+}
+
+namespace {
+
+// magnitude of a[0..n) into mag, if it fits in 64 bits.
+bool LimbsToMag64(const mpn::Limb* a, int n, unsigned long long& mag)
+{
+    if (n > kU64Limbs)
+        return false;
+    mag = 0;
+    for (int k=n-1; k>=0; k--) {
+        if (mag > (ULLONG_MAX - a[k]) / mpn::kBase)
+            return false;
+        mag = mag * mpn::kBase + a[k];
+    }
+    return true;
+}
+
+} // namespace
+
+bool BigInt::GetMag64(unsigned long long& mag) const
+{
+    return LimbsToMag64(m_limbs.data(), Size(), mag);
+}
+
+namespace {
+
+/*
+    q * 2^shift as double, rounded half to even, where q < 2^64.
+    inexact means that true value is a little more than q * 2^shift.
+    bits below precision of double (53, or less for subnormal) are rounded off
+    in integer first, so that conversion of q and ldexp are exact.
+    q is shifted down before rounding, so that q+1 can not wrap around.
+*/
+double RoundToDouble(uint64_t q, long long shift, bool inexact, bool bNeg, const char* msg)
+{
+    const int qbits = (int)std::bit_width(q);
+    const long long extra = std::max<long long>(qbits, DBL_MIN_EXP - shift) - DBL_MANT_DIG;
+    if (extra > 63) {
+        q = 0; // far below smallest subnormal
+    }
+    else if (extra > 0) {
+        const uint64_t half = 1ULL << (extra - 1);
+        const bool sticky = inexact || (q & (half - 1));
+        const bool round = q & half;
+        q >>= extra;
+        shift += extra;
+        // round bit, and either sticky bits or lowest kept bit (for tie)
+        if (round && (sticky || (q & 1)))
+            q++;
+    }
+    if (q && (int)std::bit_width(q) + shift > DBL_MAX_EXP)
+        throw std::overflow_error(msg);
+    double d = std::ldexp((double)q, (int)shift);
+    return bNeg ? -d : d;
+}
+
+// magnitude of words w[0..n) as double. w[n-1] != 0, if n > 0.
+double WordsToDouble(const uint32_t* w, int n, bool bNeg)
+{
+    const char* msg = "int too large to convert to float";
+    if (n == 0)
+        return 0.0;
+    long long bits = 32LL * (n - 1) + std::bit_width(w[n - 1]);
+    if (bits > DBL_MAX_EXP)
+        throw std::overflow_error(msg);
+    if (n <= 2) {
+        uint64_t v = w[0] | (n > 1 ? (uint64_t)w[1] << 32 : 0);
+        return RoundToDouble(v, 0, false, bNeg, msg);
+    }
+    // top 64 bits, from top 3 words.
+    long long s = bits - 64;
+    int i = int(s / 32), off = int(s % 32);
+    uint64_t q = w[i] | (uint64_t)w[i + 1] << 32;
+    if (off)
+        q = q >> off | (i + 2 < n ? (uint64_t)w[i + 2] << (64 - off) : 0);
+    // bits below them matter only for exact tie of 53 bits.
+    bool inexact = false;
+    if ((q & 0x7FF) == 0x400) {
+        inexact = off && (w[i] & ((1u << off) - 1));
+        for (int k=0; k<i && !inexact; k++)
+            inexact = w[k] != 0;
+    }
+    return RoundToDouble(q, s, inexact, bNeg, msg);
+}
+
+} // namespace
+
+/*
+    binary limbs are words already.
+    decimal limbs are converted to words first. (O(n^2))
+*/
+double BigInt::ToDouble() const
+{
+    int n = Size();
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    unsigned long long mag;
+    if (GetMag64(mag)) {
+        uint32_t w[2] = { uint32_t(mag), uint32_t(mag >> 32) };
+        return WordsToDouble(w, w[1] ? 2 : w[0] ? 1 : 0, m_sign);
+    }
+    WordVec w = ToWords(m_limbs, n);
+    return WordsToDouble(w.data(), (int)w.size(), m_sign);
+#else
+    return WordsToDouble(m_limbs.data(), IsZero() ? 0 : n, m_sign);
+#endif
+}
+
+/*
+    same as python long_true_divide().
+    if both fit in 53 bits, native division is correctly rounded already.
+    otherwise a is scaled so that integer quotient q has 55 or 56 bits,
+    (or less, for subnormal result) and remainder tells if it is inexact:
+        q = floor(|a| * 2^-shift / |b|), result = q * 2^shift
+*/
+double BigInt::TrueDiv(const BigInt& a, const BigInt& b)
+{
+    if (b.IsZero())
+        throw std::domain_error("division by zero");
+    const char* msg = "integer division result too large for a float";
+    const bool bNeg = a.m_sign != b.m_sign;
+    if (a.IsZero())
+        return bNeg ? -0.0 : 0.0;
+
+    unsigned long long am, bm;
+    if (a.GetMag64(am) && b.GetMag64(bm) && am <= (1ULL << DBL_MANT_DIG) && bm <= (1ULL << DBL_MANT_DIG)) {
+        double d = (double)am / (double)bm;
+        return bNeg ? -d : d;
+    }
+
+    long long diff = a.BitLength() - b.BitLength();
+    if (diff > DBL_MAX_EXP)
+        throw std::overflow_error(msg);
+    if (diff < DBL_MIN_EXP - DBL_MANT_DIG - 1)
+        return bNeg ? -0.0 : 0.0; // underflow
+
+    long long shift = std::max<long long>(diff, DBL_MIN_EXP) - DBL_MANT_DIG - 2;
+    BigInt x = a.Abs(), y = b.Abs(), q, r;
+    // floor(floor(x / 2^shift) / y) == floor(x / (y * 2^shift))
+    if (shift > 0)
+        y.ShiftLeft_(shift);
+    else
+        x.ShiftLeft_(-shift);
+    DivMod(x, y, &q, &r);
+    unsigned long long qm = 0;
+    q.GetMag64(qm); // q < 2^57
+    return RoundToDouble(qm, shift, !r.IsZero(), bNeg, msg);
+}
+
+
+//-------------------------------------
+// hash
+
+namespace {
+
+// xxh64 primes and round. 64-bit multiply only, no 128-bit product.
+constexpr uint64_t kP1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kP2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kP3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kP4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kP5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t HashRound(uint64_t acc, uint64_t w)
+{
+    return std::rotl(acc + w * kP2, 31) * kP1;
+}
+
+inline uint64_t HashLoad(const unsigned char* p)
+{
+    uint64_t w;
+    std::memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+/*
+    xxh64 over bytes p[0..len), with 32-byte stripes in 4 independent lanes.
+    it is not bit-exact to xxh64. it only has to be fast and well mixed in one process.
+*/
+uint64_t HashBytes(const unsigned char* p, size_t len, uint64_t seed)
+{
+    const unsigned char* end = p + len;
+    uint64_t h;
+    if (len >= 32) {
+        uint64_t v[4] = { seed + kP1 + kP2, seed + kP2, seed, seed - kP1 };
+        for (; p + 32 <= end; p += 32) {
+            for (int i=0; i<4; i++)
+                v[i] = HashRound(v[i], HashLoad(p + 8 * i));
+        }
+        h = std::rotl(v[0], 1) + std::rotl(v[1], 7) + std::rotl(v[2], 12) + std::rotl(v[3], 18);
+        for (int i=0; i<4; i++)
+            h = (h ^ HashRound(0, v[i])) * kP1 + kP4;
+    }
+    else
+        h = seed + kP5;
+    h += len;
+    for (; p + 8 <= end; p += 8)
+        h = std::rotl(h ^ HashRound(0, HashLoad(p)), 27) * kP1 + kP4;
+    for (; p < end; p++)
+        h = std::rotl(h ^ (*p * kP5), 11) * kP1;
+    // avalanche
+    h ^= h >> 33;
+    h *= kP2;
+    h ^= h >> 29;
+    h *= kP3;
+    h ^= h >> 32;
+    return h;
+}
+
+} // namespace
+
+/*
+    values in range of long long are hashed as native one, like python int hash.
+    others are hashed over normalized limbs. limbs differ between representations,
+    so hash of big value differs between binary and decimal digit builds.
+*/
+size_t BigInt::HashLimbs(const Limb* a, int n, bool bNeg) noexcept
+{
+    unsigned long long mag;
+    if (LimbsToMag64(a, n, mag) && (bNeg ? mag - 1 : mag) <= (unsigned long long)LLONG_MAX)
+        return std::hash<long long>{}(bNeg ? (long long)(0ULL - mag) : (long long)mag);
+    return (size_t)HashBytes((const unsigned char*)a, (size_t)n * sizeof(Limb), bNeg ? kP3 : 0);
+}
+
+size_t BigInt::Hash() const noexcept
+{
+    return HashLimbs(m_limbs.data(), IsZero() ? 0 : Size(), m_sign);
+}
 
 
 //-------------------------------------
@@ -734,8 +3094,8 @@ bool BigInt::Equal(const BigInt& rhs) const
 */
 void BigInt::Extend_(int capacity)
 {
-    if (Capacity() < capacity) {
-        m_digits.resize(capacity, 0);
+    if ((int)m_limbs.size() < capacity) {
+        m_limbs.resize(capacity, 0);
     }
 }
 
@@ -745,39 +3105,270 @@ void BigInt::Extend_(int capacity)
 */
 BigInt& BigInt::Normalize_()
 {
-    m_digits.resize(Width());
+    m_limbs.resize(Size());
 
-    if (m_sign && m_digits.size() == 1 && m_digits[0] == 0)
+    if (m_sign && m_limbs.size() == 1 && m_limbs[0] == 0)
         m_sign = false;
     return *this;
 }
 
 
+//-------------------------------------
+// formatting
+
+namespace {
+
+// digits of power of 2 base from binary words. exactly nd digits, most significant first.
+void WordsToDigits(char* s, int nd, const uint32_t* w, int nw, int bits, bool bUpper)
+{
+    const char* chars = bUpper ? "0123456789ABCDEF" : "0123456789abcdef";
+    const uint32_t mask = (1u << bits) - 1;
+    for (int i=0; i<nd; i++) {
+        long long pos = (long long)i * bits;
+        int k = (int)(pos / 32), sh = (int)(pos % 32);
+        uint32_t v = 0;
+        if (k < nw) {
+            v = w[k] >> sh;
+            if (sh + bits > 32 && k + 1 < nw)
+                v |= w[k+1] << (32 - sh);
+        }
+        s[nd-1-i] = chars[v & mask];
+    }
+}
+
+} // namespace
+
+size_t BigInt::FormattedSize(const FormatSpec& spec) const
+{
+    int bits = spec.Bits();
+    long long d = bits ? std::max(1LL, (BitLength() + bits - 1) / bits) : mpn::DigitsForLimbs(Size());
+    long long g = spec.group ? (bits ? 4 : 3) : LLONG_MAX;
+    long long dm = std::max(d, (long long)spec.width);
+    // sign and prefix, zero padding, separators, then raw digits. see FormatTo()
+    return (size_t)(3 + spec.width + (dm - 1) / g + d);
+}
+
+/*
+    raw digits are made at the end of buffer, and separators are put while they are
+    moved to the front. (destination never passes source)
+    then body is moved to its place by alignment, and fill, sign and prefix are written.
+*/
+BigInt::FormatParts BigInt::Layout(char* buf, const FormatSpec& spec) const
+{
+    const int bits = spec.Bits();
+    const size_t cap = FormattedSize(spec);
+    const long long g = spec.group ? (bits ? 4 : 3) : LLONG_MAX;
+
+    // raw digits at [beg, beg + len)
+    char* beg;
+    long long len;
+    if (bits) {
+        len = std::max(1LL, (BitLength() + bits - 1) / bits);
+        beg = buf + cap - len;
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+        WordVec w = ToWords(m_limbs, Size());
+        WordsToDigits(beg, (int)len, w.data(), (int)w.size(), bits, spec.type == 'X');
+#else
+        WordsToDigits(beg, (int)len, m_limbs.data(), IsZero() ? 0 : Size(), bits, spec.type == 'X');
+#endif
+    }
+    else {
+        int w = Size();
+        beg = buf + cap - mpn::DigitsForLimbs(w);
+        len = mpn::GetStr(beg, m_limbs.data(), w);
+    }
+
+    // sign and prefix
+    FormatParts parts;
+    char* pre = parts.prefix;
+    int pl = 0;
+    if (m_sign)
+        pre[pl++] = '-';
+    else if (spec.sign != '-')
+        pre[pl++] = spec.sign;
+    if (spec.alt && bits) {
+        pre[pl++] = '0';
+        pre[pl++] = spec.type == 'b' ? 'b' : spec.type == 'o' ? 'o' : spec.type;
+    }
+    parts.prefixLen = pl;
+
+    // zero padding is grouped, like python. "{:010,}" -> 00,001,234
+    if (spec.align == '=' && spec.fill == '0' && spec.group) {
+        long long need = spec.width - pl, n = len;
+        while (n + (n - 1) / g < need)
+            n++;
+        std::memset(beg - (n - len), '0', n - len);
+        beg -= n - len;
+        len = n;
+    }
+
+    // separators, moving digits to front
+    long long nsep = (len - 1) / g;
+    char* body = beg - nsep;
+    if (nsep > 0) {
+        // first group may be short. others are g digits each.
+        long long first = len - nsep * g;
+        std::memmove(body, beg, first);
+        char* d = body + first;
+        for (const char* src = beg + first; src < beg + len; src += g) {
+            *d++ = spec.group;
+            std::memmove(d, src, g);
+            d += g;
+        }
+    }
+    long long bl = len + nsep;
+
+    // alignment. number is right aligned by default.
+    long long pad = std::max(0LL, spec.width - (pl + bl));
+    long long left = 0, mid = 0;
+    switch (spec.align) {
+    case '<': break;
+    case '^': left = pad / 2; break;
+    case '=': mid = pad; break;
+    default: left = pad; break;
+    }
+    parts.left = left;
+    parts.mid = mid;
+    parts.right = pad - left - mid;
+    parts.body = body;
+    parts.bodyLen = bl;
+    return parts;
+}
+
+// body is moved to its place, then fill and prefix are written around it.
+size_t BigInt::FormatTo(char* buf, const FormatSpec& spec) const
+{
+    FormatParts p = Layout(buf, spec);
+    char* out = buf + p.left + p.prefixLen + p.mid;
+    std::memmove(out, p.body, p.bodyLen);
+    std::memset(buf, spec.fill, p.left);
+    std::memcpy(buf + p.left, p.prefix, p.prefixLen);
+    std::memset(buf + p.left + p.prefixLen, spec.fill, p.mid);
+    std::memset(out + p.bodyLen, spec.fill, p.right);
+    return p.Size();
+}
+
+namespace {
+
+struct FormatScratch {
+    std::string buf;
+    bool busy = false;
+};
+thread_local FormatScratch t_formatScratch;
+
+// fill chars to stream buffer, by block. returns false if it is short.
+bool PutFill(std::streambuf* sb, char fill, long long n)
+{
+    char block[64];
+    std::memset(block, fill, sizeof(block));
+    while (n > 0) {
+        std::streamsize k = (std::streamsize)std::min<long long>(n, sizeof(block));
+        if (sb->sputn(block, k) != k)
+            return false;
+        n -= k;
+    }
+    return true;
+}
+
+} // namespace
+
+BigInt::FormatBuffer::FormatBuffer(size_t n)
+{
+    FormatScratch& t = t_formatScratch;
+    if (!t.busy && n <= kKeep) {
+        if (t.buf.size() < n)
+            t.buf.resize(std::max(n, (size_t)256));
+        t.busy = true;
+        m_local = true;
+        m_p = t.buf.data();
+    }
+    else {
+        m_heap.resize(n);
+        m_p = m_heap.data();
+    }
+}
+
+BigInt::FormatBuffer::~FormatBuffer()
+{
+    if (m_local)
+        t_formatScratch.busy = false;
+}
+
+std::string BigInt::Format(std::string_view spec) const
+{
+    FormatSpec fs;
+    if (const char* err = FormatSpec::Parse(spec, fs))
+        throw std::invalid_argument(err);
+    string res(FormattedSize(fs), ' ');
+    res.resize(FormatTo(res.data(), fs));
+    return res;
+}
+
+std::ostream& operator<<(std::ostream& os, const BigInt& a)
+{
+    std::ostream::sentry guard(os);
+    if (!guard)
+        return os;
+    auto f = os.flags();
+    BigInt::FormatSpec spec;
+    spec.fill = os.fill();
+    spec.width = (int)std::max<std::streamsize>(0, std::min<std::streamsize>(os.width(), INT_MAX));
+    spec.align = (f & std::ios_base::left) ? '<' : (f & std::ios_base::internal) ? '=' : '>';
+    spec.sign = (f & std::ios_base::showpos) ? '+' : '-';
+    spec.alt = (f & std::ios_base::showbase) != 0;
+    if (f & std::ios_base::hex)
+        spec.type = (f & std::ios_base::uppercase) ? 'X' : 'x';
+    else if (f & std::ios_base::oct)
+        spec.type = 'o';
+    os.width(0);
+
+    // pieces are written to stream buffer as they are. digits are made in buffer of this thread.
+    BigInt::FormatBuffer work(a.FormattedSize(spec));
+    BigInt::FormatParts p = a.Layout(work.data(), spec);
+    std::streambuf* sb = os.rdbuf();
+    bool bOk = PutFill(sb, spec.fill, p.left) &&
+        sb->sputn(p.prefix, p.prefixLen) == p.prefixLen &&
+        PutFill(sb, spec.fill, p.mid) &&
+        sb->sputn(p.body, (std::streamsize)p.bodyLen) == (std::streamsize)p.bodyLen &&
+        PutFill(sb, spec.fill, p.right);
+    if (!bOk)
+        os.setstate(std::ios_base::badbit);
+    return os;
+}
+
+
 //-------------------------------------
 // debugging
 
 /*
-    opts: TODO
+    decimal string, with '-' sign for negative number.
+    divide-and-conquer above PYCFG_BIGINT_STR_DC_CUTOFF. see mpn::GetStr()
+    opts is python format spec. see Format()
 */
 std::string BigInt::ToStr(cstring opts) const
 {
-    int w = Width();
-    std::vector<char> buf(w);
-    auto& v = m_digits;
-    for (int k=0; k<w; k++) {
-        buf[k] = m_digits[w-k-1] + '0';
-    }
-    return &buf[0];
+    if (!opts.empty())
+        return Format(opts);
+    int w = Size();
+    int sign = m_sign ? 1 : 0;
+    string res(sign + mpn::DigitsForLimbs(w), '-');
+    int len = mpn::GetStr(&res[sign], m_limbs.data(), w);
+    res.resize(sign + len);
+    return res;
 }
 
 std::string BigInt::Describe() const
 {
     string res = ToStr();
-    res += ", width:" + std::to_string(Width());
-    res += ", capacity:" + std::to_string(Capacity());
+    res += ", width:";
+    res += std::to_string(Width());
+    res += ", capacity:";
+    res += std::to_string(Capacity());
     res += ", ";
-    for (int k=0; k<(int)m_digits.size(); k++) {
-        res += (k>0?" ":"") + std::to_string(m_digits[k]);
+    for (int k=0; k<(int)m_limbs.size(); k++) {
+        if (k > 0)
+            res += ' ';
+        res += std::to_string(m_limbs[k]);
     }
     if (m_sign)
         res += ", negative";
@@ -792,4 +3383,3 @@ std::string BigInt::Describe() const
 }; // namespace com::cafrii::pyc
 
 #endif // __PYC_LIB_IMPLEMENTATION
-
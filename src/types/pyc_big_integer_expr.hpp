@@ -0,0 +1,250 @@
+/*
+    pyc_big_integer_expr.hpp
+
+    pythonic cpp library
+    lazy expression of big integer
+
+    Author: yhlee
+    Copyright © 2025
+*/
+
+//============================================================================
+
+#pragma once
+
+#ifndef __cplusplus
+#error this header file is for c++
+#endif
+
+//============================================================================
+
+
+#include <type_traits>
+#include <utility>
+
+#include "pyc_big_integer.hpp"
+
+
+//============================================================================
+// namespace
+namespace com::cafrii::pyc {
+
+//============================================================================
+
+/*
+    opt-in expression template of BigInt.
+
+    eager operator chain like 'x = a + b - c' makes a temporary per operator,
+    and each of them is normalized (and maybe allocated) separately.
+    with lazy(), the chain is captured as a tree of light nodes, and
+    evaluated into destination at assignment, in one carry pass:
+
+        x = lazy(a) + b - c;      // single mpn::SumN(), no temporary
+        x += lazy(b) - c;         // x itself is one of terms
+        x = lazy(a) * b + c;      // product is made in temp, then summed
+
+    destination may be one of operands. all operands are read before write.
+
+    nodes keep references to operands, so expression must be evaluated
+    in the same full-expression. do not keep it in 'auto' variable.
+        auto e = lazy(a) + BigInt(1);   // dangling!
+*/
+
+template <typename E>
+class BigIntExpr
+{
+public:
+    const E& Self() const { return static_cast<const E&>(*this); }
+
+    // evaluate expression into dst. dst is written after all terms are read.
+    void EvalTo(BigInt& dst) const
+    {
+        const BigInt* xs[E::kTerms];
+        bool negs[E::kTerms];
+        BigInt temps[E::kTemps > 0 ? E::kTemps : 1];
+        int m = 0, nt = 0;
+        Self().Collect(xs, negs, m, false, temps, nt);
+
+        if (m == 1 && nt == 1 && xs[0] == &temps[0]) {
+            // single product. take it without copy.
+            dst = std::move(temps[0]);
+            if (negs[0]) dst.Inv_();
+            return;
+        }
+        dst.AssignSum_(xs, negs, m);
+    }
+};
+
+/*
+    leaf node. refers to an operand.
+*/
+class BigIntLeaf: public BigIntExpr<BigIntLeaf>
+{
+public:
+    static constexpr int kTerms = 1;
+    static constexpr int kTemps = 0;
+
+    explicit BigIntLeaf(const BigInt& x): m_x(x) {}
+
+    void Collect(const BigInt** xs, bool* negs, int& m, bool neg,
+            BigInt*, int&) const {
+        xs[m] = &m_x; negs[m] = neg; m++;
+    }
+    const BigInt& m_x;
+};
+
+// start of lazy expression.
+inline BigIntLeaf lazy(const BigInt& x) { return BigIntLeaf(x); }
+
+/*
+    l + r, or l - r if bSub.
+    terms of both sides are flattened into one sum.
+*/
+template <typename L, typename R, bool bSub>
+class SumExpr: public BigIntExpr<SumExpr<L, R, bSub>>
+{
+public:
+    static constexpr int kTerms = L::kTerms + R::kTerms;
+    static constexpr int kTemps = L::kTemps + R::kTemps;
+
+    SumExpr(const L& l, const R& r): m_l(l), m_r(r) {}
+
+    void Collect(const BigInt** xs, bool* negs, int& m, bool neg,
+            BigInt* temps, int& nt) const {
+        m_l.Collect(xs, negs, m, neg, temps, nt);
+        m_r.Collect(xs, negs, m, neg != bSub, temps, nt);
+    }
+    L m_l;
+    R m_r;
+};
+
+/*
+    -e. only flips sign of terms.
+*/
+template <typename E>
+class NegExpr: public BigIntExpr<NegExpr<E>>
+{
+public:
+    static constexpr int kTerms = E::kTerms;
+    static constexpr int kTemps = E::kTemps;
+
+    explicit NegExpr(const E& e): m_e(e) {}
+
+    void Collect(const BigInt** xs, bool* negs, int& m, bool neg,
+            BigInt* temps, int& nt) const {
+        m_e.Collect(xs, negs, m, !neg, temps, nt);
+    }
+    E m_e;
+};
+
+/*
+    l * r. product can not be fused into the sum,
+    so it is calculated into a temp, which becomes a single term.
+    non-leaf operand is evaluated first.
+*/
+template <typename L, typename R>
+class MulExpr: public BigIntExpr<MulExpr<L, R>>
+{
+public:
+    static constexpr int kTerms = 1;
+    static constexpr int kTemps = 1;
+
+    MulExpr(const L& l, const R& r): m_l(l), m_r(r) {}
+
+    void Collect(const BigInt** xs, bool* negs, int& m, bool neg,
+            BigInt* temps, int& nt) const {
+        BigInt& p = temps[nt++];
+        if constexpr (std::is_same_v<L, BigIntLeaf>)
+            p = m_l.m_x;
+        else
+            m_l.EvalTo(p);
+        if constexpr (std::is_same_v<R, BigIntLeaf>)
+            p *= m_r.m_x;
+        else
+            p *= BigInt(m_r);
+        xs[m] = &p; negs[m] = neg; m++;
+    }
+    L m_l;
+    R m_r;
+};
+
+
+//-------------------------------------
+// operators. at least one side should be lazy expression.
+
+template <typename L, typename R>
+inline SumExpr<L, R, false> operator+(const BigIntExpr<L>& l, const BigIntExpr<R>& r) {
+    return { l.Self(), r.Self() };
+}
+template <typename L>
+inline SumExpr<L, BigIntLeaf, false> operator+(const BigIntExpr<L>& l, const BigInt& r) {
+    return { l.Self(), BigIntLeaf(r) };
+}
+template <typename R>
+inline SumExpr<BigIntLeaf, R, false> operator+(const BigInt& l, const BigIntExpr<R>& r) {
+    return { BigIntLeaf(l), r.Self() };
+}
+
+template <typename L, typename R>
+inline SumExpr<L, R, true> operator-(const BigIntExpr<L>& l, const BigIntExpr<R>& r) {
+    return { l.Self(), r.Self() };
+}
+template <typename L>
+inline SumExpr<L, BigIntLeaf, true> operator-(const BigIntExpr<L>& l, const BigInt& r) {
+    return { l.Self(), BigIntLeaf(r) };
+}
+template <typename R>
+inline SumExpr<BigIntLeaf, R, true> operator-(const BigInt& l, const BigIntExpr<R>& r) {
+    return { BigIntLeaf(l), r.Self() };
+}
+
+template <typename L, typename R>
+inline MulExpr<L, R> operator*(const BigIntExpr<L>& l, const BigIntExpr<R>& r) {
+    return { l.Self(), r.Self() };
+}
+template <typename L>
+inline MulExpr<L, BigIntLeaf> operator*(const BigIntExpr<L>& l, const BigInt& r) {
+    return { l.Self(), BigIntLeaf(r) };
+}
+template <typename R>
+inline MulExpr<BigIntLeaf, R> operator*(const BigInt& l, const BigIntExpr<R>& r) {
+    return { BigIntLeaf(l), r.Self() };
+}
+
+template <typename E>
+inline NegExpr<E> operator-(const BigIntExpr<E>& e) {
+    return NegExpr<E>(e.Self());
+}
+
+
+//-------------------------------------
+// BigInt members which accept lazy expression
+
+template <typename E>
+BigInt::BigInt(const BigIntExpr<E>& expr, const allocator_type& alloc): BigInt(alloc)
+{
+    expr.EvalTo(*this);
+}
+
+template <typename E>
+BigInt& BigInt::operator=(const BigIntExpr<E>& expr)
+{
+    expr.EvalTo(*this);
+    return *this;
+}
+
+template <typename E>
+BigInt& BigInt::operator+=(const BigIntExpr<E>& rhs)
+{
+    return *this = lazy(*this) + rhs;
+}
+
+template <typename E>
+BigInt& BigInt::operator-=(const BigIntExpr<E>& rhs)
+{
+    return *this = lazy(*this) - rhs;
+}
+
+
+//============================================================================
+}; // namespace com::cafrii::pyc
@@ -0,0 +1,3616 @@
+/*
+    pyc_big_integer_kernel.hpp
+
+    pythonic cpp library
+    low-level limb array kernels for big integer class
+
+    Author: yhlee
+    Copyright © 2025
+*/
+
+//============================================================================
+
+#pragma once
+
+#ifndef __cplusplus
+#error this header file is for c++
+#endif
+
+//============================================================================
+
+
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <initializer_list>
+#include <memory>
+#include <memory_resource>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <numeric> // gcd
+#include <functional>
+#include <thread>
+#include <condition_variable>
+#include <exception>
+#include <bit>
+#include <cmath>
+#include <climits>
+
+
+
+
+//============================================================================
+// configs
+
+
+// if defined, BigInt stores one decimal digit per byte (legacy representation).
+// otherwise, magnitude is stored as base 2^32 limbs.
+// it is kept mainly to benchmark two representations against each other.
+// #define PYCFG_BIGINT_DECIMAL_DIGIT
+
+
+// cutoffs between multiplication algorithms. (unit: limbs)
+// below KARATSUBA cutoff, O(n^2) schoolbook method is used.
+// they can be overridden by compiler option to tune for each host.
+#ifndef PYCFG_BIGINT_MUL_KARATSUBA_CUTOFF
+#define PYCFG_BIGINT_MUL_KARATSUBA_CUTOFF 40
+#endif
+#ifndef PYCFG_BIGINT_MUL_TOOM3_CUTOFF
+#define PYCFG_BIGINT_MUL_TOOM3_CUTOFF 256
+#endif
+#ifndef PYCFG_BIGINT_MUL_NTT_CUTOFF
+#define PYCFG_BIGINT_MUL_NTT_CUTOFF 4000
+#endif
+
+// same as above, for squaring.
+#ifndef PYCFG_BIGINT_SQR_KARATSUBA_CUTOFF
+#define PYCFG_BIGINT_SQR_KARATSUBA_CUTOFF 64
+#endif
+#ifndef PYCFG_BIGINT_SQR_TOOM3_CUTOFF
+#define PYCFG_BIGINT_SQR_TOOM3_CUTOFF 400
+#endif
+#ifndef PYCFG_BIGINT_SQR_NTT_CUTOFF
+#define PYCFG_BIGINT_SQR_NTT_CUTOFF 3000
+#endif
+
+// divisor size (unit: limbs) above which burnikel-ziegler recursive division
+// is used instead of knuth's algorithm D.
+#ifndef PYCFG_BIGINT_DIV_BZ_CUTOFF
+#define PYCFG_BIGINT_DIV_BZ_CUTOFF 400
+#endif
+
+// size where burnikel-ziegler recursion stops and falls back to knuth.
+#ifndef PYCFG_BIGINT_DIV_BZ_BASECASE
+#define PYCFG_BIGINT_DIV_BZ_BASECASE 60
+#endif
+
+// number size (unit: limbs) above which gcd is reduced by recursive half-gcd,
+// instead of lehmer's algorithm.
+#ifndef PYCFG_BIGINT_GCD_HGCD_CUTOFF
+#define PYCFG_BIGINT_GCD_HGCD_CUTOFF 1000
+#endif
+
+// number size (unit: limbs) above which decimal string conversion is done
+// by divide-and-conquer with powers of 10, instead of O(n^2) chunk loop.
+#ifndef PYCFG_BIGINT_STR_DC_CUTOFF
+#define PYCFG_BIGINT_STR_DC_CUTOFF 40
+#endif
+
+// block size (unit: decimal digits) of streaming parser. see BigIntParser.
+// text is kept only up to one block, and each full block is converted at once.
+#ifndef PYCFG_BIGINT_PARSE_BLOCK
+#define PYCFG_BIGINT_PARSE_BLOCK 65536
+#endif
+
+// operand size (unit: limbs) above which multiplication and string conversion
+// are split into tasks of thread pool. only when parallel mode is on.
+#ifndef PYCFG_BIGINT_PARALLEL_CUTOFF
+#define PYCFG_BIGINT_PARALLEL_CUTOFF 1000
+#endif
+
+// if defined, vectorized add/sub kernels for x86 are not built.
+// (they are selected at runtime by cpuid, so no -mavx2 option is needed.)
+// #define PYCFG_BIGINT_NO_SIMD
+
+#if !defined(PYCFG_BIGINT_NO_SIMD) && !defined(PYCFG_BIGINT_DECIMAL_DIGIT) && \
+    defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PYC_BIGINT_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+
+
+//============================================================================
+// namespace
+
+namespace com::cafrii::pyc::mpn {
+
+//============================================================================
+
+/*
+    'mpn' stands for multi-precision natural number. (borrowed from GMP)
+
+    functions in this namespace work on raw limb arrays, without sign.
+    limbs are stored in little-endian order, ie, least significant limb first.
+    they do not allocate memory unless explicitly stated.
+
+    all kernels are written against kBase only, so that same code works
+    for both of binary limbs and legacy decimal digits.
+*/
+
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+using Limb = uint8_t;   // one decimal digit 0..9
+using DLimb = uint32_t; // holds product of two limbs plus carry
+constexpr DLimb kBase = 10;
+#else
+using Limb = uint32_t;
+using DLimb = uint64_t;
+constexpr int kLimbBits = 32;
+constexpr DLimb kBase = DLimb(1) << kLimbBits;
+#endif
+
+constexpr Limb kLimbMax = Limb(kBase - 1);
+
+//----------------------------------------------------------------------------
+// scratch memory
+
+/*
+    memory resource for internal workspace (temporaries) of current thread.
+    it is std::pmr::new_delete_resource(), unless changed by ScratchScope.
+*/
+std::pmr::memory_resource* ScratchResource();
+
+/*
+    while it is alive, scratch memory of current thread comes from res.
+    previous one is restored when it is destroyed. it can be nested.
+*/
+class ScratchScope
+{
+public:
+    explicit ScratchScope(std::pmr::memory_resource* res);
+    ~ScratchScope();
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+private:
+    std::pmr::memory_resource* m_prev;
+};
+
+/*
+    monotonic arena, installed as scratch of current thread while it is alive.
+    it can also be given to BigInt as allocator, so that whole batch job
+    allocates from it, and releases all at once at the end.
+
+        mpn::ScratchArena arena(1 << 20);
+        BigInt a(x, &arena.Resource()) ...
+        arena.Release(); // all BigInt on this arena should be gone before it.
+*/
+class ScratchArena
+{
+public:
+    explicit ScratchArena(size_t initial_size = 1 << 16):
+        m_arena(initial_size), m_scope(&m_arena) {}
+
+    std::pmr::memory_resource& Resource() { return m_arena; }
+    void Release() { m_arena.release(); }
+
+private:
+    std::pmr::monotonic_buffer_resource m_arena;
+    ScratchScope m_scope;
+};
+
+/*
+    allocator which takes the scratch resource of current thread at construction.
+    containers keep it, so memory goes back to where it came from,
+    even if the scratch is changed in the meantime.
+*/
+template <typename T>
+class ScratchAllocator
+{
+public:
+    using value_type = T;
+
+    ScratchAllocator() noexcept: m_res(ScratchResource()) {}
+    template <typename U>
+    ScratchAllocator(const ScratchAllocator<U>& other) noexcept: m_res(other.Resource()) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(m_res->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, size_t n) noexcept {
+        m_res->deallocate(p, n * sizeof(T), alignof(T));
+    }
+    std::pmr::memory_resource* Resource() const { return m_res; }
+
+    template <typename U>
+    bool operator==(const ScratchAllocator<U>& other) const noexcept {
+        return *m_res == *other.Resource();
+    }
+
+private:
+    std::pmr::memory_resource* m_res;
+};
+
+template <typename T>
+using ScratchVec = std::vector<T, ScratchAllocator<T>>;
+
+// scratch limb array. also used as general purpose limb buffer.
+using LimbVec = ScratchVec<Limb>;
+
+
+/*
+    limb storage of BigInt, with small buffer optimization.
+
+    up to kInline limbs (64 bits) are stored in the object itself,
+    and memory resource is used only when it grows beyond that.
+    capacity is never shrunk, until it is destroyed.
+    interface is a small subset of std::vector.
+
+    memory resource is chosen at construction and never changes.
+    copy construction takes default resource, like std::pmr containers,
+    so that a copy does not dangle when the arena of source is released.
+    move construction takes the resource of source.
+    move assignment and swap between different resources are done by copy.
+
+    capacity is kept in front of heap block, not in the object.
+    so that owner can put a small member into its tail padding.
+*/
+class LimbBuf
+{
+public:
+    // fixed 64 bit budget, independent of pointer width.
+    static constexpr int kInline = 8 / sizeof(Limb);
+    static_assert(sizeof(Limb) * kInline >= sizeof(Limb*), "inline limbs should cover heap pointer");
+
+    LimbBuf() {}
+    explicit LimbBuf(std::pmr::memory_resource* res): m_res(res) {}
+    explicit LimbBuf(int n, Limb v = 0) { resize(n, v); }
+    LimbBuf(std::initializer_list<Limb> il) { assign(il.begin(), il.end()); }
+    LimbBuf(const LimbBuf& other) { assign(other.begin(), other.end()); }
+    LimbBuf(LimbBuf&& other) noexcept { Steal(other); }
+    ~LimbBuf() { Free(); }
+
+    LimbBuf& operator=(const LimbBuf& other) {
+        if (this != &other) assign(other.begin(), other.end());
+        return *this;
+    }
+    // not noexcept, since different resource needs copy.
+    LimbBuf& operator=(LimbBuf&& other) {
+        if (this == &other)
+            ;
+        else if (*m_res == *other.m_res) {
+            Free();
+            Steal(other);
+        }
+        else
+            assign(other.begin(), other.end()); // can throw bad_alloc
+        return *this;
+    }
+
+public:
+    int size() const { return m_size; }
+    int capacity() const { return m_heap ? HeapCap() : kInline; }
+    bool empty() const { return m_size == 0; }
+    std::pmr::memory_resource* resource() const { return m_res; }
+
+    Limb* data() { return IsHeap() ? m_ptr : m_inline; }
+    const Limb* data() const { return IsHeap() ? m_ptr : m_inline; }
+    Limb* begin() { return data(); }
+    Limb* end() { return data() + m_size; }
+    const Limb* begin() const { return data(); }
+    const Limb* end() const { return data() + m_size; }
+    Limb& operator[](int k) { return data()[k]; }
+    const Limb& operator[](int k) const { return data()[k]; }
+
+    void reserve(int n) { if (n > capacity()) Grow(n); }
+    // new limbs are filled with v.
+    void resize(int n, Limb v = 0);
+    void assign(int n, Limb v);
+    void assign(const Limb* first, const Limb* last);
+    void push_back(Limb v) {
+        if (m_size == capacity()) Grow(m_size + 1);
+        data()[m_size++] = v;
+    }
+    // not noexcept, since different resource needs copy.
+    void swap(LimbBuf& other);
+
+private:
+    // heap block: [capacity][limbs...]. header is rounded up to limb size.
+    static constexpr int kHeader = (sizeof(int) + sizeof(Limb) - 1) / sizeof(Limb);
+
+    bool IsHeap() const { return m_heap; }
+    int HeapCap() const { return *reinterpret_cast<const int*>(m_ptr - kHeader); }
+    void Grow(int n);
+    void Free();
+    // take over other's storage and resource, and leave it empty.
+    void Steal(LimbBuf& other) noexcept;
+
+    union {
+        Limb* m_ptr;
+        Limb m_inline[kInline] = {};
+    };
+    std::pmr::memory_resource* m_res = std::pmr::get_default_resource();
+    int m_size = 0;
+    bool m_heap = false;
+};
+
+
+// number of limbs except high zero limbs. it returns 0 for zero number.
+int NormSize(const Limb* a, int n);
+
+// three-way magnitude comparison. returns -1, 0, 1.
+// both operands should be normalized.
+int Cmp(const Limb* a, int an, const Limb* b, int bn);
+
+// r[0..n) = a + b (or a - b), returns carry (or borrow).
+// r may be same as a or b.
+Limb AddN(Limb* r, const Limb* a, const Limb* b, int n);
+Limb SubN(Limb* r, const Limb* a, const Limb* b, int n);
+
+/*
+    AddN() and SubN() run on one of kernels below, selected by cpuid at first use.
+        "avx512", "avx2", "sse4": vectorized, with carry-lookahead between lanes.
+        "scalar": portable and branch-free. only one with decimal digit limbs.
+    environment variable PYC_BIGINT_KERNEL forces one of them, if supported.
+*/
+// name of current add/sub kernel.
+const char* AddSubKernel();
+// select add/sub kernel by name, or "auto" for the best one on this cpu.
+// returns false if it is unknown or not supported. (current one is kept)
+bool SelectAddSubKernel(const char* name);
+
+// r[0..an) = a + b (or a - b), an >= bn. returns carry (or borrow).
+// r may be same as a.
+Limb Add(Limb* r, const Limb* a, int an, const Limb* b, int bn);
+Limb Sub(Limb* r, const Limb* a, int an, const Limb* b, int bn);
+
+// r[0..n) = a * m + c, returns high limb.
+Limb Mul1(Limb* r, const Limb* a, int n, Limb m, Limb c = 0);
+
+// r[0..n) += a * m (or -= a * m), returns carry (or borrow).
+Limb AddMul1(Limb* r, const Limb* a, int n, Limb m);
+Limb SubMul1(Limb* r, const Limb* a, int n, Limb m);
+
+// q[0..n) = a / d, returns remainder. q may be same as a.
+Limb DivRem1(Limb* q, const Limb* a, int n, Limb d);
+
+// r[0..n) = B^n - a (two's complement). returns 1 if a is not zero.
+// r may be same as a.
+Limb NegN(Limb* r, const Limb* a, int n);
+
+// one operand of SumN(). p[0..n), subtracted if neg.
+struct SumTerm
+{
+    const Limb* p;
+    int n;
+    bool neg;
+};
+
+/*
+    r[0..rn) = sum of +-terms, in one carry pass. n of each term <= rn.
+    returns final carry, which is negative if the sum is negative.
+    (then r holds low limbs of two's complement of the sum)
+    r may be same as p of any term. m should be less than 2^31.
+*/
+int64_t SumN(Limb* r, int rn, const SumTerm* t, int m);
+
+#if !defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+// bit operations, for binary limbs only.
+
+// r[0..n) = a << cnt, 0 < cnt < kLimbBits. returns bits shifted out, in low bits.
+// r may be same as a, or above it.
+Limb Lshift(Limb* r, const Limb* a, int n, int cnt);
+// r[0..n) = a >> cnt, 0 < cnt < kLimbBits. returns bits shifted out, in high bits.
+// r may be same as a, or below it.
+Limb Rshift(Limb* r, const Limb* a, int n, int cnt);
+
+// number of 1 bits in a[0..n). popcnt instruction is used if cpu supports it.
+int64_t PopCount(const Limb* a, int n);
+#endif
+
+
+//----------------------------------------------------------------------------
+// parallel mode
+
+/*
+    number of threads used by big operations, including the calling thread.
+    1 (default) means sequential. environment variable PYC_BIGINT_THREADS
+    gives initial value, where 0 means all hardware threads.
+*/
+int ThreadCount();
+
+/*
+    resize the work-stealing thread pool. n = 0 for all hardware threads.
+    it should not be called while any big operation is running.
+    results never depend on it. only speed does.
+*/
+void SetThreadCount(int n);
+
+/*
+    fn(0), .. fn(n-1) on the thread pool. returns when all of them are done.
+    calling thread runs its own tasks while waiting, so it can be nested.
+    first exception from fn is rethrown.
+    tasks taken by other threads use their own scratch resource, not the caller's.
+*/
+void ParallelFor(int n, const std::function<void(int)>& fn);
+
+
+//----------------------------------------------------------------------------
+// multiplication
+
+/*
+    r[0..an+bn) = a * b, where an >= bn >= 1.
+    r should not overlap with a or b.
+    algorithm is chosen by operand size. (see PYCFG_BIGINT_MUL_xxx_CUTOFF)
+*/
+void Mul(Limb* r, const Limb* a, int an, const Limb* b, int bn);
+
+// r[0..2n) = a * a. r should not overlap with a.
+void Sqr(Limb* r, const Limb* a, int n);
+
+/*
+    each algorithm tier, exposed for testing and benchmark.
+    they apply the given algorithm at the top level only,
+    and sub-products are dispatched by Mul() again.
+*/
+void MulBasecase(Limb* r, const Limb* a, int an, const Limb* b, int bn);
+void SqrBasecase(Limb* r, const Limb* a, int n);
+void MulKaratsuba(Limb* r, const Limb* a, const Limb* b, int n);
+void MulToom3(Limb* r, const Limb* a, const Limb* b, int n);
+
+/*
+    number theoretic transform multiplication, O(n log n)
+    three 31-bit primes and CRT is used, so result is exact.
+    an + bn - 1 should not exceed kNttMaxSize.
+    a == b (with an == bn) is detected and needs one less transform.
+*/
+constexpr int kNttMaxSize = 1 << 26;
+void MulNtt(Limb* r, const Limb* a, int an, const Limb* b, int bn);
+
+
+//----------------------------------------------------------------------------
+// division
+
+/*
+    q[0..an-bn+1) = a / b, r[0..bn) = a % b, where an >= bn >= 1 and b[bn-1] != 0.
+    q and r should not overlap with a, b or each other.
+    algorithm is chosen by size. (see PYCFG_BIGINT_DIV_BZ_CUTOFF)
+*/
+void DivRem(Limb* q, Limb* r, const Limb* a, int an, const Limb* b, int bn);
+
+// each algorithm, exposed for testing and benchmark. same contract as DivRem().
+void DivRemKnuth(Limb* q, Limb* r, const Limb* a, int an, const Limb* b, int bn);
+void DivRemBZ(Limb* q, Limb* r, const Limb* a, int an, const Limb* b, int bn);
+
+
+//----------------------------------------------------------------------------
+// modular arithmetic
+
+/*
+    modular multiplication with fixed modulus m[0..n), m > 1, m[n-1] != 0.
+    precomputed once, and reused for many multiplications.
+
+    values are kept in internal form of n limbs, less than m.
+    - montgomery form (x * B^n mod m), if m is prime to kBase. (odd, in binary limbs)
+    - plain residue with barrett reduction, otherwise.
+
+    it is read-only after construction, so it can be shared between threads.
+    caller gives workspace tp of WorkSize() limbs.
+    with bConstTime, schoolbook multiplication and masked correction is used,
+    so that timing and memory access depend on sizes only, not on values.
+*/
+class ModCtx
+{
+public:
+    ModCtx() = default;
+    ModCtx(const Limb* m, int n);
+
+    int Size() const { return m_n; }
+    int WorkSize() const { return 6 * m_n + 8; }
+    const Limb* Modulus() const { return m_m.data(); }
+    bool IsMontgomery() const { return m_minv != 0; }
+
+    // r[0..n) = internal form of x[0..xn). x can be any size.
+    void ToForm(Limb* r, const Limb* x, int xn, Limb* tp) const;
+    // r[0..n) = plain value of internal form a.
+    void FromForm(Limb* r, const Limb* a, Limb* tp) const;
+    // r[0..n) = 1 in internal form.
+    void One(Limb* r) const;
+
+    // r = a * b (or a * a) in internal form. r may be same as a or b.
+    void MulMod(Limb* r, const Limb* a, const Limb* b, Limb* tp, bool bConstTime = false) const;
+    void SqrMod(Limb* r, const Limb* a, Limb* tp, bool bConstTime = false) const;
+
+protected:
+    // r[0..n) = t[0..2n) reduced. t is destroyed.
+    void Reduce(Limb* r, Limb* t, Limb* tp, bool bConstTime) const;
+
+    // plain heap, since context may outlive scratch arena.
+    std::vector<Limb> m_m;      // modulus, with one more zero limb
+    std::vector<Limb> m_aux;    // B^(2n) mod m for montgomery, or floor(B^(2n) / m) for barrett
+    std::vector<Limb> m_one;    // 1 in internal form
+    int m_n = 0;
+    Limb m_minv = 0;            // -1/m mod kBase. 0 if barrett.
+};
+
+/*
+    r[0..n) = b^e mod m, where n = ctx.Size().
+    b[0..bn) can be any size. e[0..en) is exponent.
+    sliding window exponentiation. with bConstTime, fixed window and
+    table lookup by full scan instead, so that timing depends only on
+    en and n. (b should be already reduced, for full constant-time)
+*/
+void PowMod(Limb* r, const Limb* b, int bn, const Limb* e, int en,
+        const ModCtx& ctx, bool bConstTime = false);
+
+
+//----------------------------------------------------------------------------
+// gcd
+
+/*
+    g = gcd(a, b). returns normalized size of g. (0 if both are zero)
+    g should have max(an, bn) limbs. a and b are not modified.
+    lehmer's algorithm with double limb front end, and recursive half-gcd
+    for big numbers. (see PYCFG_BIGINT_GCD_HGCD_CUTOFF)
+    with decimal digit limbs, it is plain euclid's algorithm.
+*/
+int Gcd(Limb* g, const Limb* a, int an, const Limb* b, int bn);
+
+// each algorithm, exposed for testing and benchmark. same contract as Gcd().
+int GcdEuclid(Limb* g, const Limb* a, int an, const Limb* b, int bn);
+int GcdLehmer(Limb* g, const Limb* a, int an, const Limb* b, int bn);
+
+/*
+    r = 1/a mod m, where m > 1. r should have mn limbs.
+    returns normalized size of r, or -1 if gcd(a, m) != 1.
+*/
+int ModInverse(Limb* r, const Limb* a, int an, const Limb* m, int mn);
+
+
+//----------------------------------------------------------------------------
+// integer root
+
+/*
+    s = floor(a^(1/k)), where k >= 2 and a[an-1] != 0.
+    s should have an / k + 1 limbs. returns normalized size of s.
+    newton's iteration from floating-point estimate of top limbs,
+    and precision is doubled on each level. (root of top half is the
+    start point of the whole) cost is a few multiplications of full size.
+*/
+int Root(Limb* s, const Limb* a, int an, int k);
+/*
+    s = floor(sqrt(a)), r = a - s^2, where a[an-1] != 0.
+    s should have (an + 1) / 2 limbs, r should have (an + 1) / 2 + 1 limbs.
+    returns normalized size of s, and that of r in rn.
+    remainder is carried through recursion (zimmermann's karatsuba square root),
+    so each level divides only a quarter by a quarter.
+*/
+int SqrtRem(Limb* s, Limb* r, const Limb* a, int an, int& rn);
+
+
+//----------------------------------------------------------------------------
+// decimal string conversion
+
+// max number of limbs for len decimal digits.
+int LimbsForDigits(int len);
+// max number of decimal digits for n limbs.
+int DigitsForLimbs(int n);
+
+/*
+    r = value of decimal digits s[0..len), '0' ~ '9' only. returns normalized size.
+    r should have LimbsForDigits(len) limbs, zero-filled.
+*/
+int SetStr(Limb* r, const char* s, int len);
+
+/*
+    writes decimal digits of a[0..n) to s, without leading zeros. returns length.
+    s should have DigitsForLimbs(n) chars. zero is written as "0".
+*/
+int GetStr(char* s, const Limb* a, int n);
+
+// O(n^2) chunk loop versions, exposed for testing and benchmark.
+int SetStrBasecase(Limb* r, const char* s, int len);
+int GetStrBasecase(char* s, const Limb* a, int n);
+
+
+//============================================================================
+}; // namespace com::cafrii::pyc::mpn
+
+//============================================================================
+
+#ifdef __PYC_LIB_IMPLEMENTATION
+
+namespace com::cafrii::pyc::mpn {
+//============================================================================
+
+
+int NormSize(const Limb* a, int n)
+{
+    while (n > 0 && a[n-1] == 0) n--;
+    return n;
+}
+
+/*
+    from the top. equal blocks of 256 bytes are skipped by memcmp(), which is
+    vectorized by libc. first differing block is scanned a 64-bit word at a time:
+    on little endian host, limbs in a word compare as one integer in the same order
+    as limb by limb, in both representations.
+*/
+int Cmp(const Limb* a, int an, const Limb* b, int bn)
+{
+    if (an != bn)
+        return an < bn ? -1 : 1;
+    int k = an;
+    constexpr int kBlock = 256 / sizeof(Limb);
+    while (k >= kBlock && std::memcmp(a + k - kBlock, b + k - kBlock, kBlock * sizeof(Limb)) == 0)
+        k -= kBlock;
+    if constexpr (std::endian::native == std::endian::little) {
+        constexpr int kStep = sizeof(uint64_t) / sizeof(Limb);
+        for (; k >= kStep; k -= kStep) {
+            uint64_t x, y;
+            std::memcpy(&x, a + k - kStep, sizeof(x));
+            std::memcpy(&y, b + k - kStep, sizeof(y));
+            if (x != y)
+                return x < y ? -1 : 1;
+        }
+    }
+    for (k--; k>=0; k--) {
+        if (a[k] != b[k])
+            return a[k] < b[k] ? -1 : 1;
+    }
+    return 0;
+}
+
+//-------------------------------------
+// add/sub kernels
+
+namespace {
+
+Limb AddNScalar(Limb* r, const Limb* a, const Limb* b, int n, Limb c = 0)
+{
+    DLimb carry = c;
+    for (int k=0; k<n; k++) {
+        DLimb s = (DLimb)a[k] + b[k] + carry;
+        r[k] = Limb(s % kBase);
+        carry = s / kBase;
+    }
+    return Limb(carry);
+}
+
+Limb SubNScalar(Limb* r, const Limb* a, const Limb* b, int n, Limb c = 0)
+{
+    int64_t borrow = c;
+    for (int k=0; k<n; k++) {
+        int64_t d = (int64_t)a[k] - b[k] - borrow;
+        borrow = d < 0;
+        r[k] = Limb(d + borrow * (int64_t)kBase);
+    }
+    return Limb(borrow);
+}
+
+#if defined(PYC_BIGINT_X86_SIMD)
+/*
+    carry-lookahead over lanes of a vector, as bit masks. (bit i is lane i)
+    g: lane generates carry by itself. (a + b wrapped)
+    p: lane propagates incoming carry. (a + b == all ones)
+    carry into lane i+1 is g[i] | (p[i] & carry into lane i), and
+    it is solved for all lanes at once by one integer addition:
+        c = (((g << 1) | cin) + p) ^ p
+    bit i of c is carry into lane i, and bit 'lanes' is carry out of vector.
+    same holds for borrow of subtraction, with p: a - b == 0.
+*/
+inline uint32_t CarryLookahead(uint32_t g, uint32_t p, uint32_t cin)
+{
+    return (((g << 1) | cin) + p) ^ p;
+}
+
+__attribute__((target("sse4.1")))
+Limb AddNSse4(Limb* r, const Limb* a, const Limb* b, int n)
+{
+    const __m128i ones = _mm_set1_epi32(-1);
+    const __m128i bits = _mm_setr_epi32(1, 2, 4, 8);
+    uint32_t carry = 0;
+    int k = 0;
+    for (; k+4<=n; k+=4) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + k));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + k));
+        __m128i s = _mm_add_epi32(va, vb);
+        // s < a (unsigned) if max(s, a) != s
+        uint32_t ge = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_max_epu32(s, va), s)));
+        uint32_t p = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(s, ones)));
+        uint32_t c = CarryLookahead(~ge & 0xF, p, carry);
+        carry = (c >> 4) & 1;
+        // lanes with carry-in are all ones mask. s - (-1) == s + 1
+        __m128i vc = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(c), bits), bits);
+        _mm_storeu_si128((__m128i*)(r + k), _mm_sub_epi32(s, vc));
+    }
+    return AddNScalar(r + k, a + k, b + k, n - k, Limb(carry));
+}
+
+__attribute__((target("sse4.1")))
+Limb SubNSse4(Limb* r, const Limb* a, const Limb* b, int n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bits = _mm_setr_epi32(1, 2, 4, 8);
+    uint32_t borrow = 0;
+    int k = 0;
+    for (; k+4<=n; k+=4) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + k));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + k));
+        __m128i d = _mm_sub_epi32(va, vb);
+        // a < b (unsigned) if max(a, b) != a
+        uint32_t ge = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_max_epu32(va, vb), va)));
+        uint32_t p = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(d, zero)));
+        uint32_t c = CarryLookahead(~ge & 0xF, p, borrow);
+        borrow = (c >> 4) & 1;
+        __m128i vc = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(c), bits), bits);
+        _mm_storeu_si128((__m128i*)(r + k), _mm_add_epi32(d, vc));
+    }
+    return SubNScalar(r + k, a + k, b + k, n - k, Limb(borrow));
+}
+
+__attribute__((target("avx2")))
+Limb AddNAvx2(Limb* r, const Limb* a, const Limb* b, int n)
+{
+    const __m256i ones = _mm256_set1_epi32(-1);
+    const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    uint32_t carry = 0;
+    int k = 0;
+    for (; k+8<=n; k+=8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + k));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + k));
+        __m256i s = _mm256_add_epi32(va, vb);
+        uint32_t ge = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_max_epu32(s, va), s)));
+        uint32_t p = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(s, ones)));
+        uint32_t c = CarryLookahead(~ge & 0xFF, p, carry);
+        carry = (c >> 8) & 1;
+        __m256i vc = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(c), bits), bits);
+        _mm256_storeu_si256((__m256i*)(r + k), _mm256_sub_epi32(s, vc));
+    }
+    return AddNScalar(r + k, a + k, b + k, n - k, Limb(carry));
+}
+
+__attribute__((target("avx2")))
+Limb SubNAvx2(Limb* r, const Limb* a, const Limb* b, int n)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    uint32_t borrow = 0;
+    int k = 0;
+    for (; k+8<=n; k+=8) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + k));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + k));
+        __m256i d = _mm256_sub_epi32(va, vb);
+        uint32_t ge = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_max_epu32(va, vb), va)));
+        uint32_t p = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(d, zero)));
+        uint32_t c = CarryLookahead(~ge & 0xFF, p, borrow);
+        borrow = (c >> 8) & 1;
+        __m256i vc = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(c), bits), bits);
+        _mm256_storeu_si256((__m256i*)(r + k), _mm256_add_epi32(d, vc));
+    }
+    return SubNScalar(r + k, a + k, b + k, n - k, Limb(borrow));
+}
+
+// mask registers give g and p directly, and take carry mask directly.
+__attribute__((target("avx512f")))
+Limb AddNAvx512(Limb* r, const Limb* a, const Limb* b, int n)
+{
+    const __m512i ones = _mm512_set1_epi32(-1);
+    uint32_t carry = 0;
+    int k = 0;
+    for (; k+16<=n; k+=16) {
+        __m512i va = _mm512_loadu_si512(a + k);
+        __m512i vb = _mm512_loadu_si512(b + k);
+        __m512i s = _mm512_add_epi32(va, vb);
+        uint32_t g = _mm512_cmplt_epu32_mask(s, va);
+        uint32_t p = _mm512_cmpeq_epi32_mask(s, ones);
+        uint32_t c = CarryLookahead(g, p, carry);
+        carry = (c >> 16) & 1;
+        _mm512_storeu_si512(r + k, _mm512_mask_sub_epi32(s, __mmask16(c), s, ones));
+    }
+    return AddNScalar(r + k, a + k, b + k, n - k, Limb(carry));
+}
+
+__attribute__((target("avx512f")))
+Limb SubNAvx512(Limb* r, const Limb* a, const Limb* b, int n)
+{
+    const __m512i ones = _mm512_set1_epi32(-1);
+    uint32_t borrow = 0;
+    int k = 0;
+    for (; k+16<=n; k+=16) {
+        __m512i va = _mm512_loadu_si512(a + k);
+        __m512i vb = _mm512_loadu_si512(b + k);
+        __m512i d = _mm512_sub_epi32(va, vb);
+        uint32_t g = _mm512_cmplt_epu32_mask(va, vb);
+        uint32_t p = _mm512_cmpeq_epi32_mask(d, _mm512_setzero_si512());
+        uint32_t c = CarryLookahead(g, p, borrow);
+        borrow = (c >> 16) & 1;
+        _mm512_storeu_si512(r + k, _mm512_mask_add_epi32(d, __mmask16(c), d, ones));
+    }
+    return SubNScalar(r + k, a + k, b + k, n - k, Limb(borrow));
+}
+#endif // PYC_BIGINT_X86_SIMD
+
+struct AddSubKernelEntry
+{
+    const char* name;
+    Limb (*add)(Limb*, const Limb*, const Limb*, int);
+    Limb (*sub)(Limb*, const Limb*, const Limb*, int);
+    bool (*supported)();
+};
+
+// best one first.
+const AddSubKernelEntry kAddSubKernels[] = {
+#if defined(PYC_BIGINT_X86_SIMD)
+    { "avx512", AddNAvx512, SubNAvx512, []{ return (bool)__builtin_cpu_supports("avx512f"); } },
+    { "avx2", AddNAvx2, SubNAvx2, []{ return (bool)__builtin_cpu_supports("avx2"); } },
+    { "sse4", AddNSse4, SubNSse4, []{ return (bool)__builtin_cpu_supports("sse4.1"); } },
+#endif
+    { "scalar",
+        [](Limb* r, const Limb* a, const Limb* b, int n) { return AddNScalar(r, a, b, n); },
+        [](Limb* r, const Limb* a, const Limb* b, int n) { return SubNScalar(r, a, b, n); },
+        []{ return true; } },
+};
+
+std::atomic<const AddSubKernelEntry*> g_addSubKernel{nullptr};
+
+const AddSubKernelEntry* FindAddSubKernel(const char* name)
+{
+#if defined(PYC_BIGINT_X86_SIMD)
+    __builtin_cpu_init();
+#endif
+    bool bAuto = !std::strcmp(name, "auto");
+    for (auto& e : kAddSubKernels) {
+        if ((bAuto || !std::strcmp(name, e.name)) && e.supported())
+            return &e;
+    }
+    return nullptr;
+}
+
+// lazy init at first use. env var is read only once.
+const AddSubKernelEntry* CurAddSubKernel()
+{
+    const AddSubKernelEntry* e = g_addSubKernel.load(std::memory_order_relaxed);
+    if (e) return e;
+    const char* env = std::getenv("PYC_BIGINT_KERNEL");
+    e = env ? FindAddSubKernel(env) : nullptr;
+    if (!e) e = FindAddSubKernel("auto");
+    g_addSubKernel.store(e, std::memory_order_relaxed);
+    return e;
+}
+
+} // namespace
+
+const char* AddSubKernel()
+{
+    return CurAddSubKernel()->name;
+}
+
+bool SelectAddSubKernel(const char* name)
+{
+    const AddSubKernelEntry* e = FindAddSubKernel(name);
+    if (!e) return false;
+    g_addSubKernel.store(e, std::memory_order_relaxed);
+    return true;
+}
+
+Limb AddN(Limb* r, const Limb* a, const Limb* b, int n)
+{
+    return CurAddSubKernel()->add(r, a, b, n);
+}
+
+Limb SubN(Limb* r, const Limb* a, const Limb* b, int n)
+{
+    return CurAddSubKernel()->sub(r, a, b, n);
+}
+
+Limb Add(Limb* r, const Limb* a, int an, const Limb* b, int bn)
+{
+    Limb carry = AddN(r, a, b, bn);
+    for (int k=bn; k<an; k++) {
+        if (!carry) {
+            // just copy the rest. nothing to do for in-place operation.
+            if (r != a)
+                for (; k<an; k++) r[k] = a[k];
+            break;
+        }
+        carry = (a[k] == kLimbMax);
+        r[k] = carry ? 0 : a[k] + 1;
+    }
+    return carry;
+}
+
+Limb Sub(Limb* r, const Limb* a, int an, const Limb* b, int bn)
+{
+    Limb borrow = SubN(r, a, b, bn);
+    for (int k=bn; k<an; k++) {
+        if (!borrow) {
+            if (r != a)
+                for (; k<an; k++) r[k] = a[k];
+            break;
+        }
+        borrow = (a[k] == 0);
+        r[k] = borrow ? kLimbMax : a[k] - 1;
+    }
+    return borrow;
+}
+
+Limb Mul1(Limb* r, const Limb* a, int n, Limb m, Limb c)
+{
+    DLimb carry = c;
+    for (int k=0; k<n; k++) {
+        DLimb t = (DLimb)a[k] * m + carry;
+        r[k] = Limb(t % kBase);
+        carry = t / kBase;
+    }
+    return Limb(carry);
+}
+
+Limb AddMul1(Limb* r, const Limb* a, int n, Limb m)
+{
+    DLimb carry = 0;
+    for (int k=0; k<n; k++) {
+        // (B-1)^2 + 2(B-1) == B^2-1, so it never overflows.
+        DLimb t = (DLimb)a[k] * m + r[k] + carry;
+        r[k] = Limb(t % kBase);
+        carry = t / kBase;
+    }
+    return Limb(carry);
+}
+
+Limb SubMul1(Limb* r, const Limb* a, int n, Limb m)
+{
+    DLimb borrow = 0;
+    for (int k=0; k<n; k++) {
+        DLimb t = (DLimb)a[k] * m + borrow;
+        Limb lo = Limb(t % kBase);
+        borrow = t / kBase;
+        if (r[k] < lo) {
+            r[k] = Limb(r[k] + kBase - lo);
+            borrow++;
+        }
+        else
+            r[k] -= lo;
+    }
+    return Limb(borrow);
+}
+
+Limb DivRem1(Limb* q, const Limb* a, int n, Limb d)
+{
+    DLimb rem = 0;
+    for (int k=n-1; k>=0; k--) {
+        DLimb t = rem * kBase + a[k];
+        q[k] = Limb(t / d);
+        rem = t % d;
+    }
+    return Limb(rem);
+}
+
+Limb NegN(Limb* r, const Limb* a, int n)
+{
+    // skip low zero limbs, negate first non-zero one, complement the rest.
+    int k = 0;
+    for (; k<n && a[k]==0; k++) r[k] = 0;
+    if (k == n)
+        return 0;
+    r[k] = Limb(kBase - a[k]);
+    for (k++; k<n; k++) r[k] = Limb(kLimbMax - a[k]);
+    return 1;
+}
+
+int64_t SumN(Limb* r, int rn, const SumTerm* t, int m)
+{
+    int64_t carry = 0;
+    for (int k=0; k<rn; k++) {
+        // |acc| < m * kBase, fits in int64.
+        int64_t acc = carry;
+        for (int i=0; i<m; i++) {
+            if (k < t[i].n)
+                acc += t[i].neg ? -(int64_t)t[i].p[k] : (int64_t)t[i].p[k];
+        }
+        // floor division, so that limb is always in [0, kBase).
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+        carry = acc / (int64_t)kBase;
+        if (acc % (int64_t)kBase < 0) carry--;
+        r[k] = Limb(acc - carry * (int64_t)kBase);
+#else
+        r[k] = Limb(acc);
+        carry = acc >> kLimbBits;
+#endif
+    }
+    return carry;
+}
+
+#if !defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+Limb Lshift(Limb* r, const Limb* a, int n, int cnt)
+{
+    // from top, so that r can be above a.
+    Limb out = a[n - 1] >> (kLimbBits - cnt);
+    for (int k=n-1; k>0; k--)
+        r[k] = (a[k] << cnt) | (a[k - 1] >> (kLimbBits - cnt));
+    r[0] = a[0] << cnt;
+    return out;
+}
+
+Limb Rshift(Limb* r, const Limb* a, int n, int cnt)
+{
+    Limb out = a[0] << (kLimbBits - cnt);
+    for (int k=0; k<n-1; k++)
+        r[k] = (a[k] >> cnt) | (a[k + 1] << (kLimbBits - cnt));
+    r[n - 1] = a[n - 1] >> cnt;
+    return out;
+}
+
+namespace {
+
+int64_t PopCountScalar(const Limb* a, int n)
+{
+    int64_t c = 0;
+    for (int k=0; k<n; k++)
+        c += std::popcount(a[k]);
+    return c;
+}
+
+#if defined(PYC_BIGINT_X86_SIMD)
+// two limbs at a time, by 64-bit popcnt.
+__attribute__((target("popcnt")))
+int64_t PopCountHw(const Limb* a, int n)
+{
+    int64_t c = 0;
+    int k = 0;
+    for (; k+2<=n; k+=2) {
+        uint64_t w;
+        std::memcpy(&w, a + k, sizeof(w));
+        c += __builtin_popcountll(w);
+    }
+    if (k < n)
+        c += __builtin_popcount(a[k]);
+    return c;
+}
+#endif
+
+} // namespace
+
+int64_t PopCount(const Limb* a, int n)
+{
+#if defined(PYC_BIGINT_X86_SIMD)
+    static const bool bHw = (__builtin_cpu_init(), __builtin_cpu_supports("popcnt"));
+    if (bHw)
+        return PopCountHw(a, n);
+#endif
+    return PopCountScalar(a, n);
+}
+#endif // !PYCFG_BIGINT_DECIMAL_DIGIT
+
+
+
+//----------------------------------------------------------------------------
+// parallel mode
+
+namespace {
+
+struct TaskGroup
+{
+    const std::function<void(int)>* fn;
+    // unfinished tasks. owner sleeps on cv until it is 0.
+    // last one notifies under mtx, so owner can not free the group before it.
+    int pending;
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::atomic<bool> failed { false };
+    std::exception_ptr error;
+};
+
+struct Task
+{
+    TaskGroup* g;
+    int index;
+};
+
+// owner pushes and pops at back, others steal from front. (bigger tasks)
+using TaskDeque = std::deque<Task>;
+
+// deque of current thread. worker's own one, or registered at first use.
+thread_local TaskDeque* t_deque = nullptr;
+
+/*
+    work-stealing thread pool.
+    each thread has a task deque, and idle workers steal from others.
+    tasks are coarse (parts of big multiplication), so one mutex guards
+    all deques, instead of lock-free ones.
+
+    waiting thread runs only tasks of its own group. it never picks up
+    unrelated work while it may hold a lock. (eg. cache of Pow10Pow2)
+*/
+class ThreadPool
+{
+public:
+    static ThreadPool& Instance() {
+        static ThreadPool pool;
+        return pool;
+    }
+    ~ThreadPool() { Stop(); }
+
+    int Threads() const { return m_threads.load(std::memory_order_relaxed); }
+    void Resize(int n);
+    void Run(int n, const std::function<void(int)>& fn);
+    void Unregister(TaskDeque* dq);
+
+private:
+    ThreadPool();
+    void Stop();
+    void WorkerMain(TaskDeque* self);
+    TaskDeque* LocalDeque();
+    bool StealLocked(Task& t, const TaskDeque* self);
+    static void Execute(const Task& t);
+
+    std::mutex m_mtx;               // deques, m_queued, m_stop
+    std::condition_variable m_cv;
+    std::vector<TaskDeque*> m_deques;
+    int m_queued = 0;               // number of tasks in all deques
+    bool m_stop = false;
+    size_t m_stealSeed = 0;
+
+    std::mutex m_resizeMtx;
+    std::atomic<int> m_threads { 1 };
+    std::vector<std::unique_ptr<TaskDeque>> m_own;
+    std::vector<std::thread> m_workers;
+};
+
+// env var is read once, at first use of the pool.
+ThreadPool::ThreadPool()
+{
+    if (const char* env = std::getenv("PYC_BIGINT_THREADS"))
+        Resize(std::atoi(env));
+}
+
+void ThreadPool::Resize(int n)
+{
+    if (n <= 0)
+        n = std::max(1, (int)std::thread::hardware_concurrency());
+    std::lock_guard<std::mutex> lock(m_resizeMtx);
+    Stop();
+    m_threads.store(n, std::memory_order_relaxed);
+    // calling thread is one of n.
+    for (int k=0; k<n-1; k++) {
+        m_own.push_back(std::make_unique<TaskDeque>());
+        TaskDeque* dq = m_own.back().get();
+        {
+            std::lock_guard<std::mutex> lk(m_mtx);
+            m_deques.push_back(dq);
+        }
+        m_workers.emplace_back(&ThreadPool::WorkerMain, this, dq);
+    }
+}
+
+void ThreadPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto& th : m_workers)
+        th.join();
+    m_workers.clear();
+
+    std::lock_guard<std::mutex> lock(m_mtx);
+    for (auto& dq : m_own)
+        std::erase(m_deques, dq.get());
+    m_own.clear();
+    m_stop = false;
+    m_threads.store(1, std::memory_order_relaxed);
+}
+
+void ThreadPool::Unregister(TaskDeque* dq)
+{
+    std::lock_guard<std::mutex> lock(m_mtx);
+    std::erase(m_deques, dq);
+}
+
+TaskDeque* ThreadPool::LocalDeque()
+{
+    if (t_deque)
+        return t_deque;
+
+    // non-worker thread. removed from the pool at thread exit.
+    struct CallerDeque {
+        TaskDeque dq;
+        ThreadPool* pool = nullptr;
+        ~CallerDeque() { if (pool) pool->Unregister(&dq); }
+    };
+    thread_local CallerDeque c;
+    c.pool = this;
+    std::lock_guard<std::mutex> lock(m_mtx);
+    m_deques.push_back(&c.dq);
+    return t_deque = &c.dq;
+}
+
+// m_mtx should be held. victims are tried from a rotating start.
+bool ThreadPool::StealLocked(Task& t, const TaskDeque* self)
+{
+    size_t n = m_deques.size();
+    size_t start = m_stealSeed++;
+    for (size_t k=0; k<n; k++) {
+        TaskDeque* dq = m_deques[(start + k) % n];
+        if (dq != self && !dq->empty()) {
+            t = dq->front();
+            dq->pop_front();
+            m_queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::WorkerMain(TaskDeque* self)
+{
+    t_deque = self;
+    std::unique_lock<std::mutex> lock(m_mtx);
+    while (true) {
+        m_cv.wait(lock, [this] { return m_stop || m_queued > 0; });
+        if (m_stop)
+            break;
+        Task t;
+        if (!StealLocked(t, self))
+            continue;
+        lock.unlock();
+        Execute(t);
+        lock.lock();
+    }
+    t_deque = nullptr;
+}
+
+// remaining tasks of failed group are skipped.
+void ThreadPool::Execute(const Task& t)
+{
+    TaskGroup* g = t.g;
+    if (!g->failed.load(std::memory_order_relaxed)) {
+        try {
+            (*g->fn)(t.index);
+        }
+        catch (...) {
+            if (!g->failed.exchange(true))
+                g->error = std::current_exception();
+        }
+    }
+    std::lock_guard<std::mutex> lock(g->mtx);
+    if (--g->pending == 0)
+        g->cv.notify_all();
+}
+
+void ThreadPool::Run(int n, const std::function<void(int)>& fn)
+{
+    if (n <= 0)
+        return;
+    if (n == 1 || Threads() <= 1) {
+        for (int i=0; i<n; i++) fn(i);
+        return;
+    }
+
+    TaskDeque* self = LocalDeque();
+    TaskGroup g;
+    g.fn = &fn;
+    g.pending = n;
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        // task 1 on the back, so that owner takes them in order.
+        for (int i=n-1; i>=1; i--)
+            self->push_back({ &g, i });
+        m_queued += n - 1;
+    }
+    m_cv.notify_all();
+
+    Execute({ &g, 0 });
+    // nested groups are all done before their Run() returns,
+    // so our tasks, if any left, are on the back.
+    while (true) {
+        Task t;
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            if (self->empty() || self->back().g != &g)
+                break;
+            t = self->back();
+            self->pop_back();
+            m_queued--;
+        }
+        Execute(t);
+    }
+    // rest are running on other threads. sleep until they are done.
+    {
+        std::unique_lock<std::mutex> lock(g.mtx);
+        g.cv.wait(lock, [&g] { return g.pending == 0; });
+    }
+    if (g.error)
+        std::rethrow_exception(g.error);
+}
+
+// whether operation of n limbs is split into tasks.
+bool Parallel(int n)
+{
+    return n >= PYCFG_BIGINT_PARALLEL_CUTOFF && ThreadCount() > 1;
+}
+
+/*
+    fn(begin, end) over [0, n). if n is big enough, it is split into
+    a few slices per thread, for load balance.
+*/
+void ForRange(int n, const std::function<void(int, int)>& fn)
+{
+    if (!Parallel(n)) {
+        fn(0, n);
+        return;
+    }
+    int tasks = std::min(4 * ThreadCount(), n);
+    ParallelFor(tasks, [&](int t) {
+        fn((int)((long long)n * t / tasks), (int)((long long)n * (t + 1) / tasks));
+    });
+}
+
+} // namespace
+
+int ThreadCount()
+{
+    return ThreadPool::Instance().Threads();
+}
+
+void SetThreadCount(int n)
+{
+    ThreadPool::Instance().Resize(n);
+}
+
+void ParallelFor(int n, const std::function<void(int)>& fn)
+{
+    ThreadPool::Instance().Run(n, fn);
+}
+
+
+//----------------------------------------------------------------------------
+// multiplication
+
+namespace {
+
+// equal-size multiplication dispatcher, and its squaring counterpart.
+void MulN(Limb* r, const Limb* a, const Limb* b, int n);
+void SqrN(Limb* r, const Limb* a, int n);
+
+void MulOrSqrN(Limb* r, const Limb* a, const Limb* b, int n, bool sqr)
+{
+    if (sqr) SqrN(r, a, n);
+    else MulN(r, a, b, n);
+}
+
+/*
+    d[0..xn) = |x - y|, where xn >= yn.
+    returns true if x < y. (ie, result is negative)
+*/
+bool AbsDiff(Limb* d, const Limb* x, int xn, const Limb* y, int yn)
+{
+    int xs = NormSize(x, xn);
+    int ys = NormSize(y, yn);
+    if (Cmp(x, xs, y, ys) >= 0) {
+        Sub(d, x, xn, y, yn);
+        return false;
+    }
+    // x < y, so xs <= ys.
+    Sub(d, y, yn, x, xs);
+    std::fill(d + yn, d + xn, Limb(0));
+    return true;
+}
+
+/*
+    karatsuba, O(n^1.585)
+
+    a = a1*B^l + a0, b = b1*B^l + b0
+    a*b = z2*B^2l + (z0 + z2 - (a0-a1)(b0-b1))*B^l + z0
+        where z0 = a0*b0, z2 = a1*b1
+
+    (a0-a1)(b0-b1) is calculated in magnitude, with its sign separately,
+    so that all intermediate values are non-negative.
+*/
+void Karatsuba(Limb* r, const Limb* a, const Limb* b, int n, bool sqr)
+{
+    int l = (n + 1) / 2;
+    int h = n - l;
+
+    LimbVec tmp(2*l + 2*l + 2*l + 1);
+    Limb* da = tmp.data();
+    Limb* db = da + l;
+    Limb* p = db + l;      // 2l
+    Limb* m = p + 2*l;     // 2l+1
+
+    bool sa = AbsDiff(da, a, l, a + l, h);
+    bool sb = sqr ? sa : AbsDiff(db, b, l, b + l, h);
+
+    // z0 -> r[0..2l), z2 -> r[2l..2n), p = |a0-a1| * |b0-b1|
+    // three products write disjoint ranges, so they may run in parallel.
+    auto product = [&](int i) {
+        if (i == 0) MulOrSqrN(r, a, b, l, sqr);
+        else if (i == 1) MulOrSqrN(r + 2*l, a + l, b + l, h, sqr);
+        else MulOrSqrN(p, da, db, l, sqr);
+    };
+    if (Parallel(n))
+        ParallelFor(3, product);
+    else
+        for (int i=0; i<3; i++) product(i);
+
+    // m = z0 + z2 -/+ p
+    std::copy(r, r + 2*l, m);
+    m[2*l] = Add(m, m, 2*l, r + 2*l, 2*h);
+    if (sa == sb)
+        Sub(m, m, 2*l + 1, p, 2*l);
+    else
+        Add(m, m, 2*l + 1, p, 2*l);
+
+    // final result fits in 2n limbs, so there is no carry out.
+    Add(r + l, r + l, 2*n - l, m, NormSize(m, 2*l + 1));
+}
+
+/*
+    signed number, used as toom-cook intermediate values.
+    magnitude is always normalized. zero is empty vector.
+*/
+struct SNum {
+    LimbVec mag;
+    bool neg = false;
+
+    SNum() {}
+    SNum(const Limb* a, int n): mag(a, a + NormSize(a, n)) {}
+    int Size() const { return (int)mag.size(); }
+};
+
+void Trim(SNum& x)
+{
+    x.mag.resize(NormSize(x.mag.data(), x.Size()));
+    if (x.mag.empty()) x.neg = false;
+}
+
+// x += y, or x -= y if bSub.
+void AddTo(SNum& x, const SNum& y, bool bSub = false)
+{
+    bool yneg = y.neg != bSub;
+    int xn = x.Size(), yn = y.Size();
+    if (x.neg == yneg) {
+        int len = std::max(xn, yn);
+        x.mag.resize(len + 1, 0);
+        x.mag[len] = Add(x.mag.data(), x.mag.data(), len, y.mag.data(), yn);
+    }
+    else if (Cmp(x.mag.data(), xn, y.mag.data(), yn) >= 0) {
+        Sub(x.mag.data(), x.mag.data(), xn, y.mag.data(), yn);
+    }
+    else {
+        // x = y - x
+        x.mag.resize(yn, 0);
+        SubN(x.mag.data(), y.mag.data(), x.mag.data(), yn);
+        x.neg = yneg;
+    }
+    Trim(x);
+}
+
+void MulSmall(SNum& x, Limb m)
+{
+    int n = x.Size();
+    x.mag.resize(n + 1);
+    x.mag[n] = Mul1(x.mag.data(), x.mag.data(), n, m);
+    Trim(x);
+}
+
+// x /= d, division should be exact.
+void DivExact(SNum& x, Limb d)
+{
+    DivRem1(x.mag.data(), x.mag.data(), x.Size(), d);
+    Trim(x);
+}
+
+/*
+    r = x * y. r.mag should have x.Size() + y.Size() limbs already,
+    so that it does not allocate. (it may run on other thread)
+*/
+void MulS(SNum& r, const SNum& x, const SNum& y, bool sqr)
+{
+    int xn = x.Size(), yn = y.Size();
+    if (!xn || !yn) {
+        r.mag.clear();
+        r.neg = false;
+        return;
+    }
+    if (sqr)
+        Sqr(r.mag.data(), x.mag.data(), xn);
+    else if (xn >= yn)
+        Mul(r.mag.data(), x.mag.data(), xn, y.mag.data(), yn);
+    else
+        Mul(r.mag.data(), y.mag.data(), yn, x.mag.data(), xn);
+    r.neg = x.neg != y.neg;
+    Trim(r);
+}
+
+SNum MulS(const SNum& x, const SNum& y, bool sqr)
+{
+    SNum r;
+    if (x.Size() && y.Size()) {
+        r.mag.resize(x.Size() + y.Size());
+        MulS(r, x, y, sqr);
+    }
+    return r;
+}
+
+/*
+    toom-3 (toom-cook 3-way), O(n^1.465)
+
+    split each operand into three parts of k limbs, and regard them as
+    polynomials of degree 2 at x = B^k. evaluate at 0, 1, -1, -2, inf,
+    multiply pointwise and interpolate with bodrato's sequence.
+*/
+void Toom3(Limb* r, const Limb* a, const Limb* b, int n, bool sqr)
+{
+    int k = (n + 2) / 3;
+    int hn = n - 2*k; // size of highest part. 0 < hn <= k
+
+    // evaluation
+    auto eval = [&](const Limb* x, SNum& p0, SNum& p1, SNum& pm1, SNum& pm2, SNum& pinf) {
+        SNum x0(x, k), x1(x + k, k), x2(x + 2*k, hn);
+        // p1 = x0 + x1 + x2, pm1 = x0 - x1 + x2
+        SNum t = x0;
+        AddTo(t, x2);
+        p1 = t;
+        AddTo(p1, x1);
+        pm1 = t;
+        AddTo(pm1, x1, true);
+        // pm2 = x0 - 2*x1 + 4*x2 = ((x2*2 - x1)*2 + x0)
+        pm2 = x2;
+        MulSmall(pm2, 2);
+        AddTo(pm2, x1, true);
+        MulSmall(pm2, 2);
+        AddTo(pm2, x0);
+        p0 = std::move(x0);
+        pinf = std::move(x2);
+    };
+
+    SNum a0, a1, am1, am2, ainf;
+    eval(a, a0, a1, am1, am2, ainf);
+    SNum b0, b1, bm1, bm2, binf;
+    if (!sqr)
+        eval(b, b0, b1, bm1, bm2, binf);
+    const SNum& q0 = sqr ? a0 : b0;
+    const SNum& q1 = sqr ? a1 : b1;
+    const SNum& qm1 = sqr ? am1 : bm1;
+    const SNum& qm2 = sqr ? am2 : bm2;
+    const SNum& qinf = sqr ? ainf : binf;
+
+    // pointwise multiplication. five products may run in parallel.
+    const SNum* xs[5] = { &a0, &a1, &am1, &am2, &ainf };
+    const SNum* ys[5] = { &q0, &q1, &qm1, &qm2, &qinf };
+    SNum w[5];
+    for (int i=0; i<5; i++)
+        w[i].mag.resize(xs[i]->Size() + ys[i]->Size());
+    auto product = [&](int i) { MulS(w[i], *xs[i], *ys[i], sqr); };
+    if (Parallel(n))
+        ParallelFor(5, product);
+    else
+        for (int i=0; i<5; i++) product(i);
+    SNum& w0 = w[0];
+    SNum& w1 = w[1];
+    SNum& wm1 = w[2];
+    SNum& wm2 = w[3];
+    SNum& w4 = w[4];
+
+    // interpolation (bodrato)
+    SNum& w3 = wm2;             // w3 = (wm2 - w1) / 3
+    AddTo(w3, w1, true);
+    DivExact(w3, 3);
+    AddTo(w1, wm1, true);       // w1 = (w1 - wm1) / 2
+    DivExact(w1, 2);
+    SNum t = wm1;               // t = wm1 - w0
+    AddTo(t, w0, true);
+    AddTo(w3, t, true);         // w3 = (t - w3) / 2 + 2*w4
+    w3.neg = !w3.neg && w3.Size();
+    DivExact(w3, 2);
+    AddTo(w3, w4);
+    AddTo(w3, w4);
+    AddTo(t, w1);               // w2 = t + w1 - w4
+    AddTo(t, w4, true);
+    SNum& w2i = t;
+    AddTo(w1, w3, true);        // w1 = w1 - w3
+
+    // recomposition: r = w0 + w1*x + w2*x^2 + w3*x^3 + w4*x^4, x = B^k
+    // all coefficients are non-negative here.
+    std::fill(r, r + 2*n, Limb(0));
+    const SNum* coef[5] = { &w0, &w1, &w2i, &w3, &w4 };
+    for (int i=0; i<5; i++) {
+        const SNum& c = *coef[i];
+        int off = i * k;
+        if (c.Size() && off < 2*n)
+            Add(r + off, r + off, 2*n - off, c.mag.data(), c.Size());
+    }
+}
+
+void MulN(Limb* r, const Limb* a, const Limb* b, int n)
+{
+    if (a == b)
+        SqrN(r, a, n);
+    else if (n < PYCFG_BIGINT_MUL_KARATSUBA_CUTOFF)
+        MulBasecase(r, a, n, b, n);
+    else if (n < PYCFG_BIGINT_MUL_TOOM3_CUTOFF)
+        Karatsuba(r, a, b, n, false);
+    else if (n < PYCFG_BIGINT_MUL_NTT_CUTOFF || 2*n - 1 > kNttMaxSize)
+        Toom3(r, a, b, n, false);
+    else
+        MulNtt(r, a, n, b, n);
+}
+
+void SqrN(Limb* r, const Limb* a, int n)
+{
+    if (n < PYCFG_BIGINT_SQR_KARATSUBA_CUTOFF)
+        SqrBasecase(r, a, n);
+    else if (n < PYCFG_BIGINT_SQR_TOOM3_CUTOFF)
+        Karatsuba(r, a, a, n, true);
+    else if (n < PYCFG_BIGINT_SQR_NTT_CUTOFF || 2*n - 1 > kNttMaxSize)
+        Toom3(r, a, a, n, true);
+    else
+        MulNtt(r, a, n, a, n);
+}
+
+
+//-------------------------------------
+// number theoretic transform
+
+/*
+    NTT friendly primes, p = c * 2^k + 1.
+    product of them is about 2^90.47, which is bigger than
+    any convolution term of two limb arrays: min(an,bn) * (2^32-1)^2 < 2^25 * 2^64.
+*/
+struct NttPrime {
+    uint32_t p;
+    uint32_t g; // primitive root
+};
+constexpr NttPrime kNttPrimes[3] = {
+    { 2013265921, 31 }, // 15 * 2^27 + 1
+    {  469762049,  3 }, //  7 * 2^26 + 1
+    { 1811939329, 13 }, // 27 * 2^26 + 1
+};
+
+uint32_t PowMod(uint32_t a, uint64_t e, uint32_t p)
+{
+    uint64_t r = 1, x = a % p;
+    for (; e; e >>= 1) {
+        if (e & 1) r = r * x % p;
+        x = x * x % p;
+    }
+    return (uint32_t)r;
+}
+
+/*
+    montgomery arithmetic with R = 2^32, for odd p < 2^31.
+    values are kept in [0, p).
+    Mul(a, b) returns a * b / R, so if one operand is in montgomery form,
+    result is plain a * b.
+*/
+struct Mont32 {
+    uint32_t p;
+    uint32_t pinv; // -p^-1 mod 2^32
+
+    explicit Mont32(uint32_t p_): p(p_) {
+        uint32_t inv = p; // p*p == 1 mod 8. each newton step doubles the bits.
+        for (int k=0; k<4; k++) inv *= 2 - p * inv;
+        pinv = 0U - inv;
+    }
+    uint32_t Reduce(uint64_t x) const { // x < p * 2^32
+        uint32_t m = (uint32_t)x * pinv;
+        uint32_t t = (uint32_t)((x + (uint64_t)m * p) >> 32);
+        return t >= p ? t - p : t;
+    }
+    uint32_t Mul(uint32_t a, uint32_t b) const { return Reduce((uint64_t)a * b); }
+    uint32_t ToMont(uint32_t a) const { return (uint32_t)(((uint64_t)a << 32) % p); }
+    uint32_t Add(uint32_t a, uint32_t b) const { uint32_t s = a + b; return s >= p ? s - p : s; }
+    uint32_t Sub(uint32_t a, uint32_t b) const { return a >= b ? a - b : a + p - b; }
+};
+
+/*
+    root table for transform of length n, in montgomery form.
+    rt[len + j] = w^j, where w is primitive (2*len)-th root of unity. (len = 1, 2, 4, .. n/2)
+*/
+ScratchVec<uint32_t> NttRoots(const Mont32& m, uint32_t g, int n, bool inverse)
+{
+    ScratchVec<uint32_t> rt(std::max(n, 2));
+    for (int len=1; len<n; len<<=1) {
+        uint32_t w = PowMod(g, (m.p - 1) / (2 * len), m.p);
+        if (inverse) w = PowMod(w, m.p - 2, m.p);
+        uint32_t wm = m.ToMont(w);
+        uint32_t cur = m.ToMont(1);
+        for (int j=0; j<len; j++) {
+            rt[len + j] = cur;
+            cur = m.Mul(cur, wm); // stays in montgomery form, since both are.
+        }
+    }
+    return rt;
+}
+
+/*
+    forward transform, decimation in frequency. (gentleman-sande)
+    input in natural order, output in bit-reversed order.
+*/
+void NttForwardSeq(uint32_t* a, int n, const uint32_t* rt, const Mont32& mont)
+{
+    const Mont32 m = mont; // local copy, so that stores into a[] do not alias with it.
+    for (int len=n/2; len>=1; len>>=1) {
+        for (int i=0; i<n; i+=2*len) {
+            uint32_t* x = a + i;
+            uint32_t* y = a + i + len;
+            const uint32_t* w = rt + len;
+            for (int j=0; j<len; j++) {
+                uint32_t u = x[j], v = y[j];
+                x[j] = m.Add(u, v);
+                y[j] = m.Mul(m.Sub(u, v), w[j]);
+            }
+        }
+    }
+}
+
+/*
+    inverse transform (without 1/n scaling), decimation in time. (cooley-tukey)
+    input in bit-reversed order, output in natural order.
+*/
+void NttInverseSeq(uint32_t* a, int n, const uint32_t* irt, const Mont32& mont)
+{
+    const Mont32 m = mont;
+    for (int len=1; len<n; len<<=1) {
+        for (int i=0; i<n; i+=2*len) {
+            uint32_t* x = a + i;
+            uint32_t* y = a + i + len;
+            const uint32_t* w = irt + len;
+            for (int j=0; j<len; j++) {
+                uint32_t u = x[j], v = m.Mul(y[j], w[j]);
+                x[j] = m.Add(u, v);
+                y[j] = m.Sub(u, v);
+            }
+        }
+    }
+}
+
+/*
+    butterflies [q0, q1) of one stage, where q = i * len + j is
+    j-th butterfly of i-th block. used to split a stage into tasks.
+*/
+template <bool bInverse>
+void NttStage(uint32_t* a, int len, int q0, int q1, const uint32_t* rt, const Mont32& mont)
+{
+    const Mont32 m = mont;
+    const uint32_t* w = rt + len;
+    while (q0 < q1) {
+        int i = q0 / len, j = q0 % len;
+        int e = std::min(len, j + (q1 - q0));
+        uint32_t* x = a + 2 * i * len;
+        uint32_t* y = x + len;
+        q0 += e - j;
+        for (; j<e; j++) {
+            if constexpr (bInverse) {
+                uint32_t u = x[j], v = m.Mul(y[j], w[j]);
+                x[j] = m.Add(u, v);
+                y[j] = m.Sub(u, v);
+            }
+            else {
+                uint32_t u = x[j], v = y[j];
+                x[j] = m.Add(u, v);
+                y[j] = m.Mul(m.Sub(u, v), w[j]);
+            }
+        }
+    }
+}
+
+/*
+    in parallel mode, top stages have only a few big blocks, so each stage
+    is split by butterflies. once there are enough blocks, each task
+    transforms its own blocks through remaining stages. inverse goes reverse.
+*/
+void NttForward(uint32_t* a, int n, const uint32_t* rt, const Mont32& m)
+{
+    if (!Parallel(n)) {
+        NttForwardSeq(a, n, rt, m);
+        return;
+    }
+    const int tasks = 4 * ThreadCount();
+    int len = n / 2;
+    for (; len >= 1 && n / (2*len) < tasks; len >>= 1)
+        ForRange(n / 2, [&](int q0, int q1) { NttStage<false>(a, len, q0, q1, rt, m); });
+    if (len < 1)
+        return;
+    const int bs = 2 * len;
+    ForRange(n / bs, [&](int b0, int b1) {
+        for (int i=b0; i<b1; i++) NttForwardSeq(a + i * bs, bs, rt, m);
+    });
+}
+
+void NttInverse(uint32_t* a, int n, const uint32_t* irt, const Mont32& m)
+{
+    if (!Parallel(n)) {
+        NttInverseSeq(a, n, irt, m);
+        return;
+    }
+    const int tasks = 4 * ThreadCount();
+    int bs = n;
+    while (bs > 1 && n / bs < tasks) bs >>= 1;
+    ForRange(n / bs, [&](int b0, int b1) {
+        for (int i=b0; i<b1; i++) NttInverseSeq(a + i * bs, bs, irt, m);
+    });
+    for (int len=bs; len<n; len<<=1)
+        ForRange(n / 2, [&](int q0, int q1) { NttStage<true>(a, len, q0, q1, irt, m); });
+}
+
+/*
+    cyclic convolution of a and b modulo given prime, into f[0..n).
+    f should have n elements already. (it may run on other thread)
+*/
+void NttConvolve(uint32_t* f, const Limb* a, int an, const Limb* b, int bn,
+    int n, const NttPrime& prime)
+{
+    Mont32 m(prime.p);
+    auto rt = NttRoots(m, prime.g, n, false);
+    auto irt = NttRoots(m, prime.g, n, true);
+
+    // Mul(x, R) == x mod p, without division.
+    const uint32_t one = m.ToMont(1);
+    auto load = [&](uint32_t* x, const Limb* p, int pn) {
+        ForRange(n, [&](int k0, int k1) {
+            int e = std::clamp(pn, k0, k1);
+            for (int k=k0; k<e; k++) x[k] = m.Mul(p[k], one);
+            std::fill(x + e, x + k1, 0);
+        });
+    };
+    load(f, a, an);
+    NttForward(f, n, rt.data(), m);
+
+    if (a == b && an == bn) {
+        ForRange(n, [&](int k0, int k1) {
+            for (int k=k0; k<k1; k++) f[k] = m.Mul(f[k], f[k]);
+        });
+    }
+    else {
+        ScratchVec<uint32_t> g(n);
+        load(g.data(), b, bn);
+        NttForward(g.data(), n, rt.data(), m);
+        ForRange(n, [&](int k0, int k1) {
+            for (int k=k0; k<k1; k++) f[k] = m.Mul(f[k], g[k]);
+        });
+    }
+    NttInverse(f, n, irt.data(), m);
+
+    // each pointwise Mul() left 1/R, and inverse transform left n.
+    // multiply n^-1 * R^2 in montgomery form to get plain result.
+    uint32_t ninv = PowMod(n, m.p - 2, m.p);
+    uint32_t scale = m.ToMont(m.ToMont(ninv));
+    ForRange(n, [&](int k0, int k1) {
+        for (int k=k0; k<k1; k++) f[k] = m.Mul(f[k], scale);
+    });
+}
+
+} // namespace
+
+
+void MulNtt(Limb* r, const Limb* a, int an, const Limb* b, int bn)
+{
+    const int rn = an + bn;
+    int n = 1;
+    while (n < rn - 1) n <<= 1;
+
+    // three primes are independent, so they may run in parallel.
+    ScratchVec<uint32_t> f[3];
+    for (int i=0; i<3; i++)
+        f[i].resize(n);
+    auto convolve = [&](int i) { NttConvolve(f[i].data(), a, an, b, bn, n, kNttPrimes[i]); };
+    if (Parallel(n))
+        ParallelFor(3, convolve);
+    else
+        for (int i=0; i<3; i++) convolve(i);
+
+    /*
+        CRT by garner's algorithm.
+            x = v1 + v2*p1 + v3*p1*p2
+        then add x into result with carry propagation.
+    */
+    const uint64_t p1 = kNttPrimes[0].p, p2 = kNttPrimes[1].p, p3 = kNttPrimes[2].p;
+    const uint64_t p12 = p1 * p2;
+    const Mont32 m2((uint32_t)p2), m3((uint32_t)p3);
+    // all modular operations below are done in montgomery arithmetic, to avoid division.
+    const uint32_t one2 = m2.ToMont(1);
+    const uint32_t r2p3 = m3.ToMont(m3.ToMont(1)); // R^2 mod p3
+    const uint32_t p1inv = m2.ToMont(PowMod((uint32_t)(p1 % p2), p2 - 2, (uint32_t)p2));     // p1^-1 mod p2
+    const uint32_t p12inv = m3.ToMont(PowMod((uint32_t)(p12 % p3), p3 - 2, (uint32_t)p3));   // (p1*p2)^-1 mod p3
+
+    // v2 = (x2 - v1) / p1 mod p2
+    auto garner2 = [&](uint32_t v1, uint32_t x2) {
+        return m2.Mul(m2.Sub(x2, m2.Mul(v1, one2)), p1inv);
+    };
+    // v3 = (x3 - lo) / (p1*p2) mod p3, where lo < 2^60
+    auto garner3 = [&](uint64_t lo, uint32_t x3) {
+        return m3.Mul(m3.Sub(x3, m3.Mul(m3.Reduce(lo), r2p3)), p12inv);
+    };
+
+    /*
+        r[k0..k1) from terms [k0, k1), starting with zero carry.
+        carry out of r[k1-1] is left in c[0..kCarry), to be added later.
+    */
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    constexpr int kCarry = 20; // 2^64 < 10^20
+#else
+    constexpr int kCarry = 3;
+#endif
+    auto crt = [&](int k0, int k1, Limb* c) {
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+        // every term is less than n * 81, so v3 is always zero.
+        (void)garner3;
+        uint64_t acc = 0;
+        for (int k=k0; k<k1; k++) {
+            if (k < rn - 1) {
+                uint64_t v1 = f[0][k];
+                uint64_t v2 = garner2(f[0][k], f[1][k]);
+                acc += v1 + v2 * p1;
+            }
+            r[k] = Limb(acc % kBase);
+            acc /= kBase;
+        }
+        for (int k=0; k<kCarry; k++, acc /= kBase)
+            c[k] = Limb(acc % kBase);
+#else
+        const uint64_t kMask = 0xffffffffULL;
+        const uint64_t q0 = p12 & kMask, q1 = p12 >> 32;
+        uint64_t c0 = 0, c1 = 0, c2 = 0; // 96-bit carry, in 32-bit pieces
+        for (int k=k0; k<k1; k++) {
+            uint64_t e0 = 0, e1 = 0, t = 0, u = 0;
+            if (k < rn - 1) {
+                uint64_t v1 = f[0][k];
+                uint64_t v2 = garner2(f[0][k], f[1][k]);
+                uint64_t lo = v1 + v2 * p1; // < p1 * p2 < 2^60
+                uint64_t v3 = garner3(lo, f[2][k]);
+                e0 = lo & kMask;
+                e1 = lo >> 32;
+                t = v3 * q0;
+                u = v3 * q1;
+            }
+            uint64_t s0 = e0 + (t & kMask) + c0;
+            uint64_t s1 = e1 + (t >> 32) + (u & kMask) + c1 + (s0 >> 32);
+            uint64_t s2 = (u >> 32) + c2 + (s1 >> 32);
+            r[k] = Limb(s0 & kMask);
+            c0 = s1 & kMask;
+            c1 = s2 & kMask;
+            c2 = s2 >> 32;
+        }
+        c[0] = Limb(c0);
+        c[1] = Limb(c1);
+        c[2] = Limb(c2);
+#endif
+    };
+
+    if (!Parallel(rn)) {
+        Limb c[kCarry];
+        crt(0, rn, c); // whole product fits in rn limbs, so no carry out.
+        return;
+    }
+    // slices with their own carries, then carries are added in order.
+    const int tasks = std::min(4 * ThreadCount(), rn);
+    auto bound = [&](int t) { return (int)((long long)rn * t / tasks); };
+    LimbVec carry(tasks * kCarry);
+    ParallelFor(tasks, [&](int t) { crt(bound(t), bound(t + 1), carry.data() + t * kCarry); });
+    for (int t=0; t<tasks-1; t++) {
+        int k = bound(t + 1);
+        int cn = NormSize(carry.data() + t * kCarry, kCarry);
+        if (cn > 0)
+            Add(r + k, r + k, rn - k, carry.data() + t * kCarry, std::min(cn, rn - k));
+    }
+}
+
+
+/*
+    schoolbook multiplication, O(an*bn)
+*/
+void MulBasecase(Limb* r, const Limb* a, int an, const Limb* b, int bn)
+{
+    r[an] = Mul1(r, a, an, b[0]);
+    for (int j=1; j<bn; j++)
+        r[an + j] = AddMul1(r + j, a, an, b[j]);
+}
+
+/*
+    schoolbook squaring.
+    each cross product a[i]*a[j] (i<j) is calculated only once and doubled,
+    so it takes about half of MulBasecase().
+*/
+void SqrBasecase(Limb* r, const Limb* a, int n)
+{
+    std::fill(r, r + 2*n, Limb(0));
+    for (int i=0; i<n-1; i++)
+        r[n + i] = AddMul1(r + 2*i + 1, a + i + 1, n - i - 1, a[i]);
+    // double the cross products
+    AddN(r, r, r, 2*n);
+    // add diagonal a[i]^2
+    Limb carry = 0;
+    for (int i=0; i<n; i++) {
+        DLimb sq = (DLimb)a[i] * a[i];
+        DLimb lo = (DLimb)r[2*i] + sq % kBase + carry;
+        r[2*i] = Limb(lo % kBase);
+        DLimb hi = (DLimb)r[2*i + 1] + sq / kBase + lo / kBase;
+        r[2*i + 1] = Limb(hi % kBase);
+        carry = Limb(hi / kBase);
+    }
+}
+
+void MulKaratsuba(Limb* r, const Limb* a, const Limb* b, int n)
+{
+    if (n < 2)
+        MulBasecase(r, a, n, b, n);
+    else
+        Karatsuba(r, a, b, n, a == b);
+}
+
+void MulToom3(Limb* r, const Limb* a, const Limb* b, int n)
+{
+    if (n < 3)
+        MulBasecase(r, a, n, b, n);
+    else
+        Toom3(r, a, b, n, a == b);
+}
+
+void Mul(Limb* r, const Limb* a, int an, const Limb* b, int bn)
+{
+    if (an == bn) {
+        MulN(r, a, b, an);
+        return;
+    }
+    if (bn < PYCFG_BIGINT_MUL_KARATSUBA_CUTOFF) {
+        MulBasecase(r, a, an, b, bn);
+        return;
+    }
+    if (bn >= PYCFG_BIGINT_MUL_NTT_CUTOFF && an + bn - 1 <= kNttMaxSize) {
+        // NTT does not require balanced operands.
+        MulNtt(r, a, an, b, bn);
+        return;
+    }
+    /*
+        unbalanced operands.
+        split a into chunks of bn limbs, and accumulate chunk * b.
+    */
+    MulN(r, a, b, bn);
+    std::fill(r + 2*bn, r + an + bn, Limb(0));
+    LimbVec tmp(2*bn);
+    for (int off=bn; off<an; off+=bn) {
+        int cn = std::min(bn, an - off);
+        if (cn == bn)
+            MulN(tmp.data(), a + off, b, bn);
+        else
+            Mul(tmp.data(), b, bn, a + off, cn);
+        Add(r + off, r + off, an + bn - off, tmp.data(), cn + bn);
+    }
+}
+
+void Sqr(Limb* r, const Limb* a, int n)
+{
+    SqrN(r, a, n);
+}
+
+
+
+//----------------------------------------------------------------------------
+// division
+
+/*
+    knuth, TAOCP vol.2, 4.3.1 algorithm D. O((an-bn) * bn)
+*/
+void DivRemKnuth(Limb* q, Limb* r, const Limb* a, int an, const Limb* b, int bn)
+{
+    if (bn == 1) {
+        r[0] = DivRem1(q, a, an, b[0]);
+        return;
+    }
+    // D1. normalize, so that top limb of divisor is at least kBase/2.
+    // d is not a power of 2, so that it works for any base.
+    Limb d = Limb(kBase / ((DLimb)b[bn-1] + 1));
+    LimbVec u(an + 1), v(bn);
+    u[an] = Mul1(u.data(), a, an, d);
+    Mul1(v.data(), b, bn, d);
+
+    const DLimb vtop = v[bn-1], vnext = v[bn-2];
+    for (int j=an-bn; j>=0; j--) {
+        // D3. estimate qhat from top two limbs, and correct it with next limb.
+        // after correction, qhat is exact or one too large.
+        DLimb num = (DLimb)u[j+bn] * kBase + u[j+bn-1];
+        DLimb qhat = num / vtop;
+        DLimb rhat = num % vtop;
+        while (qhat >= kBase || qhat * vnext > rhat * kBase + u[j+bn-2]) {
+            qhat--;
+            rhat += vtop;
+            if (rhat >= kBase) break;
+        }
+        // D4. multiply and subtract
+        Limb borrow = SubMul1(&u[j], v.data(), bn, Limb(qhat));
+        if (u[j+bn] < borrow) {
+            // D6. add back. (rare) carry out of it cancels the borrow.
+            AddN(&u[j], &u[j], v.data(), bn);
+            qhat--;
+        }
+        // partial remainder is less than v, so top limb is always zero now.
+        u[j+bn] = 0;
+        q[j] = Limb(qhat);
+    }
+    // D8. unnormalize remainder
+    DivRem1(r, u.data(), bn, d);
+}
+
+
+namespace {
+
+/*
+    burnikel & ziegler, "fast recursive division" (1998)
+
+    Div2n1n: a[0..2n) / b[0..n) -> q[0..n), r[0..n)
+    Div3n2n: a[0..3h) / b[0..2h) -> q[0..h), r[0..2h)
+
+    divisor b should be normalized (top limb >= kBase/2), and a < b * B^n (or B^h).
+*/
+void Div3n2n(Limb* q, Limb* r, const Limb* a, const Limb* b, int h);
+
+void Div2n1n(Limb* q, Limb* r, const Limb* a, const Limb* b, int n)
+{
+    if (n % 2 || n < PYCFG_BIGINT_DIV_BZ_BASECASE) {
+        LimbVec qq(n + 1);
+        DivRemKnuth(qq.data(), r, a, 2*n, b, n);
+        std::copy(qq.begin(), qq.begin() + n, q); // qq[n] is zero since a < b * B^n
+        return;
+    }
+    int h = n / 2;
+    // [A1 A2 A3] / b -> q1, r1
+    LimbVec t(3*h);
+    Div3n2n(q + h, t.data() + h, a + h, b, h);
+    // [r1 A4] / b -> q2, r
+    std::copy(a, a + h, t.begin());
+    Div3n2n(q, r, t.data(), b, h);
+}
+
+void Div3n2n(Limb* q, Limb* r, const Limb* a, const Limb* b, int h)
+{
+    const Limb* b1 = b + h;  // high half
+    const Limb* b2 = b;      // low half
+
+    // x = r1 * B^h + A3, where r1 may have h+1 limbs.
+    LimbVec x(2*h + 1);
+    std::copy(a, a + h, x.begin());
+
+    if (Cmp(a + 2*h, h, b1, h) < 0) {
+        // [A1 A2] / b1 -> qhat, r1
+        Div2n1n(q, x.data() + h, a + h, b1, h);
+    }
+    else {
+        // since a < b * B^h, A1 == b1 here.
+        // qhat = B^h - 1, r1 = [A1 A2] - qhat * b1 = A2 + b1
+        for (int k=0; k<h; k++) q[k] = kLimbMax;
+        x[2*h] = AddN(x.data() + h, a + h, b1, h);
+    }
+
+    // rhat = x - qhat * b2
+    LimbVec d(2*h);
+    Mul(d.data(), q, h, b2, h);
+    if (x[2*h] || Cmp(x.data(), 2*h, d.data(), 2*h) >= 0) {
+        Sub(x.data(), x.data(), 2*h + 1, d.data(), 2*h);
+        std::copy(x.begin(), x.begin() + 2*h, r);
+        return;
+    }
+    // rhat is negative. add b back until it is not. (at most twice)
+    SubN(d.data(), d.data(), x.data(), 2*h); // d = -rhat
+    const Limb one = 1;
+    for (;;) {
+        Sub(q, q, h, &one, 1);
+        if (Cmp(d.data(), 2*h, b, 2*h) <= 0) {
+            SubN(r, b, d.data(), 2*h);
+            break;
+        }
+        SubN(d.data(), d.data(), b, 2*h);
+    }
+}
+
+/*
+    quotient is much shorter than divisor.
+    divide only the top limbs to estimate quotient, then correct it
+    with one full-size multiplication. O(M(bn))
+*/
+void DivRemShortQuotient(Limb* q, Limb* r, const Limb* a, int an, const Limb* b, int bn)
+{
+    const int qn = an - bn + 1;
+    const int k = bn - qn - 1; // number of low limbs to drop
+
+    // qhat = a_hi / b_hi, which is close to the quotient.
+    {
+        LimbVec rtmp(qn + 1);
+        DivRem(q, rtmp.data(), a + k, an - k, b + k, bn - k);
+    }
+
+    // p = qhat * b, compared with a.
+    const Limb one = 1;
+    LimbVec p(an + 1);
+    int qs = NormSize(q, qn);
+    if (qs)
+        Mul(p.data(), b, bn, q, qs);
+    int pn = NormSize(p.data(), an + 1);
+    int as = NormSize(a, an);
+    while (Cmp(p.data(), pn, a, as) > 0) {
+        // qhat was too large.
+        Sub(q, q, qn, &one, 1);
+        Sub(p.data(), p.data(), pn, b, bn);
+        pn = NormSize(p.data(), pn);
+    }
+    // r = a - p, then qhat may be too small.
+    LimbVec rr(an);
+    Sub(rr.data(), a, an, p.data(), pn);
+    int rn = NormSize(rr.data(), an);
+    while (Cmp(rr.data(), rn, b, bn) >= 0) {
+        Add(q, q, qn, &one, 1);
+        Sub(rr.data(), rr.data(), rn, b, bn);
+        rn = NormSize(rr.data(), rn);
+    }
+    std::copy(rr.begin(), rr.begin() + bn, r);
+}
+
+} // namespace
+
+
+/*
+    recursive division, O(M(n) log n)
+
+    divisor is padded to n = j * 2^k limbs (j <= basecase) and normalized,
+    so that Div2n1n() can halve it down to the basecase.
+    then dividend is divided n limbs at a time, like schoolbook long division.
+*/
+void DivRemBZ(Limb* q, Limb* r, const Limb* a, int an, const Limb* b, int bn)
+{
+    int m = 1;
+    while (bn > m * PYCFG_BIGINT_DIV_BZ_BASECASE) m *= 2;
+    const int n = (bn + m - 1) / m * m;
+    const int s = n - bn; // limb shift
+
+    // scale both by d * B^s. quotient is not changed.
+    Limb d = Limb(kBase / ((DLimb)b[bn-1] + 1));
+    LimbVec bb(n, 0);
+    Mul1(bb.data() + s, b, bn, d);
+
+    const int t = (an + s + 1 + n - 1) / n; // number of blocks
+    LimbVec aa(t * n, 0);
+    aa[s + an] = Mul1(aa.data() + s, a, an, d);
+
+    LimbVec qq(t * n, 0);
+    LimbVec blk(2 * n, 0); // [next block, remainder]
+    int i = t - 1;
+    if (Cmp(aa.data() + i*n, n, bb.data(), n) < 0) {
+        // top block is already less than divisor. use it as first remainder.
+        std::copy(aa.begin() + i*n, aa.end(), blk.begin() + n);
+        i--;
+    }
+    for (; i>=0; i--) {
+        std::copy(aa.begin() + i*n, aa.begin() + (i+1)*n, blk.begin());
+        Div2n1n(qq.data() + i*n, blk.data() + n, blk.data(), bb.data(), n);
+    }
+    std::copy(qq.begin(), qq.begin() + (an - bn + 1), q);
+
+    // remainder is also scaled by d * B^s. its low s limbs are zero.
+    DivRem1(r, blk.data() + n + s, bn, d);
+}
+
+void DivRem(Limb* q, Limb* r, const Limb* a, int an, const Limb* b, int bn)
+{
+    const int qn = an - bn + 1;
+    if (bn == 1)
+        r[0] = DivRem1(q, a, an, b[0]);
+    else if (bn < PYCFG_BIGINT_DIV_BZ_CUTOFF || qn < PYCFG_BIGINT_DIV_BZ_CUTOFF)
+        DivRemKnuth(q, r, a, an, b, bn);
+    else if (2*qn < bn)
+        DivRemShortQuotient(q, r, a, an, b, bn);
+    else
+        DivRemBZ(q, r, a, an, b, bn);
+}
+
+
+
+//----------------------------------------------------------------------------
+// modular arithmetic
+
+namespace {
+
+// x such that m0 * x == 1 mod kBase. m0 should be prime to kBase.
+Limb InvLimb(Limb m0)
+{
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    for (Limb x=1; x<kBase; x++)
+        if (DLimb(m0) * x % kBase == 1) return x;
+    return 0;
+#else
+    // newton iteration. m0 * m0 == 1 mod 8, and each step doubles correct bits.
+    Limb x = m0;
+    for (int k=0; k<4; k++)
+        x *= 2 - m0 * x;
+    return x;
+#endif
+}
+
+// all ones if c, otherwise zero. no branch.
+inline Limb MaskIf(Limb c)
+{
+    return Limb(0) - Limb(c != 0);
+}
+
+// r[0..n) = mask ? a : r
+inline void Select(Limb* r, const Limb* a, int n, Limb mask)
+{
+    for (int k=0; k<n; k++)
+        r[k] = Limb((r[k] & ~mask) | (a[k] & mask));
+}
+
+// 32-bit words of e[0..en), least significant first.
+ScratchVec<uint32_t> BinaryWords(const Limb* e, int en)
+{
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    // divisor should be one limb. 3 bits at a time, by 8.
+    ScratchVec<uint32_t> w;
+    LimbVec q(e, e + en);
+    int n = NormSize(q.data(), en);
+    for (int nb=0; n>0; ) {
+        uint32_t v = DivRem1(q.data(), q.data(), n, 8);
+        n = NormSize(q.data(), n);
+        for (int k=0; k<3; k++, nb++) {
+            if (nb % 32 == 0) w.push_back(0);
+            w.back() |= ((v >> k) & 1) << (nb % 32);
+        }
+    }
+    return w;
+#else
+    return ScratchVec<uint32_t>(e, e + NormSize(e, en));
+#endif
+}
+
+} // namespace
+
+ModCtx::ModCtx(const Limb* m, int n):
+    m_m(m, m + n), m_n(n)
+{
+    m_m.push_back(0);
+    if (std::gcd(DLimb(m[0]), kBase) == 1)
+        m_minv = Limb(kBase - InvLimb(m[0]));
+
+    // B^(2n) = q * m + r
+    LimbVec num(2*n + 1, 0), q(n + 2), r(n);
+    num[2*n] = 1;
+    DivRem(q.data(), r.data(), num.data(), 2*n + 1, m, n);
+    if (IsMontgomery())
+        m_aux.assign(r.begin(), r.end());
+    else
+        m_aux.assign(q.begin(), q.end());
+
+    // one is B^n mod m, or just 1.
+    m_one.assign(n, 0);
+    if (IsMontgomery()) {
+        LimbVec t(n + 1, 0), qq(2);
+        t[n] = 1;
+        DivRem(qq.data(), m_one.data(), t.data(), n + 1, m, n);
+    }
+    else if (n > 1 || m[0] > 1)
+        m_one[0] = 1;
+}
+
+void ModCtx::One(Limb* r) const
+{
+    std::copy(m_one.begin(), m_one.end(), r);
+}
+
+void ModCtx::ToForm(Limb* r, const Limb* x, int xn, Limb* tp) const
+{
+    const int n = m_n;
+    xn = NormSize(x, xn);
+    LimbVec xr(n, 0);
+    if (Cmp(x, xn, m_m.data(), NormSize(m_m.data(), n)) >= 0) {
+        LimbVec q(xn - n + 1);
+        DivRem(q.data(), xr.data(), x, xn, m_m.data(), n);
+    }
+    else
+        for (int k=0; k<xn; k++) xr[k] = x[k];
+
+    if (IsMontgomery())
+        MulMod(r, xr.data(), m_aux.data(), tp);
+    else
+        std::copy(xr.begin(), xr.end(), r);
+}
+
+void ModCtx::FromForm(Limb* r, const Limb* a, Limb* tp) const
+{
+    const int n = m_n;
+    if (!IsMontgomery()) {
+        std::copy(a, a + n, r);
+        return;
+    }
+    // a * B^n / B^n
+    Limb* t = tp;
+    std::copy(a, a + n, t);
+    std::fill(t + n, t + 2*n, Limb(0));
+    Reduce(r, t, tp + 2*n, false);
+}
+
+void ModCtx::MulMod(Limb* r, const Limb* a, const Limb* b, Limb* tp, bool bConstTime) const
+{
+    const int n = m_n;
+    if (bConstTime)
+        MulBasecase(tp, a, n, b, n);
+    else
+        Mul(tp, a, n, b, n);
+    Reduce(r, tp, tp + 2*n, bConstTime);
+}
+
+void ModCtx::SqrMod(Limb* r, const Limb* a, Limb* tp, bool bConstTime) const
+{
+    const int n = m_n;
+    if (bConstTime)
+        SqrBasecase(tp, a, n);
+    else
+        Sqr(tp, a, n);
+    Reduce(r, tp, tp + 2*n, bConstTime);
+}
+
+/*
+    montgomery: REDC. t + u * m, where u makes low n limbs zero,
+        then t / B^n < 2m, and one conditional subtraction.
+    barrett: q = ((t >> (n-1) limbs) * mu) >> (n+1) limbs, r = t - q * m.
+        q is at most 2 less than exact one, so two conditional subtractions.
+        only low n+1 limbs are needed for r.
+    conditional subtraction is done by masked select, with bConstTime.
+*/
+void ModCtx::Reduce(Limb* r, Limb* t, Limb* tp, bool bConstTime) const
+{
+    const int n = m_n;
+    const Limb* m = m_m.data();
+    if (IsMontgomery()) {
+        DLimb hi = 0;
+        for (int i=0; i<n; i++) {
+            Limb u = Limb(DLimb(t[i]) * m_minv % kBase);
+            DLimb s = (DLimb)t[i + n] + AddMul1(t + i, m, n, u) + hi;
+            t[i + n] = Limb(s % kBase);
+            hi = s / kBase;
+        }
+        Limb borrow = SubN(tp, t + n, m, n);
+        Limb mask = MaskIf(hi | (borrow ^ 1));
+        if (bConstTime) {
+            std::copy(t + n, t + 2*n, r);
+            Select(r, tp, n, mask);
+        }
+        else
+            std::copy(mask ? tp : t + n, (mask ? tp : t + n) + n, r);
+        return;
+    }
+
+    // barrett. mu has n+2 limbs, which may have zero high limbs.
+    const Limb* mu = m_aux.data();
+    Limb* q2 = tp;               // 2n + 3 limbs
+    Limb* p = tp + 2*n + 3;      // 2n + 2 limbs
+    if (bConstTime)
+        MulBasecase(q2, mu, n + 2, t + n - 1, n + 1);
+    else
+        Mul(q2, mu, n + 2, t + n - 1, n + 1);
+    const Limb* q3 = q2 + n + 1; // n + 2 limbs
+    if (bConstTime)
+        MulBasecase(p, q3, n + 2, m, n);
+    else
+        Mul(p, q3, n + 2, m, n);
+    // remainder is less than 3m < B^(n+1), so borrow out is ignored.
+    SubN(t, t, p, n + 1);
+    for (int k=0; k<2; k++) {
+        Limb borrow = SubN(p, t, m, n + 1);
+        if (bConstTime)
+            Select(t, p, n + 1, MaskIf(borrow ^ 1));
+        else if (!borrow)
+            std::copy(p, p + n + 1, t);
+    }
+    std::copy(t, t + n, r);
+}
+
+void PowMod(Limb* r, const Limb* b, int bn, const Limb* e, int en,
+        const ModCtx& ctx, bool bConstTime)
+{
+    const int n = ctx.Size();
+    LimbVec tp(ctx.WorkSize());
+    LimbVec g(n);
+    ctx.ToForm(g.data(), b, bn, tp.data());
+
+    auto words = BinaryWords(e, en);
+    int ebits = 32 * (int)words.size();
+    auto bit = [&](int i) { return int(words[i / 32] >> (i % 32)) & 1; };
+
+    if (bConstTime) {
+        // fixed window. 2^w table entries of b^0 .. b^(2^w - 1).
+        const int w = 4;
+        LimbVec tbl(n << w), sel(n);
+        ctx.One(tbl.data());
+        std::copy(g.begin(), g.end(), tbl.begin() + n);
+        for (int k=2; k<(1 << w); k++)
+            ctx.MulMod(&tbl[k * n], &tbl[(k - 1) * n], g.data(), tp.data(), true);
+
+        ctx.One(r);
+        for (int i=(ebits + w - 1) / w * w - w; i>=0; i-=w) {
+            for (int k=0; k<w; k++)
+                ctx.SqrMod(r, r, tp.data(), true);
+            uint32_t idx = 0;
+            for (int k=w-1; k>=0; k--)
+                idx = (idx << 1) | (i + k < ebits ? bit(i + k) : 0);
+            // read every entry, and keep only one.
+            std::fill(sel.begin(), sel.end(), Limb(0));
+            for (uint32_t j=0; j<(1u << w); j++)
+                Select(sel.data(), &tbl[j * n], n, MaskIf(Limb(j == idx)));
+            ctx.MulMod(r, r, sel.data(), tp.data(), true);
+        }
+    }
+    else {
+        // sliding window. table of odd powers b^1, b^3, .. b^(2^w - 1).
+        while (ebits > 0 && !bit(ebits - 1)) ebits--;
+        const int w = ebits <= 8 ? 1 : ebits <= 24 ? 2 : ebits <= 80 ? 3 :
+            ebits <= 240 ? 4 : ebits <= 672 ? 5 : 6;
+        LimbVec tbl(n << (w - 1)), g2(n);
+        std::copy(g.begin(), g.end(), tbl.begin());
+        if (w > 1) {
+            ctx.SqrMod(g2.data(), g.data(), tp.data());
+            for (int k=1; k<(1 << (w - 1)); k++)
+                ctx.MulMod(&tbl[k * n], &tbl[(k - 1) * n], g2.data(), tp.data());
+        }
+
+        ctx.One(r);
+        bool bFirst = true;
+        for (int i=ebits-1; i>=0; ) {
+            if (!bit(i)) {
+                ctx.SqrMod(r, r, tp.data());
+                i--;
+                continue;
+            }
+            // longest window ending with 1 bit.
+            int j = std::max(i - w + 1, 0);
+            while (!bit(j)) j++;
+            int val = 0;
+            for (int k=i; k>=j; k--)
+                val = (val << 1) | bit(k);
+            if (bFirst) {
+                std::copy(&tbl[(val >> 1) * n], &tbl[(val >> 1) * n] + n, r);
+                bFirst = false;
+            }
+            else {
+                for (int k=j; k<=i; k++)
+                    ctx.SqrMod(r, r, tp.data());
+                ctx.MulMod(r, r, &tbl[(val >> 1) * n], tp.data());
+            }
+            i = j - 1;
+        }
+    }
+    ctx.FromForm(r, r, tp.data());
+}
+
+
+//----------------------------------------------------------------------------
+// gcd
+
+namespace {
+
+/*
+    2x2 matrix of euclid steps, (a, b) of now = R * (a, b) of start.
+    entries are signed, and determinant is +-1.
+*/
+struct GcdMat {
+    SNum r[4];
+    LimbVec tmp[2];     // scratch of MatMulSmall
+    bool sgn[2];
+
+    GcdMat() {
+        const Limb one = 1;
+        r[0] = SNum(&one, 1);
+        r[3] = SNum(&one, 1);
+    }
+};
+
+/*
+    one division step. (a, b) = (b, a mod b). b should not be zero.
+    R = [[0, 1], [1, -q]] * R
+*/
+void GcdDivStep(LimbVec& a, LimbVec& b, GcdMat* R)
+{
+    int an = (int)a.size(), bn = (int)b.size();
+    LimbVec q(an - bn + 1), r(bn);
+    DivRem(q.data(), r.data(), a.data(), an, b.data(), bn);
+    r.resize(NormSize(r.data(), bn));
+    a.swap(b);
+    b.swap(r);
+    if (R) {
+        SNum sq(q.data(), (int)q.size());
+        for (int j=0; j<2; j++) {
+            SNum t = R->r[j];
+            AddTo(t, MulS(sq, R->r[2 + j], false), true);
+            R->r[j] = std::move(R->r[2 + j]);
+            R->r[2 + j] = std::move(t);
+        }
+    }
+}
+
+#if !defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+
+/*
+    R = [[A, B], [C, D]] * R, for small entries.
+    signs alternate in both of L and R (as euclid's matrices do),
+    so two terms of each entry have same sign and magnitudes just add.
+*/
+void MatMulSmall(GcdMat& R, const int64_t L[4])
+{
+    const Limb aL[4] = { Limb(std::abs(L[0])), Limb(std::abs(L[1])),
+            Limb(std::abs(L[2])), Limb(std::abs(L[3])) };
+    for (int j=0; j<2; j++) {
+        SNum& u = R.r[j];
+        SNum& v = R.r[2 + j];
+        int un = u.Size(), vn = v.Size(), n = std::max(un, vn);
+        for (int i=0; i<2; i++) {
+            LimbVec& t = R.tmp[i];
+            const Limb x = aL[2 * i], y = aL[2 * i + 1];
+            bool neg = (x && un) ? (L[2 * i] < 0) != u.neg : (L[2 * i + 1] < 0) != v.neg;
+            t.assign(n + 2, 0);
+            t[un] = Mul1(t.data(), u.mag.data(), un, x);
+            Limb c = AddMul1(t.data(), v.mag.data(), vn, y);
+            for (int k=vn; c; k++) {
+                t[k] += c;
+                c = t[k] < c;
+            }
+            t.resize(NormSize(t.data(), n + 2));
+            R.sgn[i] = neg;
+        }
+        u.mag.swap(R.tmp[0]);
+        v.mag.swap(R.tmp[1]);
+        u.neg = R.sgn[0] && u.Size();
+        v.neg = R.sgn[1] && v.Size();
+    }
+}
+
+// R = R1 * R
+void MatMul(GcdMat& R, const GcdMat& R1)
+{
+    for (int j=0; j<2; j++) {
+        SNum x = MulS(R1.r[0], R.r[j], false), y = MulS(R1.r[2], R.r[j], false);
+        AddTo(x, MulS(R1.r[1], R.r[2 + j], false));
+        AddTo(y, MulS(R1.r[3], R.r[2 + j], false));
+        R.r[j] = std::move(x);
+        R.r[2 + j] = std::move(y);
+    }
+}
+
+int BitLength(const Limb* a, int n)
+{
+    return n ? 32 * (n - 1) + (int)std::bit_width(a[n - 1]) : 0;
+}
+
+// floor(a / 2^e), which should be less than 2^62.
+uint64_t TopBits(const Limb* a, int n, int e)
+{
+    int k = e / 32, sh = e % 32;
+    auto at = [&](int i) { return i < n ? (uint64_t)a[i] : 0; };
+    uint64_t lo = at(k) | (at(k + 1) << 32);
+    uint64_t hi = at(k + 2);
+    return (lo >> sh) | (sh ? hi << (64 - sh) : 0);
+}
+
+/*
+    knuth's algorithm L, on top 62 bits of a and b. (double limb front end)
+    L = [[A, B], [C, D]] makes next remainders of euclid's sequence,
+        (A * a + B * b, C * a + D * b)
+    quotient is taken only if both of bounds of a / b agree on it,
+    and entries are kept within one limb. signs of A, B (and C, D) differ.
+    returns false if no quotient is decided. (then division step is needed)
+*/
+bool LehmerMatrix(const Limb* a, int an, const Limb* b, int bn, int64_t L[4])
+{
+    const int64_t kMax = kLimbMax;
+    int e = std::max(BitLength(a, an) - 62, 0);
+    int64_t u = (int64_t)TopBits(a, an, e), v = (int64_t)TopBits(b, bn, e);
+    int64_t A = 1, B = 0, C = 0, D = 1;
+    while (v + C > 0 && v + D > 0) {
+        int64_t q = (u + A) / (v + C);
+        if (q != (u + B) / (v + D))
+            break;
+        // |A - q * C| == |A| + q * |C|, since signs alternate.
+        int64_t aA = std::abs(A), aB = std::abs(B), aC = std::abs(C), aD = std::abs(D);
+        if ((aC && q > (kMax - aA) / aC) || (aD && q > (kMax - aB) / aD))
+            break;
+        int64_t t = A - q * C; A = C; C = t;
+        t = B - q * D; B = D; D = t;
+        t = u - q * v; u = v; v = t;
+    }
+    L[0] = A; L[1] = B; L[2] = C; L[3] = D;
+    return B != 0;
+}
+
+// r[0..n) = x * a + y * b, where x and y have different signs. result should be >= 0.
+void LinComb(Limb* r, const Limb* a, const Limb* b, int n, int64_t x, int64_t y)
+{
+    if (y <= 0) {
+        Mul1(r, a, n, Limb(x));
+        SubMul1(r, b, n, Limb(-y));
+    }
+    else {
+        Mul1(r, b, n, Limb(y));
+        SubMul1(r, a, n, Limb(-x));
+    }
+}
+
+// one lehmer step, or division step if no quotient is decided from top bits.
+void GcdLehmerStep(LimbVec& a, LimbVec& b, LimbVec& ta, LimbVec& tb, GcdMat* R)
+{
+    int n = (int)a.size();
+    int64_t L[4];
+    if (!LehmerMatrix(a.data(), n, b.data(), (int)b.size(), L)) {
+        GcdDivStep(a, b, R);
+        return;
+    }
+    b.resize(n, 0);
+    ta.resize(n);
+    tb.resize(n);
+    LinComb(ta.data(), a.data(), b.data(), n, L[0], L[1]);
+    LinComb(tb.data(), a.data(), b.data(), n, L[2], L[3]);
+    ta.resize(NormSize(ta.data(), n));
+    tb.resize(NormSize(tb.data(), n));
+    a.swap(ta);
+    b.swap(tb);
+    if (R) MatMulSmall(*R, L);
+}
+
+/*
+    (a, b) = R1 * (a, b), only if the results are a valid pair. (a >= b >= 0)
+    matrix from top part of numbers may be off, so it is checked.
+*/
+bool GcdApply(LimbVec& a, LimbVec& b, const GcdMat& R1)
+{
+    SNum sa(a.data(), (int)a.size()), sb(b.data(), (int)b.size());
+    SNum x = MulS(R1.r[0], sa, false), y = MulS(R1.r[2], sa, false);
+    AddTo(x, MulS(R1.r[1], sb, false));
+    AddTo(y, MulS(R1.r[3], sb, false));
+    if (x.neg || y.neg || Cmp(x.mag.data(), x.Size(), y.mag.data(), y.Size()) < 0)
+        return false;
+    a.assign(x.mag.begin(), x.mag.end());
+    b.assign(y.mag.begin(), y.mag.end());
+    return true;
+}
+
+#endif // !PYCFG_BIGINT_DECIMAL_DIGIT
+
+/*
+    reduces (a, b) by euclid steps until b has s limbs or less. a >= b.
+    if R is given, the steps are accumulated to it.
+
+    half-gcd: above cutoff, top k limbs of a and b are reduced recursively
+    to about half, and the matrix is applied to whole numbers at once.
+    k is 2 * (n - s), to stop near s, but at most about n / 2,
+    so that two recursive calls on half size do most of the job.
+    (same as schonhage / moller's hgcd, with a validity check on the matrix)
+*/
+void GcdReduce(LimbVec& a, LimbVec& b, int s, GcdMat* R, int cutoff)
+{
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    (void)cutoff;
+    while ((int)b.size() > s)
+        GcdDivStep(a, b, R);
+#else
+    LimbVec ta, tb;
+    while ((int)b.size() > s) {
+        int n = (int)a.size();
+        if (!R && n <= 2) {
+            // native gcd for the rest.
+            uint64_t x = a[0] | (n > 1 ? (uint64_t)a[1] << 32 : 0);
+            uint64_t y = b[0] | (b.size() > 1 ? (uint64_t)b[1] << 32 : 0);
+            x = std::gcd(x, y);
+            a.assign({ Limb(x), Limb(x >> 32) });
+            a.resize(NormSize(a.data(), 2));
+            b.clear();
+            return;
+        }
+        int k = 2 * (n - s);
+        if (k > n * 3 / 4)
+            k = n / 2 + 1;
+        if (n >= cutoff && (int)b.size() > n - k + k / 2 + 1) {
+            int p = n - k;
+            LimbVec a1(a.begin() + p, a.end()), b1(b.begin() + p, b.end());
+            b1.resize(NormSize(b1.data(), (int)b1.size()));
+            GcdMat R1;
+            GcdReduce(a1, b1, k / 2 + 1, &R1, cutoff);
+            if (GcdApply(a, b, R1)) {
+                if (R) MatMul(*R, R1);
+                continue;
+            }
+        }
+        GcdLehmerStep(a, b, ta, tb, R);
+    }
+#endif
+}
+
+// normalized copies of a and b, larger one first.
+void GcdInit(LimbVec& x, LimbVec& y, const Limb* a, int an, const Limb* b, int bn)
+{
+    an = NormSize(a, an);
+    bn = NormSize(b, bn);
+    if (Cmp(a, an, b, bn) < 0) {
+        std::swap(a, b);
+        std::swap(an, bn);
+    }
+    x.assign(a, a + an);
+    y.assign(b, b + bn);
+}
+
+int GcdOut(Limb* g, const LimbVec& x)
+{
+    std::copy(x.begin(), x.end(), g);
+    return (int)x.size();
+}
+
+} // namespace
+
+int GcdEuclid(Limb* g, const Limb* a, int an, const Limb* b, int bn)
+{
+    LimbVec x, y;
+    GcdInit(x, y, a, an, b, bn);
+    while (!y.empty())
+        GcdDivStep(x, y, nullptr);
+    return GcdOut(g, x);
+}
+
+int GcdLehmer(Limb* g, const Limb* a, int an, const Limb* b, int bn)
+{
+    LimbVec x, y;
+    GcdInit(x, y, a, an, b, bn);
+    GcdReduce(x, y, 0, nullptr, INT_MAX);
+    return GcdOut(g, x);
+}
+
+int Gcd(Limb* g, const Limb* a, int an, const Limb* b, int bn)
+{
+    LimbVec x, y;
+    GcdInit(x, y, a, an, b, bn);
+    GcdReduce(x, y, 0, nullptr, PYCFG_BIGINT_GCD_HGCD_CUTOFF);
+    return GcdOut(g, x);
+}
+
+/*
+    extended gcd of (m, a mod m) with matrix R.
+    at the end, (g, 0) = R * (m, a), so g = R[0][0] * m + R[0][1] * a,
+    and R[0][1] is inverse of a if g is 1.
+*/
+int ModInverse(Limb* r, const Limb* a, int an, const Limb* m, int mn)
+{
+    an = NormSize(a, an);
+    LimbVec x(m, m + mn), y(mn, 0);
+    if (Cmp(a, an, m, mn) >= 0) {
+        LimbVec q(an - mn + 1);
+        DivRem(q.data(), y.data(), a, an, m, mn);
+    }
+    else
+        std::copy(a, a + an, y.begin());
+    y.resize(NormSize(y.data(), mn));
+
+    GcdMat R;
+    GcdReduce(x, y, 0, &R, PYCFG_BIGINT_GCD_HGCD_CUTOFF);
+    if (x.size() != 1 || x[0] != 1)
+        return -1;
+
+    // |R[0][1]| <= m. negative one is taken as m - |R[0][1]|
+    const SNum& s = R.r[1];
+    std::fill(r, r + mn, Limb(0));
+    std::copy(s.mag.begin(), s.mag.end(), r);
+    if (s.neg)
+        SubN(r, m, r, mn);
+    return NormSize(r, mn);
+}
+
+
+//----------------------------------------------------------------------------
+// integer root
+
+namespace {
+
+// number of limbs which always fit in uint64_t.
+constexpr int kU64Limbs = []{
+    int n = 0;
+    for (uint64_t v = 1; v <= ~uint64_t(0) / kBase; v *= kBase)
+        n++;
+    return n;
+}();
+
+uint64_t ToU64(const Limb* a, int n)
+{
+    uint64_t v = 0;
+    for (int i=n-1; i>=0; i--)
+        v = v * kBase + a[i];
+    return v;
+}
+
+void FromU64(LimbVec& r, uint64_t v)
+{
+    r.clear();
+    for (; v; v /= kBase)
+        r.push_back(Limb(v % kBase));
+}
+
+// x^k <= v, without overflow.
+bool PowLE(uint64_t x, int k, uint64_t v)
+{
+    if (x <= 1)
+        return x <= v;
+    uint64_t p = 1;
+    for (int i=0; i<k; i++) {
+        if (x && p > v / x)
+            return false;
+        p *= x;
+    }
+    return p <= v;
+}
+
+// floor(v^(1/k)), by floating-point estimate and correction.
+uint64_t RootU64(uint64_t v, int k)
+{
+    double e = k == 2 ? std::sqrt((double)v) : std::pow((double)v, 1.0 / k);
+    uint64_t x = e < 0x1p63 ? (uint64_t)e : ~uint64_t(0) >> 1;
+    while (x && !PowLE(x, k, v))
+        x--;
+    while (PowLE(x + 1, k, v))
+        x++;
+    return x;
+}
+
+// log2(a), from top limbs.
+double Log2(const Limb* a, int n)
+{
+    int t = std::min(n, kU64Limbs);
+    return std::log2((double)ToU64(a + n - t, t)) + (n - t) * std::log2((double)kBase);
+}
+
+// r = a * m, normalized. m can be bigger than kBase.
+void MulU64(LimbVec& r, const Limb* a, int n, uint64_t m)
+{
+    LimbVec t;
+    FromU64(t, m);
+    r.assign(n + t.size(), 0);
+    if (n && m)
+        Mul(r.data(), a, n, t.data(), (int)t.size());
+    r.resize(NormSize(r.data(), (int)r.size()));
+}
+
+// a = a / m, normalized. m can be bigger than kBase.
+void DivU64(LimbVec& a, uint64_t m)
+{
+    LimbVec t, q;
+    FromU64(t, m);
+    int n = (int)a.size(), tn = (int)t.size();
+    if (n < tn) {
+        a.clear();
+        return;
+    }
+    q.resize(n - tn + 1);
+    if (tn == 1)
+        DivRem1(q.data(), a.data(), n, t[0]);
+    else {
+        LimbVec r(tn);
+        DivRem(q.data(), r.data(), a.data(), n, t.data(), tn);
+    }
+    q.resize(NormSize(q.data(), (int)q.size()));
+    a.swap(q);
+}
+
+// r = x^e, e >= 1. x is normalized and not zero.
+void PowN(LimbVec& r, const LimbVec& x, int e)
+{
+    int top = 30;
+    while (!((e >> top) & 1)) top--;
+    LimbVec t;
+    r = x;
+    for (int i=top-1; i>=0; i--) {
+        int n = (int)r.size();
+        t.resize(2 * n);
+        Sqr(t.data(), r.data(), n);
+        t.resize(NormSize(t.data(), 2 * n));
+        r.swap(t);
+        if ((e >> i) & 1) {
+            n = (int)r.size();
+            t.resize(n + x.size());
+            Mul(t.data(), r.data(), n, x.data(), (int)x.size());
+            t.resize(NormSize(t.data(), (int)t.size()));
+            r.swap(t);
+        }
+    }
+}
+
+/*
+    one newton step, from x = xs * B^z above the root.
+        y = ((k - 1) * x + a / x^(k-1)) / k
+    y is not less than the root, even if x is far from it. (am-gm)
+    low z * (k-1) limbs of a are dropped, instead of dividing by B^(z(k-1)).
+*/
+void RootStep(LimbVec& y, const Limb* a, int an, const LimbVec& xs, int z, int k)
+{
+    LimbVec p, q, r;
+    if (k == 2)
+        p = xs;
+    else
+        PowN(p, xs, k - 1);
+    int off = z * (k - 1), pn = (int)p.size();
+    if (an - off >= pn) {
+        q.resize(an - off - pn + 1);
+        r.resize(pn);
+        DivRem(q.data(), r.data(), a + off, an - off, p.data(), pn);
+        q.resize(NormSize(q.data(), (int)q.size()));
+    }
+    MulU64(y, xs.data(), (int)xs.size(), uint64_t(k - 1));
+    if (!y.empty())
+        y.insert(y.begin(), z, Limb(0));
+    y.resize(std::max(y.size(), q.size()) + 1, 0);
+    if (!q.empty())
+        Add(y.data(), y.data(), (int)y.size(), q.data(), (int)q.size());
+    y.resize(NormSize(y.data(), (int)y.size()));
+    DivU64(y, uint64_t(k));
+}
+
+/*
+    s = floor(a^(1/k)), normalized. a is normalized, an > 0.
+    x = (root of a's top part + 1) * B^z is above the root, with half
+    of full precision. one newton step makes it almost exact,
+    and it is repeated until y^k <= a.
+*/
+void RootRec(LimbVec& s, const Limb* a, int an, int k)
+{
+    if (an <= kU64Limbs) {
+        FromU64(s, RootU64(ToU64(a, an), k));
+        return;
+    }
+    double bits = Log2(a, an) / k;
+    LimbVec xs;
+    int z = 0;
+    if (bits < 1 - 1.0 / k) {
+        // a < 2^k
+        s.assign(1, Limb(1));
+        return;
+    }
+    if (bits < 50) {
+        // small root. start from floating-point estimate, with margin.
+        FromU64(xs, (uint64_t)(std::exp2(bits) * (1 + 1e-12)) + 1);
+    }
+    else {
+        z = std::max((an - 1) / (2 * k), 1);
+        RootRec(xs, a + z * k, an - z * k, k);
+        xs.push_back(0);
+        Limb one = 1;
+        Add(xs.data(), xs.data(), (int)xs.size(), &one, 1);
+        xs.resize(NormSize(xs.data(), (int)xs.size()));
+    }
+
+    LimbVec y, t;
+    while (true) {
+        RootStep(y, a, an, xs, z, k);
+        PowN(t, y, k);
+        if (Cmp(t.data(), (int)t.size(), a, an) <= 0)
+            break;
+        xs.swap(y);
+        z = 0;
+    }
+    s.swap(y);
+}
+
+/*
+    s = floor(sqrt(a)), r = a - s^2, normalized. a is normalized, an > 0.
+    with a = a_hi * B^2z + a1 * B^z + a0, and (s0, r0) of a_hi,
+        q, u = divmod(r0 * B^z + a1, 2 * s0)
+        s = s0 * B^z + q
+        r = u * B^z + a0 - q^2
+    s is exact or one more, if s0 >= B^z. (z <= (an - 1) / 4)
+*/
+void SqrtRemRec(LimbVec& s, LimbVec& r, const Limb* a, int an)
+{
+    int z = (an - 1) / 4;
+    if (an <= kU64Limbs || z == 0) {
+        RootRec(s, a, an, 2);
+        LimbVec t(2 * s.size());
+        Sqr(t.data(), s.data(), (int)s.size());
+        r.assign(a, a + an);
+        Sub(r.data(), r.data(), an, t.data(), NormSize(t.data(), (int)t.size()));
+        r.resize(NormSize(r.data(), an));
+        return;
+    }
+    LimbVec s0, r0;
+    SqrtRemRec(s0, r0, a + 2 * z, an - 2 * z);
+
+    // n = r0 * B^z + a1, d = 2 * s0
+    int s0n = (int)s0.size();
+    LimbVec n(a + z, a + 2 * z), d(s0n + 1);
+    n.insert(n.end(), r0.begin(), r0.end());
+    int nn = NormSize(n.data(), (int)n.size());
+    d[s0n] = Mul1(d.data(), s0.data(), s0n, 2);
+    int dn = NormSize(d.data(), s0n + 1);
+
+    LimbVec q, u;
+    if (nn >= dn) {
+        q.resize(nn - dn + 1);
+        u.resize(dn);
+        DivRem(q.data(), u.data(), n.data(), nn, d.data(), dn);
+        q.resize(NormSize(q.data(), (int)q.size()));
+        u.resize(NormSize(u.data(), dn));
+    }
+    else
+        u.assign(n.begin(), n.begin() + nn);
+
+    // s = s0 * B^z + q
+    int sn = std::max(s0n + z, (int)q.size()) + 1;
+    s.assign(sn, 0);
+    std::copy(s0.begin(), s0.end(), s.begin() + z);
+    if (!q.empty())
+        Add(s.data(), s.data(), sn, q.data(), (int)q.size());
+    sn = NormSize(s.data(), sn);
+    s.resize(sn);
+
+    // r = u * B^z + a0 - q^2. if negative, s -= 1 and r += 2 * s - 1 (of old s)
+    int rn = std::max((int)u.size() + z, sn) + 2;
+    r.assign(rn, 0);
+    std::copy(a, a + z, r.begin());
+    std::copy(u.begin(), u.end(), r.begin() + z);
+    LimbVec q2(2 * q.size());
+    if (!q.empty())
+        Sqr(q2.data(), q.data(), (int)q.size());
+    int q2n = NormSize(q2.data(), (int)q2.size());
+    if (Cmp(r.data(), NormSize(r.data(), rn), q2.data(), q2n) < 0) {
+        Add(r.data(), r.data(), rn, s.data(), sn);
+        Add(r.data(), r.data(), rn, s.data(), sn);
+        Limb one = 1;
+        Sub(r.data(), r.data(), rn, &one, 1);
+        Sub(s.data(), s.data(), sn, &one, 1);
+        s.resize(NormSize(s.data(), sn));
+    }
+    Sub(r.data(), r.data(), rn, q2.data(), q2n);
+    r.resize(NormSize(r.data(), rn));
+}
+
+} // namespace
+
+int Root(Limb* s, const Limb* a, int an, int k)
+{
+    if (an <= kU64Limbs) {
+        int n = 0;
+        for (uint64_t v = RootU64(ToU64(a, an), k); v; v /= kBase)
+            s[n++] = Limb(v % kBase);
+        return n;
+    }
+    LimbVec r, t;
+    if (k == 2)
+        SqrtRemRec(r, t, a, an);
+    else
+        RootRec(r, a, an, k);
+    std::copy(r.begin(), r.end(), s);
+    return (int)r.size();
+}
+
+int SqrtRem(Limb* s, Limb* r, const Limb* a, int an, int& rn)
+{
+    LimbVec x, y;
+    SqrtRemRec(x, y, a, an);
+    std::copy(x.begin(), x.end(), s);
+    std::copy(y.begin(), y.end(), r);
+    rn = (int)y.size();
+    return (int)x.size();
+}
+
+
+//----------------------------------------------------------------------------
+// decimal string conversion
+
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+
+// one limb is one digit. conversion is just reversing order.
+
+int LimbsForDigits(int len) { return len; }
+int DigitsForLimbs(int n) { return n; }
+
+int SetStrBasecase(Limb* r, const char* s, int len)
+{
+    for (int k=0; k<len; k++)
+        r[k] = Limb(s[len-k-1] - '0');
+    return NormSize(r, len);
+}
+
+int GetStrBasecase(char* s, const Limb* a, int n)
+{
+    n = NormSize(a, n);
+    if (n == 0) {
+        s[0] = '0';
+        return 1;
+    }
+    for (int k=0; k<n; k++)
+        s[k] = char('0' + a[n-k-1]);
+    return n;
+}
+
+int SetStr(Limb* r, const char* s, int len) { return SetStrBasecase(r, s, len); }
+int GetStr(char* s, const Limb* a, int n) { return GetStrBasecase(s, a, n); }
+
+#else
+
+namespace {
+
+// 9 decimal digits at once, 10^9 < 2^32.
+constexpr Limb kChunkBase = 1000000000;
+constexpr int kChunkDigits = 9;
+
+// cache outlives any scratch arena, so it is on plain heap.
+using PersistVec = std::vector<Limb>;
+
+struct Pow10Entry
+{
+    PersistVec pow; // 10^(9 * 2^k)
+    PersistVec inv; // floor(B^(2n) / pow), n = pow.size(). for barrett division.
+};
+
+/*
+    10^(9 * 2^k), for k = 0, 1, 2, ...
+    each is square of previous one. built on demand, and kept for later calls.
+    reciprocal is needed only for GetStr(), so it is also built on demand.
+    deque keeps references of existing elements valid while it grows.
+*/
+const Pow10Entry& Pow10Pow2(int k, bool bInv = false)
+{
+    static std::mutex mtx;
+    static std::deque<Pow10Entry> cache;
+
+    std::lock_guard<std::mutex> lock(mtx);
+    if (cache.empty())
+        cache.push_back({ { kChunkBase }, {} });
+    while ((int)cache.size() <= k) {
+        const PersistVec& p = cache.back().pow;
+        int n = (int)p.size();
+        PersistVec sq(2*n);
+        Sqr(sq.data(), p.data(), n);
+        sq.resize(NormSize(sq.data(), 2*n));
+        cache.push_back({ std::move(sq), {} });
+    }
+    Pow10Entry& e = cache[k];
+    if (bInv && e.inv.empty()) {
+        int n = (int)e.pow.size();
+        LimbVec num(2*n + 1, 0), r(n);
+        num[2*n] = 1;
+        e.inv.resize(n + 2);
+        DivRem(e.inv.data(), r.data(), num.data(), 2*n + 1, e.pow.data(), n);
+        e.inv.resize(NormSize(e.inv.data(), n + 2));
+    }
+    return e;
+}
+
+/*
+    q[0..an-n+1) = a / m, r[0..n) = a % m, where n = m.size() <= an <= 2n.
+    barrett reduction with precomputed mu = floor(B^(2n) / m).
+    estimated quotient is at most 2 less than exact one. O(M(n))
+*/
+void DivRemBarrett(Limb* q, Limb* r, const Limb* a, int an, const PersistVec& m, const PersistVec& mu)
+{
+    const int n = (int)m.size();
+    const int un = (int)mu.size();
+    const int qn = an - n + 1;
+    const Limb one = 1;
+
+    // q = ((a >> (n-1) limbs) * mu) >> (n+1) limbs
+    const Limb* a1 = a + n - 1;
+    LimbVec t(qn + un);
+    if (qn >= un)
+        Mul(t.data(), a1, qn, mu.data(), un);
+    else
+        Mul(t.data(), mu.data(), un, a1, qn);
+    std::fill(q, q + qn, 0);
+    int tn = qn + un - (n + 1);
+    if (tn > 0)
+        std::copy(t.begin() + n + 1, t.begin() + n + 1 + std::min(tn, qn), q);
+
+    // r = a - q * m, then correct q.
+    LimbVec rr(a, a + an);
+    int qs = NormSize(q, qn);
+    if (qs > 0) {
+        LimbVec p(qs + n);
+        if (qs >= n)
+            Mul(p.data(), q, qs, m.data(), n);
+        else
+            Mul(p.data(), m.data(), n, q, qs);
+        Sub(rr.data(), rr.data(), an, p.data(), NormSize(p.data(), qs + n));
+    }
+    int rn = NormSize(rr.data(), an);
+    while (Cmp(rr.data(), rn, m.data(), n) >= 0) {
+        Sub(rr.data(), rr.data(), rn, m.data(), n);
+        rn = NormSize(rr.data(), rn);
+        Add(q, q, qn, &one, 1);
+    }
+    std::copy(rr.begin(), rr.begin() + n, r);
+}
+
+// largest k such that 9 * 2^k < len. (len > 9)
+int SplitLevel(int len)
+{
+    int k = 0;
+    while ((kChunkDigits << (k + 1)) < len) k++;
+    return k;
+}
+
+/*
+    writes exactly width digits of a[0..n), with leading zeros.
+    a < 10^width is assumed.
+*/
+void GetStrWidthBasecase(char* s, int width, const Limb* a, int n)
+{
+    LimbVec q(a, a + n);
+    char* p = s + width;
+    n = NormSize(q.data(), n);
+    while (n > 0) {
+        Limb chunk = DivRem1(q.data(), q.data(), n, kChunkBase);
+        n = NormSize(q.data(), n);
+        for (int k=0; k<kChunkDigits && p>s; k++) {
+            *--p = char('0' + chunk % 10);
+            chunk /= 10;
+        }
+    }
+    std::fill(s, p, '0');
+}
+
+/*
+    a = q * 10^L + r, where L = 9 * 2^k is about half of width.
+    then upper and lower digits are converted recursively.
+    division by 10^L is done with cached reciprocal, so it costs two multiplications.
+*/
+void GetStrWidth(char* s, int width, const Limb* a, int n)
+{
+    n = NormSize(a, n);
+    // skip leading zeros, which n limbs can not fill.
+    int w = std::min(width, DigitsForLimbs(n));
+    std::fill(s, s + width - w, '0');
+    s += width - w;
+
+    if (n <= PYCFG_BIGINT_STR_DC_CUTOFF) {
+        GetStrWidthBasecase(s, w, a, n);
+        return;
+    }
+    int k = SplitLevel(w);
+    int L = kChunkDigits << k;
+    const Pow10Entry& P = Pow10Pow2(k, true);
+    int pn = (int)P.pow.size();
+    if (n < pn) {
+        // a < 10^L
+        std::fill(s, s + w - L, '0');
+        GetStrWidth(s + w - L, L, a, n);
+        return;
+    }
+    // a < 10^(2L), so n <= 2 * pn.
+    LimbVec q(n - pn + 1), r(pn);
+    DivRemBarrett(q.data(), r.data(), a, n, P.pow, P.inv);
+    // two halves write disjoint digits, so they may run in parallel.
+    auto half = [&](int i) {
+        if (i == 0) GetStrWidth(s, w - L, q.data(), (int)q.size());
+        else GetStrWidth(s + w - L, L, r.data(), pn);
+    };
+    if (Parallel(n))
+        ParallelFor(2, half);
+    else
+        for (int i=0; i<2; i++) half(i);
+}
+
+// r = s[0..len). r has (len + 8) / 9 + 1 zero-filled limbs.
+int SetStrRec(Limb* r, const char* s, int len)
+{
+    if (len <= PYCFG_BIGINT_STR_DC_CUTOFF * kChunkDigits)
+        return SetStrBasecase(r, s, len);
+
+    // r = hi * 10^L + lo
+    int k = SplitLevel(len);
+    int L = kChunkDigits << k;
+    const PersistVec& P = Pow10Pow2(k).pow;
+    int pn = (int)P.size();
+
+    LimbVec hi((len - L + 8) / 9 + 1), lo(L / 9 + 1);
+    int hn = 0, ln = 0;
+    auto half = [&](int i) {
+        if (i == 0) hn = SetStrRec(hi.data(), s, len - L);
+        else ln = SetStrRec(lo.data(), s + len - L, L);
+    };
+    if (Parallel(pn))
+        ParallelFor(2, half);
+    else
+        for (int i=0; i<2; i++) half(i);
+    if (hn == 0) {
+        std::copy(lo.begin(), lo.begin() + ln, r);
+        return ln;
+    }
+    // 10^L needs at most L/9 limbs, so hn + pn fits in r.
+    if (hn >= pn)
+        Mul(r, hi.data(), hn, P.data(), pn);
+    else
+        Mul(r, P.data(), pn, hi.data(), hn);
+    if (ln > 0)
+        Add(r, r, hn + pn, lo.data(), ln); // lo < 10^L, so ln <= pn.
+    return NormSize(r, hn + pn);
+}
+
+/*
+    in parallel mode, powers needed by the recursion are built in advance.
+    otherwise tasks of the same level would wait for each other on the cache.
+*/
+void BuildPow10(int len, bool bInv)
+{
+    if (!Parallel(LimbsForDigits(len)) || len <= kChunkDigits)
+        return;
+    for (int k=SplitLevel(len); k>=0; k--)
+        Pow10Pow2(k, bInv);
+}
+
+} // namespace
+
+
+// 10^9 < 2^32, so 9 digits fit in one limb.
+int LimbsForDigits(int len) { return (len + kChunkDigits - 1) / kChunkDigits + 1; }
+
+// 2^32 < 10^9.633
+int DigitsForLimbs(int n) { return (int)((long long)n * 9633 / 1000) + 1; }
+
+/*
+    accumulate 9 decimal digits at once: x = x * 10^9 + chunk.
+    first chunk takes the remainder so that others are all 9 digits.
+*/
+int SetStrBasecase(Limb* r, const char* s, int len)
+{
+    int n = 0; // number of used limbs
+    int clen = len % kChunkDigits;
+    if (clen == 0) clen = kChunkDigits;
+    Limb mult = 1;
+    for (int k=0; k<clen; k++) mult *= 10;
+
+    for (const char* p=s; p!=s+len; ) {
+        Limb chunk = 0;
+        for (int k=0; k<clen; k++, p++)
+            chunk = chunk * 10 + (*p - '0');
+        Limb carry = Mul1(r, r, n, mult, chunk);
+        if (carry)
+            r[n++] = carry;
+        clen = kChunkDigits;
+        mult = kChunkBase;
+    }
+    return NormSize(r, n);
+}
+
+/*
+    divide by 10^9 repeatedly, and collect 9 decimal digits at once
+    from the lowest chunk.
+*/
+int GetStrBasecase(char* s, const Limb* a, int n)
+{
+    int w = DigitsForLimbs(n);
+    GetStrWidthBasecase(s, w, a, n);
+    int z = 0;
+    while (z < w - 1 && s[z] == '0') z++;
+    std::copy(s + z, s + w, s);
+    return w - z;
+}
+
+int SetStr(Limb* r, const char* s, int len)
+{
+    BuildPow10(len, false);
+    return SetStrRec(r, s, len);
+}
+
+int GetStr(char* s, const Limb* a, int n)
+{
+    int w = DigitsForLimbs(n);
+    BuildPow10(w, true);
+    GetStrWidth(s, w, a, n);
+    int z = 0;
+    while (z < w - 1 && s[z] == '0') z++;
+    std::copy(s + z, s + w, s);
+    return w - z;
+}
+
+#endif // PYCFG_BIGINT_DECIMAL_DIGIT
+
+
+
+//----------------------------------------------------------------------------
+// scratch memory
+
+namespace {
+thread_local std::pmr::memory_resource* t_scratch = nullptr;
+}
+
+std::pmr::memory_resource* ScratchResource()
+{
+    return t_scratch ? t_scratch : std::pmr::new_delete_resource();
+}
+
+ScratchScope::ScratchScope(std::pmr::memory_resource* res):
+    m_prev(t_scratch)
+{
+    t_scratch = res;
+}
+
+ScratchScope::~ScratchScope()
+{
+    t_scratch = m_prev;
+}
+
+
+//----------------------------------------------------------------------------
+// LimbBuf
+
+void LimbBuf::resize(int n, Limb v)
+{
+    reserve(n);
+    if (n > m_size)
+        std::fill(data() + m_size, data() + n, v);
+    m_size = n;
+}
+
+void LimbBuf::assign(int n, Limb v)
+{
+    reserve(n);
+    std::fill(data(), data() + n, v);
+    m_size = n;
+}
+
+// [first, last) should not point into this buffer.
+void LimbBuf::assign(const Limb* first, const Limb* last)
+{
+    int n = (int)(last - first);
+    reserve(n);
+    std::copy(first, last, data());
+    m_size = n;
+}
+
+void LimbBuf::swap(LimbBuf& other)
+{
+    if (this == &other)
+        return;
+    if (*m_res == *other.m_res) {
+        LimbBuf tmp(std::move(other));
+        other.Steal(*this);
+        Steal(tmp);
+        return;
+    }
+    // each keeps its own resource. nothing is changed if allocation throws.
+    LimbBuf tmp(m_res);
+    tmp.assign(other.begin(), other.end());
+    other.assign(begin(), end());
+    Free();
+    Steal(tmp);
+}
+
+// at least double the capacity, to keep push_back() amortized O(1).
+void LimbBuf::Grow(int n)
+{
+    int cap = std::max(n, 2 * capacity());
+    void* block = m_res->allocate((kHeader + cap) * sizeof(Limb), alignof(int));
+    *static_cast<int*>(block) = cap;
+    Limb* p = static_cast<Limb*>(block) + kHeader;
+    std::copy(data(), data() + m_size, p);
+    Free();
+    m_ptr = p;
+    m_heap = true;
+}
+
+void LimbBuf::Free()
+{
+    if (m_heap)
+        m_res->deallocate(m_ptr - kHeader, (kHeader + HeapCap()) * sizeof(Limb), alignof(int));
+}
+
+void LimbBuf::Steal(LimbBuf& other) noexcept
+{
+    if (other.IsHeap())
+        m_ptr = other.m_ptr;
+    else
+        std::copy(other.m_inline, other.m_inline + kInline, m_inline);
+    m_res = other.m_res;
+    m_size = other.m_size;
+    m_heap = other.m_heap;
+    other.m_heap = false;
+    other.m_size = 0;
+}
+
+
+//============================================================================
+}; // namespace com::cafrii::pyc::mpn
+
+#endif // __PYC_LIB_IMPLEMENTATION
@@ -0,0 +1,222 @@
+/*
+    pyc_big_integer_view.hpp
+
+    pythonic cpp library
+    read only view of big integer
+
+    Author: yhlee
+    Copyright © 2025
+*/
+
+//============================================================================
+
+#pragma once
+
+#ifndef __cplusplus
+#error this header file is for c++
+#endif
+
+//============================================================================
+
+
+#include <span>
+#include <cstddef>
+#include <compare>
+#include <concepts>
+#include <string>
+#include <stdexcept>
+#include <climits>
+#include <functional> // hash
+
+#include "pyc_big_integer.hpp"
+
+
+//============================================================================
+// namespace
+namespace com::cafrii::pyc {
+
+//============================================================================
+
+/*
+    non-owning, read only view of big integer over limbs of someone else.
+
+    limbs are in the layout of BigInt storage: mpn::Limb, least significant first,
+    in native byte order. so a file of raw limbs can be memory-mapped and used
+    in place, without parse or copy. startup is bounded by page faults.
+
+        // writer
+        auto limbs = BigIntView(x).Limbs();
+        fwrite(limbs.data(), sizeof(mpn::Limb), limbs.size(), fp);
+        // reader
+        auto p = (const std::byte*)mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        BigIntView v = BigIntView::FromBytes({ p, size });
+        y += v;       // read straight from mapped pages
+        v < y;        // compared as is
+        v.ToStr();
+
+    with base 2^32 limbs on little endian host, it is the same bytes as magnitude
+    of BigInt::Encode(), zero-padded to limb size.
+    PYCFG_BIGINT_DECIMAL_DIGIT build has other limb layout (one digit per byte),
+    so file should be read by the build of same representation.
+
+    limbs should outlive the view, and should not change while it is in use.
+    view of BigInt is invalidated by any modification of the BigInt.
+*/
+class BigIntView
+{
+    using Limb = mpn::Limb;
+
+    const Limb* m_limbs = nullptr;
+    int m_size = 0;  // without high zero limbs. 0 for zero.
+    bool m_sign = false;  // true if negative. never set for zero.
+
+public:
+    // zero
+    constexpr BigIntView() = default;
+
+    // high zero limbs are ignored, so padded array is fine. negative zero is zero.
+    explicit BigIntView(std::span<const Limb> limbs, bool bNeg = false) {
+        if (limbs.size() > (size_t)INT_MAX)
+            throw std::length_error("too many limbs for BigIntView");
+        m_limbs = limbs.data();
+        m_size = mpn::NormSize(limbs.data(), (int)limbs.size());
+        m_sign = bNeg && m_size > 0;
+    }
+
+    // view of storage of a.
+    BigIntView(const BigInt& a):
+        m_limbs(a.m_limbs.data()), m_size(a.IsZero() ? 0 : a.Size()), m_sign(a.m_sign) {}
+
+    // raw limb bytes, such as mapped file.
+    // throws std::invalid_argument if it is not aligned to limb, or has partial limb.
+    static BigIntView FromBytes(std::span<const std::byte> bytes, bool bNeg = false) {
+        if ((uintptr_t)bytes.data() % alignof(Limb) || bytes.size() % sizeof(Limb))
+            throw std::invalid_argument("misaligned limb bytes for BigIntView");
+        return BigIntView(std::span<const Limb>((const Limb*)bytes.data(), bytes.size() / sizeof(Limb)), bNeg);
+    }
+
+public:
+    // limbs without high zero ones. empty for zero.
+    std::span<const Limb> Limbs() const { return { m_limbs, (size_t)m_size }; }
+    bool IsZero() const { return m_size == 0; }
+    bool IsNegative() const { return m_sign; }
+    BigIntView Abs() const {
+        BigIntView r = *this;
+        r.m_sign = false;
+        return r;
+    }
+
+    // three-way comparison. returns -1, 0, 1.
+    int Compare(const BigIntView& rhs) const {
+        if (m_sign != rhs.m_sign)
+            return m_sign ? -1 : 1;
+        int c = mpn::Cmp(m_limbs, m_size, rhs.m_limbs, rhs.m_size);
+        return m_sign ? -c : c;
+    }
+
+    // decimal string, same as BigInt::ToStr().
+    std::string ToStr() const {
+        if (m_size == 0)
+            return "0";
+        int sign = m_sign ? 1 : 0;
+        std::string res(sign + mpn::DigitsForLimbs(m_size), '-');
+        int len = mpn::GetStr(&res[sign], m_limbs, m_size);
+        res.resize(sign + len);
+        return res;
+    }
+
+    // same as hash of BigInt of same value.
+    size_t Hash() const noexcept { return BigInt::HashLimbs(m_limbs, m_size, m_sign); }
+
+    // owning copy.
+    BigInt ToBigInt(const BigInt::allocator_type& alloc = {}) const {
+        BigInt r(alloc);
+        r.AddLimbs_(m_limbs, m_size, m_sign);
+        return r;
+    }
+
+public:
+    /*
+        view as right-hand operand of add/sub/mul. limbs are read in place.
+        BigInt converts to view implicitly, so comparison works in any mix of them.
+    */
+    friend bool operator==(const BigIntView& lhs, const BigIntView& rhs) {
+        return lhs.Compare(rhs) == 0;
+    }
+    friend std::strong_ordering operator<=>(const BigIntView& lhs, const BigIntView& rhs) {
+        return lhs.Compare(rhs) <=> 0;
+    }
+    // native one is compared as limbs on stack, without temporary BigInt.
+    template <std::integral T>
+    friend bool operator==(const BigIntView& lhs, T rhs) {
+        return CompareTo(lhs, rhs) == 0;
+    }
+    template <std::integral T>
+    friend std::strong_ordering operator<=>(const BigIntView& lhs, T rhs) {
+        return CompareTo(lhs, rhs) <=> 0;
+    }
+
+    friend BigInt& operator+=(BigInt& lhs, const BigIntView& rhs) {
+        return AddTo(lhs, rhs, rhs.m_sign);
+    }
+    friend BigInt& operator-=(BigInt& lhs, const BigIntView& rhs) {
+        return AddTo(lhs, rhs, !rhs.m_sign);
+    }
+    friend BigInt& operator*=(BigInt& lhs, const BigIntView& rhs) {
+        return MulTo(lhs, rhs);
+    }
+    friend BigInt operator+(const BigInt& lhs, const BigIntView& rhs) {
+        BigInt r = lhs.Clone(); r += rhs; return r;
+    }
+    friend BigInt operator+(BigInt&& lhs, const BigIntView& rhs) {
+        lhs += rhs; return std::move(lhs);
+    }
+    friend BigInt operator-(const BigInt& lhs, const BigIntView& rhs) {
+        BigInt r = lhs.Clone(); r -= rhs; return r;
+    }
+    friend BigInt operator-(BigInt&& lhs, const BigIntView& rhs) {
+        lhs -= rhs; return std::move(lhs);
+    }
+    friend BigInt operator*(const BigInt& lhs, const BigIntView& rhs) {
+        BigInt r = lhs.Clone(); r *= rhs; return r;
+    }
+    friend BigInt operator*(BigInt&& lhs, const BigIntView& rhs) {
+        lhs *= rhs; return std::move(lhs);
+    }
+
+private:
+    // friend functions above can not reach protected members of BigInt by themselves.
+    static BigInt& AddTo(BigInt& a, const BigIntView& b, bool bNeg) {
+        return a.AddLimbs_(b.m_limbs, b.m_size, bNeg);
+    }
+    static BigInt& MulTo(BigInt& a, const BigIntView& b) {
+        return a.MulLimbs_(b.m_limbs, b.m_size, b.m_sign);
+    }
+    template <std::integral T>
+    static int CompareTo(const BigIntView& a, T b) {
+        return BigInt::CompareLimbsNative(a.m_limbs, a.m_size, a.m_sign, BigInt::NativeMag(b), BigInt::NativeNeg(b));
+    }
+};
+
+
+/*
+    transparent hash, for lookup of BigInt key by view without copy.
+        std::unordered_set<BigInt, BigIntHash, std::equal_to<>> set;
+        set.find(BigIntView::FromBytes(mapped));
+*/
+struct BigIntHash
+{
+    using is_transparent = void;
+    size_t operator()(const BigIntView& v) const noexcept { return v.Hash(); }
+};
+
+
+//============================================================================
+}; // namespace com::cafrii::pyc
+
+template <>
+struct std::hash<com::cafrii::pyc::BigIntView> {
+    size_t operator()(const com::cafrii::pyc::BigIntView& v) const noexcept { return v.Hash(); }
+};
+
+//============================================================================
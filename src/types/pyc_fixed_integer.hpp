@@ -0,0 +1,487 @@
+/*
+    pyc_fixed_integer.hpp
+
+    pythonic cpp library
+    fixed width integer class
+
+    Author: yhlee
+    Copyright © 2025
+*/
+
+//============================================================================
+
+#pragma once
+
+#ifndef __cplusplus
+#error this header file is for c++
+#endif
+
+//============================================================================
+
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <compare>
+#include <concepts>
+#include <utility> // index_sequence
+#include <type_traits>
+#include <stdexcept>
+#include <bit>
+
+#include "pyc_big_integer.hpp"
+
+
+//============================================================================
+// namespace
+namespace com::cafrii::pyc {
+
+//============================================================================
+
+/*
+    fixed width integer of Bits bits, with operator set of BigInt.
+    for bounded values like 128/256/512 bit hashes, counters and keys,
+    where heap-backed BigInt is pure overhead.
+
+    value is stored as two's complement in std::array of 32-bit words,
+    least significant word first. every operation is constexpr, and
+    loops over words are unrolled at compile time.
+
+    arithmetic wraps modulo 2^Bits, like native integers.
+    division, modulo and right shift follow BigInt. (python floor semantics)
+        -7 / 2 == -4, -7 % 2 == 1, -5 >> 1 == -3
+    conversion from BigInt is checked, and throws std::overflow_error.
+*/
+template <int Bits, bool Signed = true>
+class FixedInt
+{
+    static_assert(Bits > 0 && Bits % 32 == 0, "Bits should be multiple of 32");
+
+public:
+    using Word = uint32_t;
+    static constexpr int kWords = Bits / 32;
+    static constexpr int kBits = Bits;
+    static constexpr bool kSigned = Signed;
+
+protected:
+    std::array<Word, kWords> m_w {};
+
+    // f(integral_constant<int, I>) for I in [0, kWords), unrolled.
+    template <typename F>
+    static constexpr void Unroll(F&& f) {
+        [&]<int... I>(std::integer_sequence<int, I...>) {
+            (f(std::integral_constant<int, I>{}), ...);
+        }(std::make_integer_sequence<int, kWords>{});
+    }
+
+public:
+    // ctor. native integer is sign-extended, or wrapped into unsigned.
+    constexpr FixedInt() = default;
+    template <std::integral T>
+    constexpr FixedInt(T v) {
+        // conversion to unsigned long long keeps two's complement of v.
+        const unsigned long long u = (unsigned long long)v;
+        const Word ext = (std::is_signed_v<T> && v < 0) ? ~Word(0) : Word(0);
+        Unroll([&](auto i) {
+            constexpr int k = decltype(i)::value;
+            if constexpr (k < 2)
+                m_w[k] = Word(u >> (k * 32));
+            else
+                m_w[k] = ext;
+        });
+    }
+
+    // checked conversion. throws std::overflow_error if x does not fit.
+    explicit FixedInt(const BigInt& x) {
+        if (!Fits(x))
+            throw std::overflow_error("BigInt does not fit in FixedInt");
+        Word w[kWords] = {};
+        x.GetWords(w, kWords);
+        Unroll([&](auto i) { m_w[i] = w[i]; });
+        if (x.IsNegative())
+            Negate_();
+    }
+    explicit FixedInt(const std::string& s): FixedInt(BigInt(s)) {}
+    explicit FixedInt(const char* cs): FixedInt(BigInt(cs)) {}
+
+    // whether x is in range of this type.
+    static bool Fits(const BigInt& x) {
+        long long bits = x.BitLength();
+        if (!kSigned)
+            return !x.IsNegative() && bits <= kBits;
+        if (bits < kBits)
+            return true;
+        // -2^(Bits-1) is the only one of Bits bits.
+        return x.IsNegative() && bits == kBits && x.BitCount() == 1;
+    }
+
+    // range of this type
+    static constexpr FixedInt Min() {
+        FixedInt r;
+        if constexpr (kSigned)
+            r.m_w[kWords - 1] = Word(1) << 31;
+        return r;
+    }
+    static constexpr FixedInt Max() {
+        FixedInt r = ~FixedInt();
+        if constexpr (kSigned)
+            r.m_w[kWords - 1] >>= 1;
+        return r;
+    }
+
+public:
+    // conversion
+    BigInt ToBigInt() const {
+        FixedInt a = Abs();
+        BigInt r;
+        r.SetWords_(a.m_w.data(), kWords, IsNegative());
+        return r;
+    }
+    explicit operator BigInt() const { return ToBigInt(); }
+
+    // low 64 bits, wrapped like native conversion.
+    constexpr unsigned long long Low64() const {
+        unsigned long long r = m_w[0];
+        if constexpr (kWords > 1)
+            r |= (unsigned long long)m_w[1] << 32;
+        else if (IsNegative())
+            r |= 0xFFFFFFFF00000000ULL;
+        return r;
+    }
+
+    std::string ToStr() const { return ToBigInt().ToStr(); }
+
+    // word k, two's complement. k < kWords.
+    constexpr Word GetWord(int k) const { return m_w[k]; }
+
+public:
+    // representation
+    constexpr bool IsZero() const {
+        Word x = 0;
+        Unroll([&](auto i) { x |= m_w[i]; });
+        return x == 0;
+    }
+    constexpr bool IsNegative() const {
+        if constexpr (kSigned)
+            return (m_w[kWords - 1] >> 31) != 0;
+        else
+            return false;
+    }
+
+    // magnitude as unsigned. (|Min()| wraps to itself, which is still right as unsigned)
+    constexpr FixedInt Abs() const { return IsNegative() ? -*this : *this; }
+
+public:
+    // unary arithmetic
+    constexpr FixedInt operator+() const { return *this; }
+    constexpr FixedInt operator-() const { FixedInt r = *this; return r.Negate_(); }
+    constexpr FixedInt operator~() const {
+        FixedInt r;
+        Unroll([&](auto i) { r.m_w[i] = ~m_w[i]; });
+        return r;
+    }
+
+    constexpr FixedInt& operator++() { return *this += FixedInt(1); }
+    constexpr FixedInt  operator++(int) { FixedInt r = *this; ++*this; return r; }
+    constexpr FixedInt& operator--() { return *this -= FixedInt(1); }
+    constexpr FixedInt  operator--(int) { FixedInt r = *this; --*this; return r; }
+
+protected:
+    constexpr FixedInt& Negate_() {
+        uint64_t carry = 1;
+        Unroll([&](auto i) {
+            carry += Word(~m_w[i]);
+            m_w[i] = Word(carry);
+            carry >>= 32;
+        });
+        return *this;
+    }
+
+public:
+    // binary arithmetic operator
+    constexpr FixedInt& operator+=(const FixedInt& rhs) {
+        uint64_t carry = 0;
+        Unroll([&](auto i) {
+            carry += (uint64_t)m_w[i] + rhs.m_w[i];
+            m_w[i] = Word(carry);
+            carry >>= 32;
+        });
+        return *this;
+    }
+    friend constexpr FixedInt operator+(FixedInt lhs, const FixedInt& rhs) {
+        lhs += rhs; return lhs;
+    }
+    constexpr FixedInt& operator-=(const FixedInt& rhs) {
+        uint64_t borrow = 0;
+        Unroll([&](auto i) {
+            uint64_t d = (uint64_t)m_w[i] - rhs.m_w[i] - borrow;
+            m_w[i] = Word(d);
+            borrow = d >> 63;
+        });
+        return *this;
+    }
+    friend constexpr FixedInt operator-(FixedInt lhs, const FixedInt& rhs) {
+        lhs -= rhs; return lhs;
+    }
+    // low Bits bits of product. same for signed and unsigned in two's complement.
+    constexpr FixedInt& operator*=(const FixedInt& rhs) {
+        FixedInt r;
+        Unroll([&](auto i) {
+            uint64_t carry = 0;
+            Unroll([&](auto j) {
+                constexpr int k = decltype(i)::value + decltype(j)::value;
+                if constexpr (k < kWords) {
+                    carry += (uint64_t)m_w[i] * rhs.m_w[j] + r.m_w[k];
+                    r.m_w[k] = Word(carry);
+                    carry >>= 32;
+                }
+            });
+        });
+        return *this = r;
+    }
+    friend constexpr FixedInt operator*(FixedInt lhs, const FixedInt& rhs) {
+        lhs *= rhs; return lhs;
+    }
+    // floor division, like BigInt. throws std::domain_error if divisor is zero.
+    constexpr FixedInt& operator/=(const FixedInt& rhs) {
+        DivMod(*this, rhs, this, nullptr); return *this;
+    }
+    friend constexpr FixedInt operator/(FixedInt lhs, const FixedInt& rhs) {
+        lhs /= rhs; return lhs;
+    }
+    constexpr FixedInt& operator%=(const FixedInt& rhs) {
+        DivMod(*this, rhs, nullptr, this); return *this;
+    }
+    friend constexpr FixedInt operator%(FixedInt lhs, const FixedInt& rhs) {
+        lhs %= rhs; return lhs;
+    }
+
+    // quotient and remainder in single pass. q or r can be nullptr, or same as a or b.
+    static constexpr void DivMod(const FixedInt& a, const FixedInt& b, FixedInt* q, FixedInt* r);
+
+public:
+    // bitwise operators. signed one behaves like BigInt within its range.
+    constexpr FixedInt& operator&=(const FixedInt& rhs) {
+        Unroll([&](auto i) { m_w[i] &= rhs.m_w[i]; }); return *this;
+    }
+    friend constexpr FixedInt operator&(FixedInt lhs, const FixedInt& rhs) {
+        lhs &= rhs; return lhs;
+    }
+    constexpr FixedInt& operator|=(const FixedInt& rhs) {
+        Unroll([&](auto i) { m_w[i] |= rhs.m_w[i]; }); return *this;
+    }
+    friend constexpr FixedInt operator|(FixedInt lhs, const FixedInt& rhs) {
+        lhs |= rhs; return lhs;
+    }
+    constexpr FixedInt& operator^=(const FixedInt& rhs) {
+        Unroll([&](auto i) { m_w[i] ^= rhs.m_w[i]; }); return *this;
+    }
+    friend constexpr FixedInt operator^(FixedInt lhs, const FixedInt& rhs) {
+        lhs ^= rhs; return lhs;
+    }
+
+    // shift by negative count throws std::domain_error.
+    // bits shifted out are lost. right shift of signed one is arithmetic.
+    constexpr FixedInt& operator<<=(long long cnt);
+    friend constexpr FixedInt operator<<(FixedInt lhs, long long cnt) {
+        lhs <<= cnt; return lhs;
+    }
+    constexpr FixedInt& operator>>=(long long cnt);
+    friend constexpr FixedInt operator>>(FixedInt lhs, long long cnt) {
+        lhs >>= cnt; return lhs;
+    }
+
+    // python int.bit_length(), int.bit_count(), of magnitude.
+    constexpr long long BitLength() const {
+        FixedInt a = Abs();
+        for (int k=kWords-1; k>=0; k--)
+            if (a.m_w[k])
+                return 32LL * k + std::bit_width(a.m_w[k]);
+        return 0;
+    }
+    constexpr long long BitCount() const {
+        FixedInt a = Abs();
+        long long c = 0;
+        Unroll([&](auto i) { c += std::popcount(a.m_w[i]); });
+        return c;
+    }
+    // bit k of two's complement, sign-extended beyond Bits.
+    constexpr bool TestBit(long long k) const {
+        if (k < 0)
+            throw std::domain_error("negative bit index");
+        if (k >= kBits)
+            return IsNegative();
+        return (m_w[k / 32] >> (k % 32)) & 1;
+    }
+
+public:
+    // comparison operator. words are compared from the top, sign word first.
+    friend constexpr bool operator==(const FixedInt& lhs, const FixedInt& rhs) {
+        Word x = 0;
+        Unroll([&](auto i) { x |= lhs.m_w[i] ^ rhs.m_w[i]; });
+        return x == 0;
+    }
+    friend constexpr std::strong_ordering operator<=>(const FixedInt& lhs, const FixedInt& rhs) {
+        // flip of sign bit maps two's complement order to unsigned order.
+        constexpr Word kFlip = kSigned ? Word(1) << 31 : 0;
+        std::strong_ordering res = std::strong_ordering::equal;
+        Unroll([&](auto i) {
+            constexpr int k = kWords - 1 - decltype(i)::value;
+            if (res == 0) {
+                Word x = lhs.m_w[k], y = rhs.m_w[k];
+                if constexpr (k == kWords - 1) {
+                    x ^= kFlip;
+                    y ^= kFlip;
+                }
+                res = x <=> y;
+            }
+        });
+        return res;
+    }
+
+    bool Less(const FixedInt& rhs) const { return *this < rhs; }
+    bool Equal(const FixedInt& rhs) const { return *this == rhs; }
+
+}; // FixedInt
+
+
+// common widths
+using Int128 = FixedInt<128>;
+using Int256 = FixedInt<256>;
+using Int512 = FixedInt<512>;
+using UInt128 = FixedInt<128, false>;
+using UInt256 = FixedInt<256, false>;
+using UInt512 = FixedInt<512, false>;
+
+
+//-------------------------------------
+// FixedInt members
+
+template <int Bits, bool Signed>
+constexpr FixedInt<Bits, Signed>& FixedInt<Bits, Signed>::operator<<=(long long cnt)
+{
+    if (cnt < 0)
+        throw std::domain_error("negative shift count");
+    if (cnt >= kBits)
+        return *this = FixedInt();
+    const int ws = int(cnt / 32), bs = int(cnt % 32);
+    for (int k=kWords-1; k>=0; k--) {
+        Word hi = k - ws >= 0 ? m_w[k - ws] : 0;
+        Word lo = k - ws - 1 >= 0 ? m_w[k - ws - 1] : 0;
+        m_w[k] = bs ? Word(hi << bs | lo >> (32 - bs)) : hi;
+    }
+    return *this;
+}
+
+template <int Bits, bool Signed>
+constexpr FixedInt<Bits, Signed>& FixedInt<Bits, Signed>::operator>>=(long long cnt)
+{
+    if (cnt < 0)
+        throw std::domain_error("negative shift count");
+    const Word ext = IsNegative() ? ~Word(0) : 0;
+    if (cnt >= kBits) {
+        m_w.fill(ext);
+        return *this;
+    }
+    const int ws = int(cnt / 32), bs = int(cnt % 32);
+    for (int k=0; k<kWords; k++) {
+        Word lo = k + ws < kWords ? m_w[k + ws] : ext;
+        Word hi = k + ws + 1 < kWords ? m_w[k + ws + 1] : ext;
+        m_w[k] = bs ? Word(lo >> bs | hi << (32 - bs)) : lo;
+    }
+    return *this;
+}
+
+/*
+    magnitudes are divided by knuth algorithm D on 32-bit words,
+    with a shortcut for single word divisor. then adjusted to floor
+    semantics like BigInt::DivMod():
+        q = -(|q| + 1), r = sign(b) * (|b| - |r|), if signs differ and r != 0
+    Min() / -1 wraps to Min().
+*/
+template <int Bits, bool Signed>
+constexpr void FixedInt<Bits, Signed>::DivMod(const FixedInt& a, const FixedInt& b, FixedInt* q, FixedInt* r)
+{
+    if (b.IsZero())
+        throw std::domain_error("division by zero");
+
+    const bool aNeg = a.IsNegative(), bNeg = b.IsNegative();
+    const FixedInt u = a.Abs(), v = b.Abs();
+    int un = kWords, vn = kWords;
+    while (un > 0 && u.m_w[un - 1] == 0) un--;
+    while (v.m_w[vn - 1] == 0) vn--;
+
+    FixedInt qm, rm;
+    if (un < vn) {
+        rm = u;
+    }
+    else if (vn == 1) {
+        uint64_t rem = 0;
+        for (int k=un-1; k>=0; k--) {
+            rem = rem << 32 | u.m_w[k];
+            qm.m_w[k] = Word(rem / v.m_w[0]);
+            rem %= v.m_w[0];
+        }
+        rm.m_w[0] = Word(rem);
+    }
+    else {
+        // normalize so that top word of divisor has its high bit set.
+        const int s = std::countl_zero(v.m_w[vn - 1]);
+        Word vs[kWords] = {}, us[kWords + 1] = {};
+        for (int k=vn-1; k>=0; k--)
+            vs[k] = s ? Word(v.m_w[k] << s | (k ? v.m_w[k - 1] >> (32 - s) : 0)) : v.m_w[k];
+        us[un] = s ? Word(u.m_w[un - 1] >> (32 - s)) : 0;
+        for (int k=un-1; k>=0; k--)
+            us[k] = s ? Word(u.m_w[k] << s | (k ? u.m_w[k - 1] >> (32 - s) : 0)) : u.m_w[k];
+
+        for (int j=un-vn; j>=0; j--) {
+            // estimate from top two words, corrected at most twice.
+            uint64_t num = (uint64_t)us[j + vn] << 32 | us[j + vn - 1];
+            uint64_t qhat = num / vs[vn - 1];
+            uint64_t rhat = num % vs[vn - 1];
+            while (qhat >> 32 || qhat * vs[vn - 2] > (rhat << 32 | us[j + vn - 2])) {
+                qhat--;
+                rhat += vs[vn - 1];
+                if (rhat >> 32)
+                    break;
+            }
+            // us[j..j+vn] -= qhat * vs
+            int64_t borrow = 0;
+            uint64_t carry = 0;
+            for (int i=0; i<vn; i++) {
+                uint64_t p = qhat * vs[i] + carry;
+                carry = p >> 32;
+                int64_t t = (int64_t)us[i + j] - borrow - (int64_t)(p & 0xFFFFFFFFu);
+                us[i + j] = Word(t);
+                borrow = t < 0 ? 1 : 0;
+            }
+            int64_t t = (int64_t)us[j + vn] - borrow - (int64_t)carry;
+            us[j + vn] = Word(t);
+            if (t < 0) {
+                // qhat was one too large. add back.
+                qhat--;
+                uint64_t c = 0;
+                for (int i=0; i<vn; i++) {
+                    c += (uint64_t)us[i + j] + vs[i];
+                    us[i + j] = Word(c);
+                    c >>= 32;
+                }
+                us[j + vn] += Word(c);
+            }
+            qm.m_w[j] = Word(qhat);
+        }
+        for (int k=0; k<vn; k++)
+            rm.m_w[k] = s ? Word(us[k] >> s | us[k + 1] << (32 - s)) : us[k];
+    }
+
+    if (aNeg != bNeg && !rm.IsZero()) {
+        ++qm;
+        rm = v - rm;
+    }
+    if (q) *q = aNeg != bNeg ? -qm : qm;
+    if (r) *r = bNeg ? -rm : rm;
+}
+
+
+//============================================================================
+}; // namespace com::cafrii::pyc
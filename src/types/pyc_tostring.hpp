@@ -20,6 +20,8 @@
 
 
 
+#include <charconv>
+
 #include "pyc_pystring.hpp"
 #include "pyc_typetraits.hpp"
 
@@ -161,8 +163,10 @@ std::enable_if_t<is_sequence_like_v<T>, std::string>
 to_string(const T& container) {
     std::stringstream ss;
     ss << "[";
+    bool first = true; // note: std::vector<bool> element is not addressable.
     for (const auto& elem : container) {
-        if (&elem != &*container.begin()) ss << ", ";
+        if (!first) ss << ", ";
+        first = false;
         ss << to_string(elem);
     }
     ss << "]";
@@ -217,11 +221,16 @@ to_string(const T& m) {
 /*
     floating point 의 경우 소숫점 이하 자리의 표시 여부 및 지수형태 표기 방법 등
     동일 숫자를 여러가지 방법으로 표현할 수 있는데, std::format() 이 제일 자연스러운 방법 같음.
+
+    std::format("{}", val) 은 shortest round-trip 표현인 std::to_chars() 결과와 같다.
+    <format> 이 없는 컴파일러(gcc 12 등)도 있으므로 std::to_chars() 를 직접 사용한다.
 */
 template <typename T>
 std::enable_if_t<std::is_floating_point_v<T>, std::string>
 to_string(const T& val) {
-    return std::format("{}", val);
+    char buf[64];
+    auto res = std::to_chars(buf, buf + sizeof(buf), val);
+    return std::string(buf, res.ptr);
 }
 
 /*
@@ -0,0 +1,28 @@
+/*
+    test_alloc_count.hpp
+
+    replacement of global operator new/delete, to count heap allocations.
+    include from exactly one translation unit of a program.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+// count heap allocations of whole program. (pool threads allocate, too)
+static std::atomic<long long> g_num_alloc = 0;
+
+// noinline, so that malloc/free are not seen paired with new/delete at call sites.
+// (gcc -Wmismatched-new-delete)
+__attribute__((noinline)) void* operator new(std::size_t size)
+{
+    g_num_alloc.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept { std::free(p); }
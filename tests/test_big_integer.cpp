@@ -7,9 +7,33 @@
 #include <string_view>
 #include <cstdio>
 #include <cstring>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <climits>
+#include <stdexcept>
+#include <new>
+#include <cstdlib>
+#include <memory_resource>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <atomic>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <ctime>
+#include <sstream>
+#include <iomanip>
 
 #include "pyc_compare.hpp"
 #include "pyc_big_integer.hpp"
+#include "pyc_big_integer_expr.hpp"
+#include "pyc_fixed_integer.hpp"
+#include "pyc_big_integer_view.hpp"
+#include "test_alloc_count.hpp"
 
 /*
     how to test?
@@ -29,6 +53,7 @@ using namespace pyc;
 #define ASSERT(cond, msg, ...) ASSERT2(cond, exit(1), msg, ##__VA_ARGS__)
 
 
+
 int test_compare(int argc, char **argv)
 {
     ASSERT(InRange(5, 1, 10), "fail");
@@ -163,6 +188,1675 @@ int test_bigint(int argc, char **argv)
     return 0;
 }
 
+/*
+    numbers bigger than one limb.
+    carry/borrow should be propagated across limb boundary.
+*/
+int test_bigint_large(int argc, char **argv)
+{
+    {
+        const char* s = "123456789012345678901234567890123456789012345678901234567890";
+        ASSERT(BigInt(s).ToStr() == s, "str roundtrip");
+        ASSERT(BigInt(std::string("-") + s).ToStr() == std::string("-") + s, "str roundtrip");
+        ASSERT(BigInt(s).Width() == 60, "width");
+        ASSERT(BigInt("1000000000000000000000").ToStr() == "1000000000000000000000", "chunk zeros");
+        ASSERT(BigInt("-0000000000000000000000000").ToStr() == "0", "zeros");
+        printf("large str ok\n");
+    }
+
+    {
+        ASSERT(BigInt(9223372036854775807LL).ToStr() == "9223372036854775807", "llong max");
+        ASSERT(BigInt(-9223372036854775807LL-1).ToStr() == "-9223372036854775808", "llong min");
+        ASSERT(BigInt(-9223372036854775807LL-1) == BigInt("-9223372036854775808"), "llong min");
+        printf("llong ok\n");
+    }
+
+    {
+        // 2^64 - 1 + 1 = 2^64
+        BigInt a = "18446744073709551615";
+        ASSERT(a + 1 == BigInt("18446744073709551616"), "carry");
+        ASSERT(BigInt("18446744073709551616") - 1 == a, "borrow");
+        ASSERT(BigInt("340282366920938463463374607431768211456") -
+            BigInt("340282366920938463463374607431768211455") == 1, "borrow chain");
+        ASSERT(BigInt(1) - BigInt("340282366920938463463374607431768211456") ==
+            BigInt("-340282366920938463463374607431768211455"), "negative");
+        ASSERT(BigInt("-99999999999999999999999") + BigInt("99999999999999999999999") == 0, "zero");
+        ASSERT(!(BigInt("-99999999999999999999999") + BigInt("99999999999999999999999")).IsNegative(), "no -0");
+        printf("large add/sub ok\n");
+    }
+
+    {
+        ASSERT(BigInt("4294967296") > BigInt("4294967295"), "compare");
+        ASSERT(BigInt("-4294967296") < BigInt("-4294967295"), "compare");
+        ASSERT(BigInt("100000000000000000000") > BigInt(99999), "compare");
+        printf("large compare ok\n");
+    }
+
+    return 0;
+}
+
+
+// 10^n as string
+static std::string pow10str(int n)
+{
+    std::string s(n + 1, '0');
+    s[0] = '1';
+    return s;
+}
+
+static mpn::LimbVec random_limbs(std::mt19937& gen, int n)
+{
+    mpn::LimbVec v(n);
+    for (auto& x : v) x = mpn::Limb(gen() % mpn::kBase);
+    if (n > 0 && v[n-1] == 0) v[n-1] = 1;
+    return v;
+}
+
+int test_bigint_mul(int argc, char **argv)
+{
+    ASSERT(BigInt(12) * BigInt(34) == 408, "mul");
+    ASSERT(BigInt(-12) * BigInt(34) == -408, "mul sign");
+    ASSERT(BigInt(-12) * BigInt(-34) == 408, "mul sign");
+    ASSERT(BigInt(12) * BigInt(0) == 0, "mul zero");
+    ASSERT(!(BigInt(-12) * BigInt(0)).IsNegative(), "no -0");
+    ASSERT(BigInt("4294967296") * BigInt("4294967296") == BigInt("18446744073709551616"), "mul");
+    ASSERT(BigInt("-18446744073709551615") * BigInt("18446744073709551615") ==
+        BigInt("-340282366920938463426481119284349108225"), "mul");
+    {
+        BigInt f = 1;
+        for (int k=2; k<=30; k++) f *= k;
+        ASSERT(f.ToStr() == "265252859812191058636308480000000", "factorial");
+        BigInt x = "123456789123456789";
+        x *= x;
+        ASSERT(x.ToStr() == "15241578780673678515622620750190521", "self mul");
+    }
+    printf("small mul ok\n");
+
+    // big operands, reaching karatsuba and toom-3 tiers.
+    for (int n : {100, 700, 3000, 8000}) {
+        BigInt p = pow10str(n);
+        ASSERT((p + 1) * (p - 1) == BigInt(pow10str(2*n)) - 1, "mul %d", n);
+        BigInt sq = p + 1;
+        sq *= sq;
+        ASSERT(sq == BigInt(pow10str(2*n)) + p + p + 1, "sqr %d", n);
+        ASSERT((p + 1) * 7 == p * 7 + 7, "mul1 %d", n);
+    }
+    printf("big mul ok\n");
+
+    // cross-check each algorithm tier against schoolbook.
+    std::mt19937 gen(2025);
+    for (int n : {1, 2, 3, 5, 39, 40, 41, 64, 100, 255, 256, 257, 401, 701, 1500}) {
+        auto a = random_limbs(gen, n);
+        auto b = random_limbs(gen, n);
+        mpn::LimbVec r0(2*n), r1(2*n), r2(2*n), r3(2*n), s0(2*n), s1(2*n);
+        mpn::MulBasecase(r0.data(), a.data(), n, b.data(), n);
+        mpn::Mul(r1.data(), a.data(), n, b.data(), n);
+        mpn::MulKaratsuba(r2.data(), a.data(), b.data(), n);
+        mpn::MulToom3(r3.data(), a.data(), b.data(), n);
+        ASSERT(r0 == r1, "mul %d", n);
+        ASSERT(r0 == r2, "karatsuba %d", n);
+        ASSERT(r0 == r3, "toom3 %d", n);
+
+        mpn::MulBasecase(s0.data(), a.data(), n, a.data(), n);
+        mpn::SqrBasecase(s1.data(), a.data(), n);
+        ASSERT(s0 == s1, "sqr basecase %d", n);
+        mpn::Sqr(s1.data(), a.data(), n);
+        ASSERT(s0 == s1, "sqr %d", n);
+        mpn::MulToom3(s1.data(), a.data(), a.data(), n);
+        ASSERT(s0 == s1, "toom3 sqr %d", n);
+    }
+    for (auto [an, bn] : {std::pair{100, 41}, {1000, 77}, {1000, 999}, {2500, 400}, {333, 1}}) {
+        auto a = random_limbs(gen, an);
+        auto b = random_limbs(gen, bn);
+        mpn::LimbVec r0(an + bn), r1(an + bn);
+        mpn::MulBasecase(r0.data(), a.data(), an, b.data(), bn);
+        mpn::Mul(r1.data(), a.data(), an, b.data(), bn);
+        ASSERT(r0 == r1, "unbalanced mul %d x %d", an, bn);
+    }
+    printf("mul tiers ok\n");
+
+    // NTT should give exact result, even for worst case input (all limbs are max).
+    for (auto [an, bn] : {std::pair{1, 1}, {7, 5}, {300, 300}, {1000, 3}, {2049, 2048}, {5000, 3000}}) {
+        for (bool bMax : {false, true}) {
+            auto a = random_limbs(gen, an);
+            auto b = random_limbs(gen, bn);
+            if (bMax) {
+                std::fill(a.begin(), a.end(), mpn::kLimbMax);
+                std::fill(b.begin(), b.end(), mpn::kLimbMax);
+            }
+            mpn::LimbVec r0(an + bn), r1(an + bn);
+            mpn::MulBasecase(r0.data(), a.data(), an, b.data(), bn);
+            mpn::MulNtt(r1.data(), a.data(), an, b.data(), bn);
+            ASSERT(r0 == r1, "ntt %d x %d", an, bn);
+            mpn::LimbVec s0(2*an), s1(2*an);
+            mpn::SqrBasecase(s0.data(), a.data(), an);
+            mpn::MulNtt(s1.data(), a.data(), an, a.data(), an);
+            ASSERT(s0 == s1, "ntt sqr %d", an);
+        }
+    }
+    {
+        // through BigInt, above NTT cutoff.
+        BigInt p = pow10str(60000);
+        ASSERT((p + 1) * (p - 1) == BigInt(pow10str(120000)) - 1, "ntt mul");
+    }
+    printf("ntt ok\n");
+
+    return 0;
+}
+
+
+/*
+    check q * b + r == a and 0 <= r < b, in limb level.
+*/
+static bool check_divrem(const mpn::LimbVec& a, const mpn::LimbVec& b,
+                         const mpn::LimbVec& q, const mpn::LimbVec& r)
+{
+    int an = (int)a.size(), bn = (int)b.size();
+    int qn = mpn::NormSize(q.data(), (int)q.size());
+    mpn::LimbVec p(an + 1, 0);
+    if (qn >= bn)
+        mpn::Mul(p.data(), q.data(), qn, b.data(), bn);
+    else if (qn > 0)
+        mpn::Mul(p.data(), b.data(), bn, q.data(), qn);
+    mpn::Add(p.data(), p.data(), an + 1, r.data(), bn);
+    return p[an] == 0 &&
+        mpn::Cmp(p.data(), an, a.data(), an) == 0 &&
+        mpn::Cmp(r.data(), bn, b.data(), bn) < 0;
+}
+
+int test_bigint_div(int argc, char **argv)
+{
+    // python semantics. floor division, remainder takes sign of divisor.
+    for (auto [a, b, q, r] : {
+            std::tuple{7, 2, 3, 1}, {-7, 2, -4, 1}, {7, -2, -4, -1}, {-7, -2, 3, -1},
+            {6, 3, 2, 0}, {-6, 3, -2, 0}, {0, -5, 0, 0}, {3, 7, 0, 3}, {-3, 7, -1, 4}}) {
+        ASSERT(BigInt(a) / BigInt(b) == q, "%d // %d", a, b);
+        ASSERT(BigInt(a) % BigInt(b) == r, "%d %% %d", a, b);
+        ASSERT(BigInt(a) / b == q, "%d // %d native", a, b);
+        ASSERT(BigInt(a) % b == r, "%d %% %d native", a, b);
+        auto [q2, r2] = divmod(BigInt(a), BigInt(b));
+        ASSERT(q2 == q && r2 == r, "divmod(%d, %d)", a, b);
+    }
+    ASSERT(!(BigInt(-6) % BigInt(3)).IsNegative(), "no -0");
+    ASSERT(!(BigInt(-6) / -7).IsNegative(), "no -0");
+    {
+        BigInt a = "-123456789012345678901234567890";
+        ASSERT(a / 1000000007 == BigInt("-123456788148148161865"), "native div");
+        ASSERT(a % 1000000007 == 802565165, "native mod");
+        ASSERT(a % -1000000007 == -197434842, "native mod");
+        // divisor bigger than a limb, falls back to general path.
+        ASSERT(a / 1000000000000LL == BigInt("-123456789012345679"), "native div 2");
+        ASSERT(a % 1000000000000LL == 98765432110LL, "native mod 2");
+        auto [q, r] = divmod(a, LLONG_MIN);
+        ASSERT(q == BigInt("13385211885") && r == -4860475736982489810LL, "divmod llong min");
+        BigInt x = a;
+        x /= BigInt("1234567890");
+        ASSERT(x == BigInt("-100000000010000000001"), "in-place div");
+        x = a;
+        x %= x;
+        ASSERT(x.IsZero(), "self mod");
+    }
+    {
+        bool bThrown = false;
+        try { BigInt(1) / BigInt(0); } catch (const std::domain_error&) { bThrown = true; }
+        ASSERT(bThrown, "division by zero");
+        bThrown = false;
+        try { BigInt(1) % 0; } catch (const std::domain_error&) { bThrown = true; }
+        ASSERT(bThrown, "division by zero");
+    }
+    printf("small div ok\n");
+
+    // big operands, through BigInt.
+    for (int n : {100, 700, 3000, 8000}) {
+        BigInt p = pow10str(n);
+        BigInt a = BigInt(pow10str(2*n)) - 1;
+        ASSERT(a / (p + 1) == p - 1, "div %d", n);
+        ASSERT(a % (p + 1) == 0, "mod %d", n);
+        ASSERT((a + 5) % (p - 1) == 5, "mod %d", n);
+        ASSERT((-a) / (p - 1) == -(p + 1), "neg div %d", n);
+        ASSERT((-a - 2) % (p + 1) == p - 1, "neg mod %d", n);
+        ASSERT(a / 3 == BigInt(std::string(2*n, '3')), "div1 %d", n);
+    }
+    printf("big div ok\n");
+
+    // cross-check knuth, burnikel-ziegler and DivRem() dispatch.
+    std::mt19937 gen(2026);
+    for (auto [an, bn] : {std::pair{1, 1}, {5, 2}, {50, 49}, {100, 30}, {200, 100},
+            {500, 250}, {900, 401}, {1200, 1000}, {2000, 620}, {3000, 1500}, {5000, 3000}, {4000, 130}}) {
+        for (int kind=0; kind<3; kind++) {
+            auto a = random_limbs(gen, an);
+            auto b = random_limbs(gen, bn);
+            if (kind == 1) { // worst case for qhat estimation
+                std::fill(a.begin(), a.end(), mpn::kLimbMax);
+                std::fill(b.begin(), b.end() - 1, mpn::kLimbMax);
+            }
+            else if (kind == 2) { // heavy normalization
+                b[bn-1] = 1;
+            }
+            int qn = an - bn + 1;
+            mpn::LimbVec q0(qn), r0(bn), q1(qn), r1(bn), q2(qn), r2(bn);
+            mpn::DivRemKnuth(q0.data(), r0.data(), a.data(), an, b.data(), bn);
+            ASSERT(check_divrem(a, b, q0, r0), "knuth %d / %d", an, bn);
+            mpn::DivRem(q1.data(), r1.data(), a.data(), an, b.data(), bn);
+            ASSERT(q0 == q1 && r0 == r1, "divrem %d / %d", an, bn);
+            if (bn > 1) {
+                mpn::DivRemBZ(q2.data(), r2.data(), a.data(), an, b.data(), bn);
+                ASSERT(q0 == q2 && r0 == r2, "bz %d / %d", an, bn);
+            }
+        }
+    }
+    printf("div tiers ok\n");
+
+    return 0;
+}
+
+int test_bigint_str(int argc, char **argv)
+{
+    ASSERT(BigInt("0").ToStr() == "0", "zero");
+    ASSERT(BigInt("-0").ToStr() == "0", "-0");
+    ASSERT(BigInt("000123").ToStr() == "123", "leading zeros");
+    ASSERT(BigInt("-4294967296").ToStr() == "-4294967296", "two limbs");
+    ASSERT(BigInt("1000000000").ToStr() == "1000000000", "10^9");
+
+    // random digits, around and far above divide-and-conquer cutoff.
+    std::mt19937 gen(2027);
+    for (int len : {1, 8, 9, 10, 17, 18, 19, 100, 359, 360, 361, 385, 386,
+            1000, 4321, 10000, 65536, 200001}) {
+        std::string sn(len, '0');
+        for (auto& c : sn) c = char('0' + gen() % 10);
+        sn[0] = char('1' + gen() % 9);
+        ASSERT(BigInt(sn).ToStr() == sn, "round trip %d", len);
+        ASSERT(BigInt("-" + sn).ToStr() == "-" + sn, "round trip -%d", len);
+        ASSERT(BigInt("000" + sn) == BigInt(sn), "leading zeros %d", len);
+
+        // compare with O(n^2) chunk loop versions.
+        mpn::LimbVec a(mpn::LimbsForDigits(len)), b(mpn::LimbsForDigits(len));
+        int an = mpn::SetStr(a.data(), sn.data(), len);
+        int bn = mpn::SetStrBasecase(b.data(), sn.data(), len);
+        ASSERT(an == bn && a == b, "SetStr %d", len);
+        std::string s1(mpn::DigitsForLimbs(an), ' '), s2 = s1;
+        s1.resize(mpn::GetStr(s1.data(), a.data(), an));
+        s2.resize(mpn::GetStrBasecase(s2.data(), a.data(), an));
+        ASSERT(s1 == sn && s2 == sn, "GetStr %d", len);
+    }
+    // long runs of zeros or nines hit each split boundary.
+    for (int len : {1000, 9 * 1024, 9 * 1024 + 1, 50000}) {
+        BigInt p = pow10str(len);
+        ASSERT(p.ToStr() == pow10str(len), "10^%d", len);
+        ASSERT((p - 1).ToStr() == std::string(len, '9'), "10^%d - 1", len);
+        ASSERT((p + 1).ToStr() == pow10str(len - 1) + "1", "10^%d + 1", len);
+    }
+    printf("str ok\n");
+
+    return 0;
+}
+
+int test_bigint_alloc(int argc, char **argv)
+{
+    ASSERT(sizeof(BigInt) <= 24, "sizeof(BigInt) %d", (int)sizeof(BigInt));
+    ASSERT(!std::is_polymorphic_v<BigInt>, "no vtable");
+    ASSERT(std::is_nothrow_move_constructible_v<BigInt>, "noexcept move");
+
+    // int64 range arithmetic should not touch heap.
+    long long n0 = g_num_alloc;
+    {
+        BigInt a = 1234567890123LL, b = -987654321;
+        BigInt c = a + b;
+        c -= b * 3;
+        c = c * 2 - a;
+        c = c / 7 + c % 1000003 + c / b + c % b;
+        c++;
+        --c;
+        BigInt d = std::move(c);
+        BigInt e = d;
+        auto [q, r] = divmod(e, a);
+        ASSERT(d < a && q != r && e == d, "compare");
+        e = BigInt(LLONG_MIN) / -1;
+        ASSERT(e == BigInt(LLONG_MAX) + 1, "llong min / -1");
+        e = (a & b) | (a ^ -b);
+        e = (e << 20) >> 9;
+        ASSERT(e.BitLength() > 0 && e.BitCount() > 0 && e.TestBit(11), "bitwise");
+    }
+#if !defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    ASSERT(g_num_alloc == n0, "heap allocated %lld times", g_num_alloc - n0);
+#else
+    (void)n0; // only 8 digits are inline
+#endif
+
+    // spill to heap and back.
+    {
+        BigInt a = LLONG_MAX;
+        BigInt b = a * a * a;
+        ASSERT(b / a / a == a, "spill");
+        b = std::move(a);
+        ASSERT(b == LLONG_MAX && a == 0, "moved-from is zero");
+        BigInt c = pow10str(100);
+        std::swap(b, c);
+        ASSERT(c == LLONG_MAX && b == BigInt(pow10str(100)), "swap");
+    }
+    printf("alloc ok\n");
+    return 0;
+}
+
+int test_bigint_pmr(int argc, char **argv)
+{
+    using allocator_type = BigInt::allocator_type;
+    {
+        // default resource, unless given.
+        BigInt a = 5;
+        ASSERT(a.get_allocator().resource() == std::pmr::get_default_resource(), "default");
+
+        // copy takes default resource like std::pmr, Clone() and results of operators
+        // follow source, move constructor steals it.
+        std::pmr::monotonic_buffer_resource res;
+        BigInt b(pow10str(100), &res);
+        BigInt k = b;
+        ASSERT(k.get_allocator().resource() == std::pmr::get_default_resource() && k == b, "copy");
+        BigInt c = b.Clone();
+        ASSERT(c.get_allocator().resource() == &res && c == b, "clone");
+        ASSERT((b + 1).get_allocator().resource() == &res && (-b).get_allocator().resource() == &res, "operator");
+        ASSERT((+b).get_allocator().resource() == &res && (~b).get_allocator().resource() == &res, "unary operator");
+        BigInt d = std::move(c);
+        ASSERT(d.get_allocator().resource() == &res && c == 0, "move");
+        BigInt e(d, allocator_type());
+        ASSERT(e.get_allocator().resource() == std::pmr::get_default_resource() && e == b, "copy with alloc");
+
+        // resource does not change by assignment. different resource is copied.
+        a = std::move(d);
+        ASSERT(a.get_allocator().resource() == std::pmr::get_default_resource(), "move assign");
+        ASSERT(a == b && d == 0, "move assign");
+
+        // uses-allocator construction by pmr containers.
+        std::pmr::vector<BigInt> v(&res);
+        v.emplace_back(7);
+        v.push_back(a);
+        v.resize(10);
+        for (auto& x : v)
+            ASSERT(x.get_allocator().resource() == &res, "pmr vector");
+        ASSERT(v[0] == 7 && v[1] == b && v[9] == 0, "pmr vector");
+    }
+
+    // scratch scope is per thread, and can be nested.
+    {
+        ASSERT(mpn::ScratchResource() == std::pmr::new_delete_resource(), "scratch");
+        std::pmr::monotonic_buffer_resource r1, r2;
+        {
+            mpn::ScratchScope s1(&r1);
+            {
+                mpn::ScratchScope s2(&r2);
+                ASSERT(mpn::ScratchResource() == &r2, "scratch nested");
+            }
+            ASSERT(mpn::ScratchResource() == &r1, "scratch restored");
+        }
+        ASSERT(mpn::ScratchResource() == std::pmr::new_delete_resource(), "scratch restored");
+    }
+
+    // batch job on an arena does not touch global heap.
+    {
+        std::string s1 = pow10str(2000), s2 = std::string(1500, '7'), s3 = std::string(900, '3');
+        mpn::ScratchArena arena(1 << 20);
+        {
+            BigInt a(s1, &arena.Resource()), b(s2, &arena.Resource()), c(s3, &arena.Resource());
+            BigInt r(&arena.Resource());
+            long long n0 = g_num_alloc;
+            for (int k=0; k<100; k++) {
+                r = a + b - c;
+                r = r * b / c % a;
+                r += (a * a) / b;
+            }
+            ASSERT(g_num_alloc == n0, "heap allocated %lld times", g_num_alloc - n0);
+            ASSERT(r == ((a + b - c) * b / c % a) + (a * a) / b, "result");
+        }
+        arena.Release();
+    }
+
+    // swap keeps resources. different ones are swapped by copy.
+    {
+        std::pmr::monotonic_buffer_resource r1, r2;
+        mpn::LimbBuf x(&r1), y(&r2), z(&r1);
+        x.assign(5, 1);
+        y.assign(9, 2);
+        x.swap(y);
+        ASSERT(x.resource() == &r1 && y.resource() == &r2 && x.size() == 9 && x[8] == 2 && y.size() == 5 && y[4] == 1, "swap");
+        z.swap(x);
+        ASSERT(z.size() == 9 && x.empty() && z.resource() == &r1, "swap same resource");
+    }
+
+    // plain copy of a value on arena outlives the arena.
+    {
+        std::string s1 = pow10str(3000);
+        std::vector<BigInt> kept;
+        {
+            mpn::ScratchArena arena(1 << 16);
+            BigInt a(s1, &arena.Resource());
+            a += 7;
+            BigInt copy = a;
+            ASSERT(copy.get_allocator().resource() == std::pmr::get_default_resource(), "copy out of arena");
+            kept.push_back(std::move(copy));
+            kept.push_back(a);
+            arena.Release();
+        }
+        // reuse freed memory, so that dangling limbs would be caught.
+        std::vector<std::string> junk(64, std::string(1 << 12, 'x'));
+        std::string t = kept[0].ToStr();
+        ASSERT(kept[0] == kept[1] && t.size() == 3001 && t.front() == '1' && t.back() == '7', "kept");
+    }
+    printf("pmr ok\n");
+    return 0;
+}
+
+int test_bigint_kernel(int argc, char **argv)
+{
+    ASSERT(!mpn::SelectAddSubKernel("unknown"), "unknown kernel");
+    ASSERT(mpn::SelectAddSubKernel("scalar"), "scalar is always supported");
+
+    // every supported kernel gives same result with scalar one.
+    std::mt19937 gen(2029);
+    const mpn::Limb mx = mpn::kLimbMax;
+    for (const char* name : {"avx512", "avx2", "sse4", "scalar"}) {
+        if (!mpn::SelectAddSubKernel(name))
+            continue;
+        for (int n=0; n<=70; n++) {
+            for (int pat=0; pat<4; pat++) {
+                // random, long carry chain, all zero, and mixed max/zero limbs.
+                mpn::LimbVec a(n), b(n);
+                for (int k=0; k<n; k++) {
+                    mpn::Limb x = mpn::Limb(gen() % mpn::kBase), y = mpn::Limb(gen() % mpn::kBase);
+                    if (pat == 1) { x = mx; y = k ? 0 : 1; }
+                    if (pat == 2) { x = 0; y = 0; }
+                    if (pat == 3) { x = gen() % 2 ? mx : 0; y = gen() % 3 ? x : mx - x; }
+                    a[k] = x; b[k] = y;
+                }
+                mpn::LimbVec r1(n), r2(n), r3(n), r4(n);
+                mpn::SelectAddSubKernel("scalar");
+                mpn::Limb c1 = mpn::AddN(r1.data(), a.data(), b.data(), n);
+                mpn::Limb b1 = mpn::SubN(r2.data(), a.data(), b.data(), n);
+                mpn::SelectAddSubKernel(name);
+                mpn::Limb c2 = mpn::AddN(r3.data(), a.data(), b.data(), n);
+                mpn::Limb b2 = mpn::SubN(r4.data(), a.data(), b.data(), n);
+                ASSERT(c1 == c2 && r1 == r3, "%s add %d %d", name, n, pat);
+                ASSERT(b1 == b2 && r2 == r4, "%s sub %d %d", name, n, pat);
+                // in-place. (a + b) - b wraps back to a.
+                mpn::LimbVec a0 = a;
+                mpn::AddN(a.data(), a.data(), b.data(), n);
+                ASSERT(a == r1, "%s in-place add %d %d", name, n, pat);
+                mpn::SubN(a.data(), a.data(), b.data(), n);
+                ASSERT(a == a0, "%s in-place sub %d %d", name, n, pat);
+            }
+        }
+        BigInt p = pow10str(1000);
+        ASSERT(BigInt(p - 1) + 1 == p && (p + p - 1) - p == p - 1, "%s bigint", name);
+        printf("kernel %s ok\n", name);
+    }
+    ASSERT(mpn::SelectAddSubKernel("auto"), "auto");
+    printf("current kernel: %s\n", mpn::AddSubKernel());
+
+    // mpn::Cmp skips blocks and words. single difference at every position.
+    for (int n : { 1, 7, 8, 9, 63, 64, 65, 300, 1000 }) {
+        mpn::LimbVec a(n);
+        for (auto& x : a) x = mpn::Limb(gen() % mpn::kBase);
+        a[n - 1] |= 1;
+        ASSERT(mpn::Cmp(a.data(), n, a.data(), n) == 0, "cmp equal %d", n);
+        for (int k=0; k<n; k++) {
+            mpn::LimbVec b = a;
+            b[k] = b[k] == mx ? 0 : b[k] + 1;
+            int c = b[k] > a[k] ? -1 : 1;
+            ASSERT(mpn::Cmp(a.data(), n, b.data(), n) == c && mpn::Cmp(b.data(), n, a.data(), n) == -c, "cmp %d at %d", n, k);
+        }
+    }
+    // three-way comparison of BigInt agrees with Less and Equal.
+    const BigInt big = BigInt(pow10str(500));
+    const BigInt values[] = { 0, 1, -1, 2, -2, big, big + 1, -big, -big - 1, big * big, -(big * big), big * big + 1 };
+    for (const BigInt& a : values) {
+        for (const BigInt& b : values) {
+            int c = a.Compare(b);
+            ASSERT(c == (a.Less(b) ? -1 : a.Equal(b) ? 0 : 1) && c == -b.Compare(a), "compare %s %s", a.ToStr().c_str(), b.ToStr().c_str());
+            ASSERT(((a <=> b) < 0) == (c < 0) && ((a <=> b) == 0) == (a == b) && (a != b) == (c != 0), "<=> %s %s", a.ToStr().c_str(), b.ToStr().c_str());
+        }
+    }
+    return 0;
+}
+
+// b^e % m by plain square-and-multiply, for reference.
+static BigInt naive_powmod(BigInt b, BigInt e, const BigInt& m)
+{
+    BigInt r = 1;
+    b = b % m;
+    while (e > 0) {
+        if (e % 2 == 1) r = r * b % m;
+        b = b * b % m;
+        e /= 2;
+    }
+    return r % m;
+}
+
+int test_bigint_pow(int argc, char **argv)
+{
+    // python pow()
+    ASSERT(pow(BigInt(3), 200, 1000000007) == 136318165, "pow mod");
+    ASSERT(pow(BigInt(2), 1000).ToStr().substr(0, 20) == "10715086071862673209", "2**1000");
+    ASSERT(pow(BigInt(2), 1000) == BigInt(1) * pow(BigInt(4), 500), "2**1000");
+    ASSERT(pow(BigInt(-3), 41) == BigInt("-36472996377170786403"), "negative base");
+    ASSERT(pow(BigInt(-1), 1000001) == -1 && pow(BigInt(-1), 6) == 1 && pow(BigInt(0), 0) == 1 && pow(BigInt(0), 5) == 0, "trivial");
+    ASSERT(pow(BigInt(-7), 13, BigInt("100000000000000000001")) == BigInt("99999999903110989594"), "negative base");
+    ASSERT(pow(BigInt("12345678901234567891"), 98765, BigInt(2) * pow(BigInt(2), 126) * 3 + 4)
+        == BigInt("351714900195684631297261904457842147447"), "even mod");
+    ASSERT(pow(BigInt(7), BigInt("100000000000000000003"), pow(BigInt(10), 40))
+        == BigInt("5143924716608924580000000000000000000343"), "big exponent");
+    ASSERT(pow(BigInt(2), 1000000000, 1000000007) == 140625001, "2^(10^9)");
+    ASSERT(pow(BigInt(3), 2, -5) == -1 && pow(BigInt(-2), 3, -7) == -1 && pow(BigInt(5), 0, -3) == -2, "negative mod");
+    ASSERT(pow(BigInt(5), 0, 1) == 0 && pow(BigInt(5), 3, -1) == 0, "mod 1");
+
+    bool thrown = false;
+    try { pow(BigInt(2), -1); } catch (const std::domain_error&) { thrown = true; }
+    ASSERT(thrown, "negative exponent");
+    thrown = false;
+    try { pow(BigInt(2), 3, 0); } catch (const std::domain_error&) { thrown = true; }
+    ASSERT(thrown, "zero mod");
+
+    // montgomery (odd) and barrett (even) modulus, with and without constant-time.
+    std::mt19937 gen(2030);
+    auto random_big = [&](int digits) {
+        std::string sn(digits, '0');
+        for (auto& c : sn) c = char('0' + gen() % 10);
+        sn[0] = char('1' + gen() % 9);
+        return BigInt(sn);
+    };
+    for (int digits : {1, 5, 10, 19, 20, 40, 100, 310, 620}) {
+        for (int k=0; k<4; k++) {
+            BigInt m = random_big(digits) + (k == 3 ? 2 : 0);
+            if (m == 1) m = 7;
+            if (k == 0 && m % 2 == 0) m += 1;
+            if (k == 1 && m % 2 == 1) m += 1;
+            BigInt b = random_big(digits + 3), e = random_big(k == 2 ? 60 : 12);
+            ModContext ctx(m);
+            BigInt r = naive_powmod(b, e, m);
+            ASSERT(ctx.Pow(b, e) == r, "pow %d %d", digits, k);
+            ASSERT(ctx.Pow(b % m, e, true) == r, "pow const time %d %d", digits, k);
+            ASSERT(ctx.Pow(-b, e) == naive_powmod(m - b % m, e, m), "pow -b %d %d", digits, k);
+            ASSERT(ctx.Pow(b, 0) == 1 && ctx.Pow(b, 1) == b % m, "pow small e %d %d", digits, k);
+        }
+    }
+    // modulus of B^k has zero low limbs, and max size of barrett reciprocal.
+    {
+        BigInt m = pow(BigInt(2), 64), b = BigInt("123456789012345678901"), e = 1000;
+        ASSERT(ModContext(m).Pow(b, e, true) == naive_powmod(b, e, m), "power of base");
+        m = pow(BigInt(10), 30);
+        ASSERT(ModContext(m).Pow(b, e) == naive_powmod(b, e, m), "power of 10");
+    }
+    printf("pow ok\n");
+    return 0;
+}
+
+static BigInt gcd_of(int (*fn)(mpn::Limb*, const mpn::Limb*, int, const mpn::Limb*, int),
+        const mpn::LimbVec& a, const mpn::LimbVec& b)
+{
+    mpn::LimbVec g(std::max(a.size(), b.size()) + 1);
+    int n = fn(g.data(), a.data(), (int)a.size(), b.data(), (int)b.size());
+    std::string s(mpn::DigitsForLimbs(std::max(n, 1)), ' ');
+    s.resize(mpn::GetStr(s.data(), g.data(), n));
+    return BigInt(s);
+}
+
+int test_bigint_gcd(int argc, char **argv)
+{
+    // python math.gcd(), math.lcm(), pow(a, -1, m)
+    ASSERT(gcd(12, 18) == 6 && gcd(-12, 18) == 6 && gcd(12, -18) == 6, "gcd");
+    ASSERT(gcd(0, 0) == 0 && gcd(0, -5) == 5 && gcd(7, 0) == 7, "gcd zero");
+    ASSERT(lcm(4, 6) == 12 && lcm(-4, 6) == 12 && lcm(0, 5) == 0, "lcm");
+    ASSERT(mod_inverse(3, 11) == 4 && mod_inverse(-3, 11) == 7 && mod_inverse(3, -11) == -7, "inverse");
+    ASSERT(mod_inverse(BigInt("12345678901234567891"), pow(BigInt(10), 30))
+        == BigInt("245752133663327711822677925211"), "inverse");
+    ASSERT(pow(BigInt(3), -2, 11) == 5 && mod_inverse(5, 1) == 0, "pow -2");
+    bool thrown = false;
+    try { mod_inverse(6, 9); } catch (const std::domain_error&) { thrown = true; }
+    ASSERT(thrown, "not invertible");
+
+    // cross-check with plain euclid. common factor of various size is mixed.
+    std::mt19937 gen(2031);
+    auto rnd = [&](int n) { return random_limbs(gen, n); };
+    auto mul = [](const mpn::LimbVec& x, const mpn::LimbVec& y) {
+        mpn::LimbVec r(x.size() + y.size());
+        if (x.size() >= y.size()) mpn::Mul(r.data(), x.data(), (int)x.size(), y.data(), (int)y.size());
+        else mpn::Mul(r.data(), y.data(), (int)y.size(), x.data(), (int)x.size());
+        r.resize(mpn::NormSize(r.data(), (int)r.size()));
+        return r;
+    };
+    // (sizes around and above PYCFG_BIGINT_GCD_HGCD_CUTOFF. decimal digit mode uses euclid only)
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    for (int n : {1, 2, 3, 5, 10, 50, 100, 300}) {
+#else
+    for (int n : {1, 2, 3, 5, 10, 50, 100, 999, 1000, 1001, 1600}) {
+#endif
+        for (int k=0; k<3; k++) {
+            int gn = k == 0 ? 0 : k == 1 ? 1 + n / 10 : n / 2 + 1;
+            mpn::LimbVec a = rnd(n), b = rnd(n - k % 2 * (n / 3));
+            if (gn) {
+                mpn::LimbVec g = rnd(gn);
+                a = mul(a, g);
+                b = mul(b, g);
+            }
+            BigInt e = gcd_of(mpn::GcdEuclid, a, b);
+            ASSERT(gcd_of(mpn::GcdLehmer, a, b) == e, "lehmer %d %d", n, k);
+            ASSERT(gcd_of(mpn::Gcd, a, b) == e, "gcd %d %d", n, k);
+            ASSERT(gcd_of(mpn::Gcd, b, a) == e, "gcd swap %d %d", n, k);
+        }
+    }
+    // inverse, through half-gcd path for big ones.
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    for (int digits : {5, 30, 300, 1000}) {
+#else
+    for (int digits : {5, 30, 300, 3000, 12000}) {
+#endif
+        for (int k=0; k<3; k++) {
+            std::string sm(digits, '7'), sa(digits - 2, '3');
+            for (auto& c : sm) c = char('0' + gen() % 10);
+            for (auto& c : sa) c = char('0' + gen() % 10);
+            sm[0] = '9';
+            BigInt m(sm), a(sa);
+            if (k == 1) a = -a;
+            if (gcd(a, m) == 1) {
+                BigInt x = mod_inverse(a, m);
+                ASSERT(x >= 0 && x < m && a * x % m == 1, "inverse %d %d", digits, k);
+            }
+            else {
+                thrown = false;
+                try { mod_inverse(a, m); } catch (const std::domain_error&) { thrown = true; }
+                ASSERT(thrown, "not invertible %d %d", digits, k);
+            }
+        }
+    }
+    printf("gcd ok\n");
+    return 0;
+}
+
+int test_bigint_root(int argc, char **argv)
+{
+    // python math.isqrt()
+    ASSERT(isqrt(0) == 0 && isqrt(1) == 1 && isqrt(15) == 3 && isqrt(16) == 4, "isqrt");
+    ASSERT(isqrt(pow(BigInt(10), 40)) == pow(BigInt(10), 20), "isqrt 10**40");
+    ASSERT(isqrt(pow(BigInt(10), 41)) == BigInt("316227766016837933199"), "isqrt 10**41");
+    ASSERT(isqrt(BigInt("12345678901234567890123456789")) == BigInt("111111110611111"), "isqrt");
+    ASSERT(isqrt(BigInt("18446744073709551615")) == BigInt("4294967295"), "isqrt 2**64-1");
+    ASSERT(iroot(pow(BigInt(10), 30), 3) == pow(BigInt(10), 10) && iroot(pow(BigInt(10), 30) - 1, 3) == pow(BigInt(10), 10) - 1, "iroot");
+    ASSERT(iroot(12345, 1) == 12345 && iroot(0, 7) == 0 && iroot(1, 100) == 1, "iroot trivial");
+    ASSERT(iroot(pow(BigInt(2), 1000), 1001) == 1 && iroot(pow(BigInt(3), 1000), 1000) == 3, "iroot big degree");
+    bool thrown = false;
+    try { isqrt(-1); } catch (const std::domain_error&) { thrown = true; }
+    ASSERT(thrown, "negative");
+    thrown = false;
+    try { iroot(8, 0); } catch (const std::domain_error&) { thrown = true; }
+    ASSERT(thrown, "zero degree");
+
+    // s^k <= a < (s+1)^k, around perfect powers too.
+    std::mt19937 gen(2032);
+#if defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    for (int digits : {1, 5, 10, 19, 20, 21, 40, 100, 1000}) {
+#else
+    for (int digits : {1, 5, 10, 19, 20, 21, 40, 100, 1000, 10000}) {
+#endif
+        for (int k : {2, 3, 5, 17}) {
+            std::string sn(digits, '0');
+            for (auto& c : sn) c = char('0' + gen() % 10);
+            sn[0] = char('1' + gen() % 9);
+            BigInt x(sn);
+            BigInt p = pow(x, k);
+            ASSERT(iroot(p, k) == x && iroot(p - 1, k) == x - 1 && iroot(p + 1, k) == x, "perfect %d %d", digits, k);
+            BigInt s = iroot(x, k);
+            ASSERT(pow(s, k) <= x && x < pow(s + 1, k), "bracket %d %d", digits, k);
+            if (k == 2) {
+                BigInt r = 1;
+                ASSERT(BigInt::Sqrt(p, &r) == x && r == 0, "perfect square %d", digits);
+                ASSERT(BigInt::Sqrt(x, &r) == s && r == x - s * s, "remainder %d", digits);
+                ASSERT(BigInt::Sqrt(p - 1, &r) == x - 1 && r == 2 * x - 2, "remainder %d", digits);
+            }
+        }
+    }
+    // every size of small numbers, where recursion starts.
+    for (int n=1; n<=40; n++) {
+        for (int i=0; i<20; i++) {
+            auto a = random_limbs(gen, n);
+            if (i % 4 == 0) a.back() = 1;
+            mpn::LimbVec s(n), r(n + 2), c(n + 2);
+            int rn, sn = mpn::SqrtRem(s.data(), r.data(), a.data(), n, rn);
+            ASSERT(mpn::Root(c.data(), a.data(), n, 2) == sn && std::equal(s.begin(), s.begin() + sn, c.begin()), "root %d", n);
+            mpn::LimbVec t(2 * sn + 1);
+            mpn::Sqr(t.data(), s.data(), sn);
+            mpn::Add(t.data(), t.data(), 2 * sn + 1, r.data(), rn);
+            ASSERT(mpn::Cmp(t.data(), mpn::NormSize(t.data(), 2 * sn + 1), a.data(), n) == 0, "s*s+r %d", n);
+            mpn::LimbVec s2(sn + 1);
+            s2[sn] = mpn::Mul1(s2.data(), s.data(), sn, 2);
+            ASSERT(mpn::Cmp(r.data(), rn, s2.data(), mpn::NormSize(s2.data(), sn + 1)) <= 0, "r <= 2s %d", n);
+        }
+    }
+    printf("root ok\n");
+    return 0;
+}
+
+int test_bigint_bit(int argc, char **argv)
+{
+    // python values
+    ASSERT((BigInt(12) & 10) == 8 && (BigInt(12) | 10) == 14 && (BigInt(12) ^ 10) == 6, "bitwise");
+    ASSERT((BigInt(-12) & 10) == 0 && (BigInt(-12) | 10) == -2 && (BigInt(-12) ^ 10) == -2, "negative");
+    ASSERT((BigInt(-12) & -10) == -12 && (BigInt(-12) | -10) == -10 && (BigInt(-12) ^ -10) == 2, "negative");
+    ASSERT(~BigInt(5) == -6 && ~BigInt(-1) == 0 && ~BigInt(0) == -1, "invert");
+    ASSERT((BigInt(-5) >> 1) == -3 && (BigInt(-1) >> 100) == -1 && (BigInt(5) >> 100) == 0, "shift right");
+    ASSERT((BigInt(1) << 100) == pow(BigInt(2), 100) && (BigInt(-3) << 0) == -3 && (BigInt(0) << 99) == 0, "shift left");
+    ASSERT(BigInt(-255).BitLength() == 8 && BigInt(-255).BitCount() == 8 && BigInt(0).BitLength() == 0, "bit length");
+    BigInt big = -pow(BigInt(2), 64);
+    ASSERT((big & (big + 1)) == big, "-2**64 & (-2**64 + 1)");
+
+    BigInt a("-123456789012345678901234567890"), b("98765432109876543210");
+    ASSERT((a & b) == BigInt("20213295392617428010"), "and");
+    ASSERT((a | b) == BigInt("-123456788933793542183975452690"), "or");
+    ASSERT((a ^ b) == BigInt("-123456788954006837576592880700"), "xor");
+    ASSERT((a >> 37) == BigInt("-898266364037013256"), "shift right");
+    ASSERT((a << 45) == BigInt("-4343749601502796440598279644055484214804480"), "shift left");
+    ASSERT(~a == BigInt("123456789012345678901234567889"), "invert");
+    ASSERT(a.BitLength() == 97 && a.BitCount() == 54 && !a.TestBit(70) && a.TestBit(3) && a.TestBit(1000), "bits");
+    bool thrown = false;
+    try { a >> -1; } catch (const std::domain_error&) { thrown = true; }
+    ASSERT(thrown, "negative shift count");
+
+    // identities, on random signed numbers of various sizes.
+    std::mt19937 gen(2033);
+    auto random_signed = [&](int digits) {
+        std::string sn(digits, '0');
+        for (auto& c : sn) c = char('0' + gen() % 10);
+        sn[0] = char('1' + gen() % 9);
+        BigInt x(sn);
+        return gen() % 2 ? -x : x;
+    };
+    for (int dx : {1, 9, 10, 19, 20, 40, 100, 300}) {
+        for (int dy : {1, 10, 20, 100}) {
+            BigInt x = random_signed(dx), y = random_signed(dy);
+            ASSERT((x & y) + (x | y) == x + y, "and + or %d %d", dx, dy);
+            ASSERT((x ^ y) == (x | y) - (x & y), "xor %d %d", dx, dy);
+            ASSERT(~(x & y) == (~x | ~y) && ~(x | y) == (~x & ~y), "de morgan %d %d", dx, dy);
+            ASSERT((x ^ x) == 0 && (x & x) == x && (x & ~x) == 0 && (x | ~x) == -1 && (x ^ ~x) == -1, "self %d %d", dx, dy);
+            BigInt z = x;
+            z ^= y;
+            z ^= y;
+            ASSERT(z == x, "xor twice %d %d", dx, dy);
+            for (int k : {0, 1, 31, 32, 33, 64, 100, 1000}) {
+                BigInt p = pow(BigInt(2), k);
+                ASSERT((x << k) == x * p && (x >> k) == x / p, "shift %d %d", dx, k);
+                ASSERT(x.TestBit(k) == (((x >> k) & 1) == 1), "test bit %d %d", dx, k);
+            }
+            long long len = x.BitLength(), cnt = 0;
+            ASSERT((x.Abs() >> len) == 0 && (x.Abs() >> (len - 1)) == 1, "bit length %d", dx);
+            for (long long k=0; k<len; k++)
+                cnt += x.Abs().TestBit(k);
+            ASSERT(x.BitCount() == cnt, "bit count %d", dx);
+        }
+    }
+    printf("bit ok\n");
+    return 0;
+}
+
+int test_bigint_expr(int argc, char **argv)
+{
+    // same result with eager operators, for every sign.
+    std::mt19937 gen(2028);
+    for (int n : {1, 2, 3, 10, 100}) {
+        BigInt v[4];
+        for (int i=0; i<4; i++) {
+            std::string sn(n * 9 - i, '0');
+            for (auto& c : sn) c = char('0' + gen() % 10);
+            sn[0] = char('1' + gen() % 9);
+            v[i] = BigInt(sn);
+        }
+        for (int mask=0; mask<16; mask++) {
+            BigInt a = mask & 1 ? -v[0] : v[0];
+            BigInt b = mask & 2 ? -v[1] : v[1];
+            BigInt c = mask & 4 ? -v[2] : v[2];
+            BigInt d = mask & 8 ? -v[3] : v[3];
+            BigInt x = lazy(a) + b - c;
+            ASSERT(x == a + b - c, "a+b-c %d %d", n, mask);
+            x = lazy(a) - b - c + d;
+            ASSERT(x == a - b - c + d, "a-b-c+d %d %d", n, mask);
+            x = -(lazy(a) - b) + (lazy(c) - d);
+            ASSERT(x == -(a - b) + (c - d), "nested %d %d", n, mask);
+            x = lazy(a) * b + c - lazy(c) * d;
+            ASSERT(x == a * b + c - c * d, "mul %d %d", n, mask);
+            x = (lazy(a) + b) * (lazy(c) - d);
+            ASSERT(x == (a + b) * (c - d), "mul of sum %d %d", n, mask);
+            BigInt y = lazy(a) - a + b - b;
+            ASSERT(y == 0 && !y.IsNegative(), "zero %d %d", n, mask);
+        }
+    }
+    // carry and borrow across all limbs.
+    {
+        BigInt p = pow10str(100);
+        BigInt x = lazy(p) - 1 + p - 1;
+        ASSERT(x == BigInt(pow10str(100)) * 2 - 2, "carry");
+        x = lazy(BigInt(1)) - p - p;
+        ASSERT(x == 1 - p * 2, "borrow");
+        x = lazy(p) + p + p + p + p + p + p + p + p + p;
+        ASSERT(x == BigInt(pow10str(101)), "many terms");
+    }
+    // destination may be one of operands.
+    {
+        BigInt a = pow10str(50), b = 12345, c = -999;
+        BigInt e = a + a + b;
+        a = lazy(a) + a + b;
+        ASSERT(a == e, "alias");
+        e = a + (b - c);
+        a += lazy(b) - c;
+        ASSERT(a == e, "alias +=");
+        e = a - (b * c);
+        a -= lazy(b) * c;
+        ASSERT(a == e, "alias -=");
+        e = b * a - a;
+        a = lazy(b) * a - a;
+        ASSERT(a == e, "alias mul");
+    }
+    // fused sum does not allocate, if destination has enough room.
+    {
+        BigInt a = pow10str(1000), b = BigInt(pow10str(900)) - 1, c = std::string(800, '7');
+        BigInt x = a * 10;
+        long long n0 = g_num_alloc;
+        for (int k=0; k<10; k++) {
+            x = lazy(a) + b - c;
+            x += lazy(a) - b;
+        }
+        ASSERT(g_num_alloc == n0, "heap allocated %lld times", g_num_alloc - n0);
+        ASSERT(x == a + a - c, "result");
+    }
+    printf("expr ok\n");
+    return 0;
+}
+
+int test_bigint_parallel(int argc, char **argv)
+{
+    ASSERT(mpn::ThreadCount() >= 1, "thread count");
+
+    // ParallelFor itself. nested calls, and exception from a task.
+    mpn::SetThreadCount(4);
+    ASSERT(mpn::ThreadCount() == 4, "set thread count");
+    {
+        std::atomic<int> sum = 0;
+        mpn::ParallelFor(0, [&](int) { sum += 1000; });
+        mpn::ParallelFor(8, [&](int i) {
+            mpn::ParallelFor(i, [&](int j) { sum += j + 1; });
+        });
+        ASSERT(sum == 84, "nested sum %d", sum.load());
+        bool bThrown = false;
+        try {
+            mpn::ParallelFor(6, [&](int i) { if (i == 3) throw std::domain_error("task"); });
+        }
+        catch (const std::domain_error&) {
+            bThrown = true;
+        }
+        ASSERT(bThrown, "exception from task");
+    }
+    {
+        // owner sleeps while its last task runs on a worker, instead of spinning.
+        auto cpu = [] {
+            timespec ts;
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+            return ts.tv_sec + ts.tv_nsec * 1e-9;
+        };
+        std::atomic<bool> bStarted = false;
+        double c0 = cpu();
+        mpn::ParallelFor(2, [&](int i) {
+            if (i == 0) {
+                // owner runs task 0, until task 1 is stolen.
+                while (!bStarted)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            else {
+                bStarted = true;
+                std::this_thread::sleep_for(std::chrono::milliseconds(300));
+            }
+        });
+        double used = cpu() - c0;
+        ASSERT(used < 0.1, "owner used %.3f sec of cpu while waiting", used);
+    }
+    printf("parallel for ok\n");
+
+    // every tier gives same result as sequential one.
+    // all-max limbs make long carries across CRT slices.
+    std::mt19937 gen(2031);
+    for (auto [an, bn] : {std::pair{1500, 1500}, {3000, 3000}, {20000, 20000}, {30000, 7000}}) {
+        for (bool bMax : {false, true}) {
+            auto a = random_limbs(gen, an);
+            auto b = random_limbs(gen, bn);
+            if (bMax) {
+                std::fill(a.begin(), a.end(), mpn::kLimbMax);
+                std::fill(b.begin(), b.end(), mpn::kLimbMax);
+            }
+            mpn::LimbVec r0(an + bn), s0(2*an), k0(2*an);
+            mpn::SetThreadCount(1);
+            mpn::Mul(r0.data(), a.data(), an, b.data(), bn);
+            mpn::Sqr(s0.data(), a.data(), an);
+            mpn::MulKaratsuba(k0.data(), a.data(), a.data(), an);
+            ASSERT(s0 == k0, "karatsuba sqr %d", an);
+
+            mpn::SetThreadCount(4);
+            mpn::LimbVec r1(an + bn), s1(2*an), k1(2*an), t1(2*an);
+            mpn::Mul(r1.data(), a.data(), an, b.data(), bn);
+            mpn::Sqr(s1.data(), a.data(), an);
+            mpn::MulKaratsuba(k1.data(), a.data(), a.data(), an);
+            mpn::MulToom3(t1.data(), a.data(), a.data(), an);
+            ASSERT(r0 == r1, "mul %d x %d, max %d", an, bn, bMax);
+            ASSERT(s0 == s1, "sqr %d, max %d", an, bMax);
+            ASSERT(s0 == k1, "karatsuba %d, max %d", an, bMax);
+            ASSERT(s0 == t1, "toom3 %d, max %d", an, bMax);
+        }
+    }
+    printf("parallel mul ok\n");
+
+    // radix conversion tree, both ways.
+    for (int n : {1000, 30000}) {
+        std::string s = std::to_string(gen() % 9 + 1);
+        while ((int)s.size() < n) s += std::to_string(gen());
+        mpn::SetThreadCount(1);
+        BigInt x0(s);
+        BigInt y0 = x0 * x0 + 1;
+        std::string t0 = y0.ToStr();
+        mpn::SetThreadCount(4);
+        BigInt x1(s);
+        ASSERT(x1 == x0, "from string %d", n);
+        ASSERT(x1.ToStr() == s, "to string %d", n);
+        ASSERT((x1 * x1 + 1).ToStr() == t0, "square %d", n);
+    }
+    printf("parallel str ok\n");
+
+    mpn::SetThreadCount(0);
+    ASSERT(mpn::ThreadCount() >= 1, "hardware threads");
+    printf("hardware threads: %d\n", mpn::ThreadCount());
+    mpn::SetThreadCount(1);
+    printf("parallel ok\n");
+    return 0;
+}
+
+int test_bigint_comb(int argc, char **argv)
+{
+    // python math.factorial(), comb(), perm()
+    ASSERT(factorial(0) == 1 && factorial(1) == 1 && factorial(20) == BigInt("2432902008176640000"), "factorial");
+    ASSERT(factorial(25) == BigInt("15511210043330985984000000"), "factorial 25");
+    ASSERT(comb(10, 3) == 120 && comb(5, 7) == 0 && comb(7, 0) == 1 && comb(0, 0) == 1, "comb");
+    ASSERT(perm(10, 3) == 720 && perm(5) == 120 && perm(5, 6) == 0 && perm(5, 0) == 1, "perm");
+    ASSERT(comb(100, 50) == BigInt("100891344545564193334812497256"), "comb 100 50");
+    int thrown = 0;
+    try { factorial(-1); } catch (const std::domain_error&) { thrown++; }
+    try { comb(-1, 2); } catch (const std::domain_error&) { thrown++; }
+    try { perm(5, -1); } catch (const std::domain_error&) { thrown++; }
+    try { factorial(pow(BigInt(10), 12)); } catch (const std::overflow_error&) { thrown++; }
+    try { comb(pow(BigInt(10), 30), pow(BigInt(10), 29)); } catch (const std::overflow_error&) { thrown++; }
+    ASSERT(thrown == 5, "exceptions %d", thrown);
+
+    // term by term, against native and prime factorization tiers.
+    BigInt f = 1;
+    for (int n=1; n<=400; n++) {
+        f *= n;
+        ASSERT(factorial(n) == f, "factorial %d", n);
+    }
+    ASSERT(factorial(1000).Width() == 2568, "digits of 1000!");
+
+    // pascal's rule covers every tier of comb. (k >= 16 and k < n/64 is product tree)
+    for (int n : {30, 100, 1025, 3000}) {
+        for (int k : {0, 1, 5, 15, 16, 17, 40, n / 64 - 1, n / 64, n / 3, n / 2, n - 20, n - 1, n}) {
+            if (k < 1 || k > n)
+                continue;
+            ASSERT(comb(n, k) == comb(n - 1, k - 1) + comb(n - 1, k), "pascal %d %d", n, k);
+            ASSERT(comb(n, k) == comb(n, n - k), "symmetry %d %d", n, k);
+            ASSERT(perm(n, k) == comb(n, k) * factorial(k), "perm %d %d", n, k);
+            ASSERT(perm(n, k) * factorial(n - k) == factorial(n), "perm %d %d", n, k);
+        }
+    }
+    // n beyond native integer.
+    BigInt n = pow(BigInt(10), 30) + 7;
+    ASSERT(comb(n, 3) == n * (n - 1) * (n - 2) / 6, "comb huge n");
+    ASSERT(comb(n, 40) * factorial(40) == perm(n, 40), "perm huge n");
+    ASSERT(comb(n, n - 2) == n * (n - 1) / 2, "comb huge k");
+    printf("comb ok\n");
+    return 0;
+}
+
+// FixedInt is constexpr all the way.
+static_assert(Int128(-7) / 2 == -4 && Int128(-7) % 2 == 1 && Int128(7) % -2 == -1);
+static_assert((Int256(1) << 200) >> 199 == 2 && (Int256(-5) >> 1) == -3);
+static_assert(UInt128(0) - 1 == UInt128::Max() && Int128::Min() - 1 == Int128::Max());
+static_assert(Int512(-3) * Int512(5) == -15 && Int512(-3) < Int512(2) && UInt256(3) > UInt256(2));
+static_assert(((UInt256(1) << 255) / (UInt256(1) << 130)).BitLength() == 126);
+
+// x modulo 2^bits, in range of T.
+template <typename T>
+static BigInt wrap_to(const BigInt& x)
+{
+    BigInt m = BigInt(1) << T::kBits;
+    BigInt r = x & (m - 1);
+    if (T::kSigned && r.TestBit(T::kBits - 1))
+        r -= m;
+    return r;
+}
+
+template <typename T>
+static void test_fixed_random(std::mt19937& gen)
+{
+    auto random_fixed = [&](int bits) {
+        BigInt x = 0;
+        for (int k=0; k<bits; k+=32)
+            x = (x << 32) + BigInt((long long)gen());
+        x >>= (bits + 31) / 32 * 32 - bits;
+        return wrap_to<T>(x);
+    };
+    for (int i=0; i<300; i++) {
+        int abits = 1 + gen() % T::kBits, bbits = 1 + gen() % T::kBits;
+        BigInt a = random_fixed(abits), b = random_fixed(bbits);
+        T x(a), y(b);
+        ASSERT(x.ToBigInt() == a && T(a.ToStr()) == x, "round trip %s", a.ToStr().c_str());
+        ASSERT((x + y).ToBigInt() == wrap_to<T>(a + b), "add %s %s", a.ToStr().c_str(), b.ToStr().c_str());
+        ASSERT((x - y).ToBigInt() == wrap_to<T>(a - b), "sub %s %s", a.ToStr().c_str(), b.ToStr().c_str());
+        ASSERT((x * y).ToBigInt() == wrap_to<T>(a * b), "mul %s %s", a.ToStr().c_str(), b.ToStr().c_str());
+        ASSERT((x & y).ToBigInt() == (a & b) && (x | y).ToBigInt() == (a | b) && (x ^ y).ToBigInt() == (a ^ b), "bitwise");
+        ASSERT(((x < y) == (a < b)) && ((x == y) == (a == b)), "compare");
+        if (!b.IsZero() && !(a == T::Min().ToBigInt() && b == -1)) {
+            ASSERT((x / y).ToBigInt() == a / b, "div %s %s", a.ToStr().c_str(), b.ToStr().c_str());
+            ASSERT((x % y).ToBigInt() == a % b, "mod %s %s", a.ToStr().c_str(), b.ToStr().c_str());
+        }
+        int sh = gen() % (T::kBits + 10);
+        ASSERT((x << sh).ToBigInt() == wrap_to<T>(a << sh), "shl %d", sh);
+        ASSERT((x >> sh).ToBigInt() == (a >> sh), "shr %d", sh);
+        ASSERT(x.BitLength() == a.BitLength() && x.BitCount() == a.BitCount(), "bits");
+    }
+}
+
+int test_bigint_fixed(int argc, char **argv)
+{
+    ASSERT(Int128::Max().ToStr() == "170141183460469231731687303715884105727", "max");
+    ASSERT(Int128::Min().ToStr() == "-170141183460469231731687303715884105728", "min");
+    ASSERT(UInt128::Max().ToBigInt() == (BigInt(1) << 128) - 1, "umax");
+    ASSERT(Int128(LLONG_MIN).ToBigInt() == BigInt(LLONG_MIN) && UInt128(~0ULL).ToBigInt() == BigInt("18446744073709551615"), "native");
+    ASSERT((FixedInt<32>(-1).ToBigInt() == -1 && FixedInt<32, false>(-1).ToBigInt() == 4294967295LL), "32 bit");
+    Int256 c = 0;
+    for (int i=0; i<1000; i++) c++;
+    ASSERT(c == 1000 && --c == 999, "counter");
+
+    // checked conversion from BigInt.
+    int thrown = 0;
+    try { Int128(BigInt(1) << 127); } catch (const std::overflow_error&) { thrown++; }
+    try { UInt128(BigInt(1) << 128); } catch (const std::overflow_error&) { thrown++; }
+    try { UInt128(-1 * BigInt(1)); } catch (const std::overflow_error&) { thrown++; }
+    try { Int128(1) / 0; } catch (const std::domain_error&) { thrown++; }
+    try { Int128(1) << -1; } catch (const std::domain_error&) { thrown++; }
+    ASSERT(thrown == 5, "exceptions %d", thrown);
+    ASSERT(Int128(-(BigInt(1) << 127)) == Int128::Min() && Int128::Fits((BigInt(1) << 127) - 1), "boundary");
+
+    std::mt19937 gen(2033);
+    test_fixed_random<FixedInt<32>>(gen);
+    test_fixed_random<Int128>(gen);
+    test_fixed_random<UInt128>(gen);
+    test_fixed_random<Int256>(gen);
+    test_fixed_random<UInt512>(gen);
+    printf("fixed ok\n");
+    return 0;
+}
+
+// a op n, with native n and with BigInt(n). every result should be same.
+template <typename T>
+static void check_native(const BigInt& a, T n)
+{
+    const BigInt b(n);
+    std::string as = a.ToStr(), bs = b.ToStr();
+    ASSERT(a + n == a + b && n + a == b + a, "add %s %s", as.c_str(), bs.c_str());
+    ASSERT(a - n == a - b && n - a == b - a, "sub %s %s", as.c_str(), bs.c_str());
+    ASSERT(a * n == a * b && n * a == b * a, "mul %s %s", as.c_str(), bs.c_str());
+    ASSERT((a == n) == (a == b) && (a < n) == (a < b) && (a > n) == (a > b), "compare %s %s", as.c_str(), bs.c_str());
+    ASSERT((n < a) == (b < a) && (n >= a) == (b >= a) && (n != a) == (a != b), "compare %s %s", as.c_str(), bs.c_str());
+    if (n != 0) {
+        ASSERT(a / n == a / b, "div %s %s", as.c_str(), bs.c_str());
+        ASSERT(a % n == a % b && (BigInt(a) %= n) == a % b, "mod %s %s", as.c_str(), bs.c_str());
+    }
+}
+
+int test_bigint_native(int argc, char **argv)
+{
+    // no temporary BigInt for native operand, even for a big number.
+    BigInt x = BigInt(pow10str(100)) + 12345;
+    long long n0 = g_num_alloc;
+    for (int i=0; i<1000; i++) {
+        ++x;
+        x += 5;
+        x -= 6u;
+        x--;
+        x += i;
+        x -= (int64_t)i;
+        ASSERT(x > 0 && x != -1 && 7 < x, "compare");
+    }
+    ASSERT(g_num_alloc == n0, "heap allocated %lld times", g_num_alloc - n0);
+    ASSERT(x == BigInt(pow10str(100)) + 12345 - 1000, "counter");
+
+    // every sign, limb count and carry out.
+    const BigInt big = BigInt(pow10str(30));
+    const BigInt values[] = { 0, 1, -1, 9, 10, 4294967295LL, 4294967296LL, -4294967296LL, LLONG_MAX, LLONG_MIN,
+        BigInt(ULLONG_MAX), BigInt(ULLONG_MAX) + 1, -BigInt(ULLONG_MAX), big, -big, big - 1 };
+    for (const BigInt& a : values) {
+        check_native(a, 0);
+        check_native(a, 1);
+        check_native(a, -1);
+        check_native(a, 7u);
+        check_native(a, (short)-9);
+        check_native(a, 4294967295u);
+        check_native(a, 4294967296LL);
+        check_native(a, LLONG_MAX);
+        check_native(a, LLONG_MIN);
+        check_native(a, ULLONG_MAX);
+        check_native(a, (uint64_t)LLONG_MAX + 2);
+        check_native(a, (int64_t)-123456789012LL);
+    }
+    ASSERT(BigInt(ULLONG_MAX).ToStr() == "18446744073709551615" && BigInt(LLONG_MIN).ToStr() == "-9223372036854775808", "ctor");
+    ASSERT(BigInt(-1) % ULLONG_MAX == ULLONG_MAX - 1 && BigInt(-7) % 2 == 1, "remainder type");
+    printf("native ok\n");
+    return 0;
+}
+
+// d is the double nearest to num/den (den > 0): |num/den - d| <= ulp(d)/2, checked exactly.
+static bool is_nearest(const BigInt& num, const BigInt& den, double d)
+{
+    int e;
+    double f = std::frexp(d, &e);
+    BigInt m((long long)std::ldexp(f, 53));
+    int k = e - 53, u = std::max(k, -1074);
+    int s = std::max(0, -std::min(k, u));
+    BigInt err = (num << s) - ((m * den) << (k + s));
+    if (err < 0) err = -err;
+    return (err << 1) <= (den << (u + s));
+}
+
+static BigInt random_bits(std::mt19937& gen, int bits)
+{
+    BigInt x = 0;
+    for (int i = 0; i < bits; i += 32) x = (x << 32) + (unsigned)gen();
+    return x >> (int)(x.BitLength() > bits ? x.BitLength() - bits : 0);
+}
+
+int test_bigint_conv(int argc, char **argv)
+{
+    // native boundaries
+    ASSERT(BigInt(127).CanFit<int8_t>() && !BigInt(128).CanFit<int8_t>() && BigInt(-128).CanFit<int8_t>() && !BigInt(-129).CanFit<int8_t>(), "int8");
+    ASSERT(BigInt(255).CanFit<uint8_t>() && !BigInt(256).CanFit<uint8_t>() && !BigInt(-1).CanFit<uint8_t>(), "uint8");
+    ASSERT(BigInt(LLONG_MIN).CanFit<int64_t>() && !(BigInt(LLONG_MIN) - 1).CanFit<int64_t>() && !(BigInt(LLONG_MAX) + 1).CanFit<int64_t>(), "int64");
+    ASSERT(BigInt(ULLONG_MAX).CanFit<uint64_t>() && !(BigInt(ULLONG_MAX) + 1).CanFit<uint64_t>() && BigInt(0).CanFit<uint64_t>(), "uint64");
+    ASSERT(BigInt(LLONG_MIN).ToInt64() == LLONG_MIN && BigInt(ULLONG_MAX).ToUInt64() == ULLONG_MAX && BigInt(-5).To<short>() == -5, "To");
+    int thrown = 0;
+    try { (BigInt(1) << 64).ToUInt64(); } catch (const std::overflow_error&) { thrown++; }
+    try { BigInt(-1).To<unsigned>(); } catch (const std::overflow_error&) { thrown++; }
+    try { BigInt(32768).To<short>(); } catch (const std::overflow_error&) { thrown++; }
+    ASSERT(thrown == 3, "To overflow %d", thrown);
+    int iv = 7;
+    ASSERT(!BigInt(pow10str(20)).TryTo(iv) && iv == 7 && BigInt(-2147483648LL).TryTo(iv) && iv == INT_MIN, "TryTo");
+
+    // ToDouble, ties to even
+    const BigInt p53 = BigInt(1) << 53;
+    ASSERT(p53.ToDouble() == 9007199254740992.0 && (p53 + 1).ToDouble() == 9007199254740992.0, "2^53+1");
+    ASSERT((p53 + 3).ToDouble() == 9007199254740996.0 && (-(p53 + 3)).ToDouble() == -9007199254740996.0, "2^53+3");
+    ASSERT(((p53 + 1) << 100).ToDouble() == std::ldexp(1.0, 153) && (((p53 + 1) << 100) + 1).ToDouble() == std::ldexp(1.0, 153) + std::ldexp(1.0, 101), "sticky");
+    ASSERT(BigInt(0).ToDouble() == 0.0 && BigInt(-1).ToDouble() == -1.0 && BigInt(ULLONG_MAX).ToDouble() == 18446744073709551616.0, "small");
+    ASSERT(BigInt("12345678901234567890123456789").ToDouble() == 1.2345678901234568e+28, "decimal");
+    const BigInt dmax = ((BigInt(1) << 53) - 1) << 971;
+    ASSERT(dmax.ToDouble() == DBL_MAX && (dmax + (BigInt(1) << 970) - 1).ToDouble() == DBL_MAX, "max");
+    thrown = 0;
+    try { (dmax + (BigInt(1) << 970)).ToDouble(); } catch (const std::overflow_error&) { thrown++; }
+    try { (-(BigInt(1) << 1024)).ToDouble(); } catch (const std::overflow_error&) { thrown++; }
+    ASSERT(thrown == 2, "ToDouble overflow %d", thrown);
+
+    // true division
+    ASSERT(truediv(1, 3) == 1.0 / 3 && truediv(-7, 2) == -3.5 && truediv(0, -5) == 0.0 && truediv(p53 + 1, 1) == 9007199254740992.0, "small div");
+    ASSERT(truediv(BigInt(pow10str(400)) + 1, BigInt(pow10str(380)) * 3) == 3.333333333333333e+19, "big div");
+    ASSERT(truediv(BigInt(pow10str(30)), 7) == 1.4285714285714285e+29, "div 7");
+    ASSERT(truediv(1, BigInt(pow10str(320))) == 1e-320 && truediv(1, BigInt(pow10str(330))) == 0.0, "subnormal");
+    ASSERT(truediv(-1, BigInt(pow10str(310)) * 3) == -3.333333333333e-311, "negative subnormal");
+    ASSERT(truediv(BigInt(1) << 2000, BigInt(1) << 1990) == 1024.0, "exact");
+    thrown = 0;
+    try { truediv(1, 0); } catch (const std::domain_error&) { thrown++; }
+    try { truediv(BigInt(1) << 1100, 3); } catch (const std::overflow_error&) { thrown++; }
+    ASSERT(thrown == 2, "truediv error %d", thrown);
+
+    std::mt19937 gen(2034);
+    for (int i = 0; i < 2000; i++) {
+        BigInt a = random_bits(gen, 1 + gen() % 1000);
+        ASSERT(is_nearest(a, 1, a.ToDouble()), "ToDouble %s", a.ToStr().c_str());
+        BigInt b = random_bits(gen, 1 + gen() % 1000) + 1;
+        double q = truediv(a, b);
+        ASSERT(is_nearest(a, b, q) && truediv(-a, b) == -q && truediv(a, -b) == -q, "truediv %s %s", a.ToStr().c_str(), b.ToStr().c_str());
+    }
+    printf("conv ok\n");
+    return 0;
+}
+
+static std::string hex(const std::vector<std::byte>& v)
+{
+    std::string s;
+    char buf[4];
+    for (std::byte b : v) {
+        snprintf(buf, sizeof(buf), "%02x", unsigned(b));
+        s += buf;
+    }
+    return s;
+}
+
+static std::vector<std::byte> bytes(std::initializer_list<int> l)
+{
+    std::vector<std::byte> v;
+    for (int b : l) v.push_back(std::byte(b));
+    return v;
+}
+
+int test_bigint_bytes(int argc, char **argv)
+{
+    constexpr auto big = std::endian::big, little = std::endian::little;
+    // python int.to_bytes(), int.from_bytes()
+    const BigInt x = pow(BigInt(3), 100);
+    ASSERT(hex(to_bytes(1024, 2)) == "0400" && hex(to_bytes(1024, 3, little)) == "000400", "1024");
+    ASSERT(hex(to_bytes(x, 20)) == "5a4653ca673768565b41f775d6947d55cf3813d1", "3**100");
+    ASSERT(hex(to_bytes(-x, 21, little, true)) == "2fecc730aa826b298a08bea4a997c89835acb9a5ff", "-3**100");
+    ASSERT(hex(to_bytes(-1024, 10, big, true)) == "fffffffffffffffffc00", "-1024");
+    ASSERT(hex(to_bytes(-128, 1, big, true)) == "80" && hex(to_bytes(255, 1)) == "ff" && to_bytes(0, 0).empty(), "edge");
+    ASSERT(from_bytes(bytes({ 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0 }), big, true) == BigInt("-604462909807314587353088"), "min");
+    ASSERT(from_bytes(bytes({ 0xff, 0xfc, 0x00 }), big, true) == -1024 && from_bytes(bytes({ 0xff, 0xfc, 0x00 })) == 0xfffc00, "signed");
+    ASSERT(from_bytes(bytes({})) == 0 && from_bytes(bytes({ 0, 0, 1 }), little) == 65536, "from");
+    int thrown = 0;
+    try { to_bytes(128, 1, big, true); } catch (const std::overflow_error&) { thrown++; }
+    try { to_bytes(-129, 1, big, true); } catch (const std::overflow_error&) { thrown++; }
+    try { to_bytes(256, 1); } catch (const std::overflow_error&) { thrown++; }
+    try { to_bytes(-1, 8); } catch (const std::overflow_error&) { thrown++; }
+    try { to_bytes(-1, 0, big, true); } catch (const std::overflow_error&) { thrown++; }
+    ASSERT(thrown == 5, "to_bytes overflow %d", thrown);
+
+    std::mt19937 gen(2035);
+    std::vector<BigInt> v = { 0, 1, -1, 255, 256, -256, LLONG_MIN, BigInt(ULLONG_MAX), BigInt(1) << 512 };
+    for (int i=0; i<500; i++) {
+        BigInt a = random_bits(gen, 1 + gen() % 700);
+        v.push_back(i % 2 ? -a : a);
+    }
+    for (const BigInt& a : v) {
+        size_t n = size_t(a.BitLength() / 8 + 1);
+        for (size_t len : { n, n + 3 }) {
+            for (auto order : { big, little }) {
+                ASSERT(from_bytes(to_bytes(a, len, order, true), order, true) == a, "signed %s", a.ToStr().c_str());
+                if (a >= 0)
+                    ASSERT(from_bytes(to_bytes(a, len, order), order) == a, "unsigned %s", a.ToStr().c_str());
+            }
+        }
+    }
+
+    // compact encoding
+    auto enc = [](const BigInt& a) {
+        std::vector<std::byte> b(a.EncodedSize());
+        ASSERT(a.Encode(b) == b.size(), "encode size");
+        return hex(b);
+    };
+    ASSERT(enc(0) == "00" && enc(1) == "0201" && enc(-1) == "0301" && enc(255) == "02ff" && enc(-256) == "050001", "encode");
+    ASSERT(enc(BigInt(1) << 512) == "8201" + std::string(128, '0') + "01", "encode long");
+    thrown = 0;
+    for (auto b : { bytes({ 0x01 }), bytes({ 0x04, 0x01, 0x00 }), bytes({ 0x04, 0x01 }), bytes({ 0x80 }), bytes({}),
+            std::vector<std::byte>(11, std::byte{0xff}),
+            bytes({ 0x82, 0x00, 0x05 }), bytes({ 0x80, 0x00 }), bytes({ 0x82, 0x80, 0x00, 0x05 }) }) {
+        try { BigInt::Decode(b); } catch (const std::invalid_argument&) { thrown++; }
+    }
+    ASSERT(thrown == 9, "decode invalid %d", thrown);
+    ASSERT(BigInt::Decode(bytes({ 0x02, 0x05 })) == 5 && BigInt::Decode(bytes({ 0x00 })) == 0, "decode canonical");
+
+    // bulk
+    std::vector<std::byte> buf(BigInt::EncodedSize(v));
+    ASSERT(BigInt::EncodeAll(v, buf) == buf.size(), "bulk size");
+    std::vector<BigInt> w = { 7 };
+    ASSERT(BigInt::DecodeAll(buf, w) == buf.size() && w.size() == v.size() + 1, "bulk decode");
+    ASSERT(std::equal(v.begin(), v.end(), w.begin() + 1), "bulk values");
+    thrown = 0;
+    try { BigInt::EncodeAll(v, std::span<std::byte>(buf).first(buf.size() - 1)); } catch (const std::length_error&) { thrown++; }
+    try { BigInt::DecodeAll(std::span<const std::byte>(buf).first(buf.size() - 1), w); } catch (const std::invalid_argument&) { thrown++; }
+    // overlong count, {0x81, 0x00} for 1.
+    try { BigInt::DecodeAll(bytes({ 0x81, 0x00, 0x02, 0x05 }), w); } catch (const std::invalid_argument&) { thrown++; }
+    ASSERT(thrown == 3, "bulk error %d", thrown);
+    w.clear();
+    ASSERT(BigInt::DecodeAll(bytes({ 0x01, 0x02, 0x05 }), w) == 3 && w.size() == 1 && w[0] == 5, "bulk canonical");
+#if !defined(PYCFG_BIGINT_DECIMAL_DIGIT)
+    // no temporary, only output buffer.
+    long long n0 = g_num_alloc;
+    BigInt::EncodeAll(v, buf);
+    ASSERT(g_num_alloc == n0, "heap allocated %lld times", g_num_alloc - n0);
+#endif
+    printf("bytes ok\n");
+    return 0;
+}
+
+// raw limb bytes of a, as if written to a file. padded with zero limbs.
+static std::vector<std::byte> limb_file(const BigInt& a, int pad)
+{
+    auto limbs = BigIntView(a).Limbs();
+    std::vector<std::byte> f((limbs.size() + pad) * sizeof(mpn::Limb));
+    if (!limbs.empty())
+        std::memcpy(f.data(), limbs.data(), limbs.size_bytes());
+    return f;
+}
+
+int test_bigint_view(int argc, char **argv)
+{
+    std::mt19937 gen(2036);
+    std::vector<BigInt> v = { 0, 1, -1, 4294967295LL, -4294967296LL, BigInt(ULLONG_MAX), BigInt(pow10str(30)) };
+    for (int bits : { 100, 1000, 20000, 60000 }) {
+        BigInt a = random_bits(gen, bits);
+        v.push_back(a);
+        v.push_back(-a);
+    }
+    for (const BigInt& a : v) {
+        auto f = limb_file(a, 2);
+        BigIntView w = BigIntView::FromBytes(f, a < 0);
+        std::string as = a.ToStr();
+        ASSERT(w == a && a == w && !(w < a) && w.ToStr() == as && w.ToBigInt() == a, "view %s", as.c_str());
+        ASSERT(w.IsZero() == a.IsZero() && w.IsNegative() == (a < 0) && w.Abs() == a.Abs(), "view %s", as.c_str());
+        for (const BigInt& b : v) {
+            std::string bs = b.ToStr();
+            ASSERT((b < w) == (b < a) && (w <= b) == (a <= b) && (w != b) == (a != b), "compare %s %s", bs.c_str(), as.c_str());
+            ASSERT(b + w == b + a && b - w == b - a, "add %s %s", bs.c_str(), as.c_str());
+            if (a.BitLength() + b.BitLength() < 40000)
+                ASSERT(b * w == b * a, "mul %s %s", bs.c_str(), as.c_str());
+        }
+    }
+    // view of itself
+    BigInt x = v.back();
+    x += BigIntView(x);
+    ASSERT(x == v.back() * 2, "self add");
+    x -= BigIntView(x);
+    ASSERT(x == 0, "self sub");
+    x = v[8];
+    x *= BigIntView(x);
+    ASSERT(x == v[8] * v[8], "self mul");
+
+    ASSERT(BigIntView() == 0 && BigIntView().ToStr() == "0" && BigIntView(std::span<const mpn::Limb>(), true) == 0, "zero");
+    auto f = limb_file(v[9], 0);
+    int thrown = 0;
+    try { BigIntView::FromBytes(std::span<const std::byte>(f).subspan(1)); } catch (const std::invalid_argument&) { thrown++; }
+    try { BigIntView::FromBytes(std::span<const std::byte>(f).first(f.size() - 1)); } catch (const std::invalid_argument&) { thrown++; }
+    // any byte is a whole limb for decimal digit.
+    ASSERT(thrown == (sizeof(mpn::Limb) > 1 ? 2 : 0), "misaligned %d", thrown);
+
+    // comparison and ToBigInt read in place. nothing is allocated for comparison.
+    BigIntView w = BigIntView::FromBytes(f);
+    long long n0 = g_num_alloc;
+    bool b = w == v[9] && w > v[7] && w > 0;
+    ASSERT(b && g_num_alloc == n0, "heap allocated %lld times", g_num_alloc - n0);
+
+    // native one, also beyond inline storage of decimal digit build.
+    for (const BigInt& a : v) {
+        for (long long n : { 0LL, 1LL, -1LL, 4294967296LL, -4294967296LL, 100000000000LL, LLONG_MAX, LLONG_MIN })
+            ASSERT((BigIntView(a) <=> n) == (a <=> n) && (BigIntView(a) == n) == (a == n), "native %s %lld", a.ToStr().c_str(), n);
+        ASSERT((BigIntView(a) <=> ULLONG_MAX) == (a <=> ULLONG_MAX), "native %s", a.ToStr().c_str());
+    }
+    n0 = g_num_alloc;
+    b = BigIntView(v[5]) == ULLONG_MAX && BigIntView(v[4]) == -4294967296LL && BigIntView(v[3]) < 100000000000LL && BigIntView(v[6]) > LLONG_MAX;
+    ASSERT(b && g_num_alloc == n0, "heap allocated %lld times", g_num_alloc - n0);
+    printf("view ok\n");
+    return 0;
+}
+
+int test_bigint_hash(int argc, char **argv)
+{
+    // same as native integer in range of long long.
+    for (long long x : { 0LL, 1LL, -1LL, 42LL, -4294967296LL, 4294967296LL, LLONG_MAX, LLONG_MIN })
+        ASSERT(std::hash<BigInt>{}(BigInt(x)) == std::hash<long long>{}(x), "native %lld", x);
+
+    // equal values made in other ways
+    const BigInt big = BigInt(pow10str(50)) + 7;
+    ASSERT(big.Hash() == (BigInt(pow10str(50)) * 3 + 21 - big * 2).Hash(), "equal");
+    ASSERT(big.Hash() != (-big).Hash() && (BigInt(LLONG_MAX) + 1).Hash() != (BigInt(LLONG_MIN)).Hash(), "sign");
+    ASSERT(BigIntView(big).Hash() == big.Hash() && std::hash<BigIntView>{}(BigIntView(-big)) == (-big).Hash(), "view");
+    ASSERT(BigIntView(BigInt(-5)).Hash() == std::hash<long long>{}(-5), "view native");
+
+    // no string, no heap
+    long long n0 = g_num_alloc;
+    volatile size_t h = big.Hash() ^ BigIntView(big).Hash();
+    (void)h;
+    ASSERT(g_num_alloc == n0, "heap allocated %lld times", g_num_alloc - n0);
+
+    // spread of low bits, for consecutive big keys. expected about 51300 of 65536 buckets.
+    std::unordered_set<size_t> low;
+    const BigInt base = BigInt(1) << 100;
+    for (int i=0; i<100000; i++)
+        low.insert((base + i).Hash() & 0xFFFF);
+    ASSERT(low.size() > 50000, "low bits %d", (int)low.size());
+
+    // as key
+    std::unordered_map<BigInt, int> m;
+    for (int i=0; i<1000; i++) {
+        m[base * i] = i;
+        m[-(base * i) - 1] = -i;
+    }
+    ASSERT(m.size() == 2000 && m[base * 500] == 500 && m[-(base * 7) - 1] == -7 && m.count(base + 1) == 0, "map");
+    std::unordered_set<BigInt, BigIntHash, std::equal_to<>> set = { big, -big, 5 };
+    ASSERT(set.find(BigIntView(big)) != set.end() && set.count(BigIntView(BigInt(5))) == 1 && set.count(BigIntView(BigInt(6))) == 0, "transparent");
+    printf("hash ok\n");
+    return 0;
+}
+
+// feeds s in random pieces.
+static BigInt parse_chunked(std::mt19937& gen, const std::string& s, int maxChunk)
+{
+    BigIntParser p;
+    size_t pos = 0;
+    while (pos < s.size()) {
+        size_t n = std::min(s.size() - pos, (size_t)(gen() % maxChunk + 1));
+        size_t used = p.Feed(std::string_view(s).substr(pos, n));
+        pos += used;
+        if (used < n)
+            break;
+    }
+    return p.Finish();
+}
+
+int test_bigint_parse(int argc, char **argv)
+{
+    std::mt19937 gen(2037);
+    auto digits = [&](int n) {
+        std::string s(n, '0');
+        for (char& c : s)
+            c = (char)('0' + gen() % 10);
+        s[0] = (char)('1' + gen() % 9);
+        return s;
+    };
+    const int B = PYCFG_BIGINT_PARSE_BLOCK;
+    // block boundaries, where merged values have many trailing zero digits.
+#ifdef PYCFG_BIGINT_DECIMAL_DIGIT
+    std::vector<int> sizes = { 1, 30, B - 1, B, B + 1, 2 * B + 3 };
+#else
+    std::vector<int> sizes = { 1, 30, 5000, B - 1, B, B + 1, 2 * B, 3 * B + 5, 4 * B + 1 };
+#endif
+    for (int n : sizes) {
+        std::string s = digits(n);
+        s[n / 2] = '0';
+        BigInt a(s);
+        for (int maxChunk : { 1, 7, 4096, n }) {
+            if (maxChunk == 1 && n > 100000)
+                continue;
+            ASSERT(parse_chunked(gen, s, maxChunk) == a, "chunked %d by %d", n, maxChunk);
+            ASSERT(parse_chunked(gen, "-" + s + "x123", maxChunk) == -a, "negative %d by %d", n, maxChunk);
+        }
+        // zeros of a whole block
+        std::string z = "1" + std::string(B, '0') + s;
+        ASSERT(parse_chunked(gen, z, 4096) == BigInt(z), "zero block %d", n);
+    }
+
+    // signs and stop
+    struct { const char* s; long long v; size_t used; } cases[] = {
+        { "", 0, 0 }, { "-", 0, 1 }, { "+", 0, 1 }, { "-0", 0, 2 }, { "+12", 12, 3 }, { "--1", 0, 1 },
+        { "12ab", 12, 2 }, { "1_000_000", 1000000, 9 }, { "-1_2_3", -123, 6 }, { "1__0", 1, 1 },
+        { "_1", 0, 0 }, { "1_", 1, 2 }, { "1_x", 1, 1 }, { "-_1", 0, 1 }, { "0_0", 0, 3 },
+    };
+    for (auto& c : cases) {
+        BigIntParser p;
+        size_t used = p.Feed(c.s);
+        BigInt x = p.Finish();
+        ASSERT(used == c.used && x == c.v, "'%s' used %d value %s", c.s, (int)used, x.ToStr().c_str());
+        ASSERT(BigInt(std::string(c.s)) == c.v, "ctor '%s'", c.s);
+    }
+    // separator split over chunks. '_' of previous chunk is already consumed.
+    {
+        BigIntParser p;
+        ASSERT(p.Feed("1_") == 2 && p.Feed("2") == 1 && p.Finish() == 12, "split 1_ 2");
+        ASSERT(p.Feed("1_") == 2 && p.Feed("x") == 0 && p.Stopped() && p.Finish() == 1, "split 1_ x");
+        ASSERT(p.Feed("9") == 1 && !p.Stopped() && p.Digits() == 1 && p.Finish() == 9, "reset");
+    }
+    std::string big = digits(20000), sep;
+    for (size_t i=0; i<big.size(); i++)
+        sep += (i % 3 == 2 && i + 1 < big.size()) ? std::string(1, big[i]) + "_" : std::string(1, big[i]);
+    ASSERT(BigInt(sep) == BigInt(big) && parse_chunked(gen, sep, 5) == BigInt(big), "separated");
+
+    // istream
+    {
+        std::istringstream is("  -12_345 rest 99");
+        BigInt x, y;
+        std::string w;
+        is >> x >> w >> y;
+        ASSERT(is && x == -12345 && w == "rest" && y == 99, "stream %s %s", x.ToStr().c_str(), w.c_str());
+        ASSERT(!(is >> x) && is.eof(), "stream eof");
+    }
+    {
+        std::istringstream is("1_x 2_ abc");
+        BigInt x, y, z = 5;
+        std::string w;
+        is >> x >> w >> y >> w >> z;
+        ASSERT(x == 1 && y == 2 && w == "_", "stream separator %s", w.c_str());
+        ASSERT(is.fail() && z == 0, "stream fail");
+    }
+    {
+        std::istringstream is(big + "_" + big + ";");
+        BigInt x;
+        is >> x;
+        ASSERT(is && x == BigInt(big + big) && is.get() == ';', "stream large");
+    }
+    printf("parse ok\n");
+    return 0;
+}
+
+int test_bigint_format(int argc, char **argv)
+{
+    // expected strings are from python format(int, spec)
+    const BigInt vals[] = { 0, 1234, -1234, -((BigInt(1) << 128) - 1) };
+    struct { const char* spec; const char* res[4]; } cases[] = {
+        { "", { "0", "1234", "-1234", "-340282366920938463463374607431768211455" } },
+        { "d", { "0", "1234", "-1234", "-340282366920938463463374607431768211455" } },
+        { "+", { "+0", "+1234", "-1234", "-340282366920938463463374607431768211455" } },
+        { "+,", { "+0", "+1,234", "-1,234", "-340,282,366,920,938,463,463,374,607,431,768,211,455" } },
+        { " ", { " 0", " 1234", "-1234", "-340282366920938463463374607431768211455" } },
+        { "_", { "0", "1_234", "-1_234", "-340_282_366_920_938_463_463_374_607_431_768_211_455" } },
+        { "010,", { "00,000,000", "00,001,234", "-0,001,234", "-340,282,366,920,938,463,463,374,607,431,768,211,455" } },
+        { "09,", { "0,000,000", "0,001,234", "-0,001,234", "-340,282,366,920,938,463,463,374,607,431,768,211,455" } },
+        { "08,", { "0,000,000", "0,001,234", "-001,234", "-340,282,366,920,938,463,463,374,607,431,768,211,455" } },
+        { "0=10,", { "00,000,000", "00,001,234", "-0,001,234", "-340,282,366,920,938,463,463,374,607,431,768,211,455" } },
+        { "x<10,", { "0xxxxxxxxx", "1,234xxxxx", "-1,234xxxx", "-340,282,366,920,938,463,463,374,607,431,768,211,455" } },
+        { "_x", { "0", "4d2", "-4d2", "-ffff_ffff_ffff_ffff_ffff_ffff_ffff_ffff" } },
+        { "#_b", { "0b0", "0b100_1101_0010", "-0b100_1101_0010", "-0b1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111" } },
+        { "#010x", { "0x00000000", "0x000004d2", "-0x00004d2", "-0xffffffffffffffffffffffffffffffff" } },
+        { "^12", { "     0      ", "    1234    ", "   -1234    ", "-340282366920938463463374607431768211455" } },
+        { "*>+12,", { "**********+0", "******+1,234", "******-1,234", "-340,282,366,920,938,463,463,374,607,431,768,211,455" } },
+        { "=10", { "         0", "      1234", "-     1234", "-340282366920938463463374607431768211455" } },
+        { "-10", { "         0", "      1234", "     -1234", "-340282366920938463463374607431768211455" } },
+        { "#o", { "0o0", "0o2322", "-0o2322", "-0o3777777777777777777777777777777777777777777" } },
+        { "X", { "0", "4D2", "-4D2", "-FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF" } },
+        { "#X", { "0X0", "0X4D2", "-0X4D2", "-0XFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF" } },
+        { "n", { "0", "1234", "-1234", "-340282366920938463463374607431768211455" } },
+        { "012_x", { "00_0000_0000", "00_0000_04d2", "-0_0000_04d2", "-ffff_ffff_ffff_ffff_ffff_ffff_ffff_ffff" } },
+        { "#x", { "0x0", "0x4d2", "-0x4d2", "-0xffffffffffffffffffffffffffffffff" } },
+        { ">50_", { "                                                 0", "                                             1_234", "                                            -1_234", "-340_282_366_920_938_463_463_374_607_431_768_211_455" } },
+        { "<55,", { "0                                                      ", "1,234                                                  ", "-1,234                                                 ", "-340,282,366,920,938,463,463,374,607,431,768,211,455   " } },
+        { "^40X", { "                   0                    ", "                  4D2                   ", "                  -4D2                  ", "   -FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF    " } },
+        { "0<10", { "0000000000", "1234000000", "-123400000", "-340282366920938463463374607431768211455" } },
+        { "040_b", { "0_0000_0000_0000_0000_0000_0000_0000_0000", "0_0000_0000_0000_0000_0000_0100_1101_0010", "-0000_0000_0000_0000_0000_0100_1101_0010", "-1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111_1111" } },
+    };
+    for (auto& c : cases) {
+        for (int i=0; i<4; i++) {
+            std::string r = vals[i].Format(c.spec);
+            ASSERT(r == c.res[i], "'%s' of %s: %s", c.spec, vals[i].ToStr().c_str(), r.c_str());
+            BigInt::FormatSpec spec;
+            BigInt::FormatSpec::Parse(c.spec, spec);
+            ASSERT(vals[i].FormattedSize(spec) >= r.size(), "size '%s'", c.spec);
+        }
+    }
+    ASSERT(BigInt(-1234567).ToStr("+,") == "-1,234,567" && BigInt(7).ToStr() == "7", "ToStr opts");
+    static_assert([] { BigInt::FormatSpec f; return !BigInt::FormatSpec::Parse("*^+#012_x", f) && f.width == 12; }());
+
+    // invalid spec
+    for (const char* spec : { "z", ".2", "10.5", ",x", ",b", "_n", "q", "dd", "<<<", "99999999999" }) {
+        int thrown = 0;
+        try { BigInt(5).Format(spec); } catch (const std::invalid_argument&) { thrown++; }
+        ASSERT(thrown == 1, "invalid '%s'", spec);
+    }
+
+    // large values, against other conversions
+    std::mt19937 gen(2039);
+    for (int bits : { 1, 31, 32, 33, 64, 1000, 50000 }) {
+        BigInt a = random_bits(gen, bits);
+        if (bits % 2)
+            a = -a;
+        std::string d = a.ToStr(), g = a.Format(","), x = a.Format("x"), b = a.Format("b"), o = a.Format("#o");
+        std::string t = g;
+        t.erase(std::remove(t.begin(), t.end(), ','), t.end());
+        ASSERT(t == d, "grouping %d", bits);
+        std::string h = hex(a.Abs().ToBytes((a.BitLength() + 7) / 8));
+        h.erase(0, std::min(h.find_first_not_of('0'), h.size() - 1));
+        ASSERT(x == (a < 0 ? "-" : "") + h, "hex %d", bits);
+        ASSERT((long long)b.size() == a.BitLength() + (a < 0), "bin %d", bits);
+        ASSERT(o.substr(0, (a < 0) + 2) == (a < 0 ? "-0o" : "0o") && o.size() == (a < 0) + 2 + (size_t)((a.BitLength() + 2) / 3), "oct %d", bits);
+    }
+
+    // ostream
+    {
+        std::ostringstream os;
+        BigInt a = -1234, b = BigInt(1) << 70;
+        os << a << ' ' << b << '|';
+        os << std::hex << b << ' ' << std::showbase << std::uppercase << BigInt(255) << '|';
+        os << std::dec << std::noshowbase << std::showpos << std::setw(8) << BigInt(42) << '|';
+        os << std::noshowpos << std::left << std::setfill('.') << std::setw(6) << a << std::setw(6) << a << a << '|';
+        os << std::internal << std::setw(8) << a << '|' << BigInt(5) << '|';
+        ASSERT(os.str() == "-1234 1180591620717411303424|400000000000000000 0XFF|     +42|-1234.-1234.-1234|-...1234|5|", "stream %s", os.str().c_str());
+    }
+    {
+        std::ostringstream os;
+        BigInt a = random_bits(gen, 100000);
+        os << a;
+        ASSERT(os.str() == a.ToStr(), "stream large");
+        os.str("");
+        os << std::setw(40000) << std::setfill('*') << std::left << a;
+        ASSERT(os.str() == a.Format("*<40000"), "stream large fill");
+    }
+    {
+        // pieces go to stream buffer as they are. work buffer of thread is reused.
+        struct TextBuf : std::streambuf {
+            std::string text;
+            std::streamsize xsputn(const char* p, std::streamsize n) override {
+                text.append(p, n);
+                return n;
+            }
+        } sb;
+        sb.text.reserve(1 << 12);
+        std::ostream os(&sb);
+        BigInt a = random_bits(gen, 600);
+        os << std::setw(300) << a;
+        long long n0 = g_num_alloc;
+        os << std::setw(300) << std::setfill('.') << std::internal << -a << std::hex << a;
+        ASSERT(g_num_alloc == n0, "heap allocated %lld times", g_num_alloc - n0);
+        ASSERT(sb.text == a.Format(">300") + (-a).Format(".=300") + a.Format("x"), "stream pieces");
+    }
+#if defined(__cpp_lib_format)
+    {
+        BigInt a = -1234567, big = random_bits(gen, 5000);
+        ASSERT(std::format("{:+,}|{:_x}|{:*^12}|{}", BigInt(1234567), a, a, 5) == "+1,234,567|-12_d687|**-1234567**|5", "std::format");
+        ASSERT(std::format("{}", big) == big.ToStr() && std::format("{:#X}", big) == big.Format("#X"), "std::format large");
+        std::string out;
+        std::format_to(std::back_inserter(out), "[{:>10}]", BigInt(42));
+        ASSERT(out == "[        42]", "std::format_to %s", out.c_str());
+        int thrown = 0;
+        try { (void)std::vformat("{:.2}", std::make_format_args(a)); } catch (const std::format_error&) { thrown++; }
+        ASSERT(thrown == 1, "format_error");
+    }
+#endif
+    printf("format ok\n");
+    return 0;
+}
 
 int main(int argc, char **argv)
 {
@@ -172,10 +1866,76 @@ int main(int argc, char **argv)
 		return test_compare(argc-1, ((argv[1] = argv[0]), argv+1));
 	if (argc >= 2 && !strcmp(argv[1], "bigint"))
 		return test_bigint(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "large"))
+		return test_bigint_large(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "mul"))
+		return test_bigint_mul(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "div"))
+		return test_bigint_div(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "str"))
+		return test_bigint_str(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "alloc"))
+		return test_bigint_alloc(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "pmr"))
+		return test_bigint_pmr(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "kernel"))
+		return test_bigint_kernel(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "pow"))
+		return test_bigint_pow(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "gcd"))
+		return test_bigint_gcd(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "root"))
+		return test_bigint_root(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "bit"))
+		return test_bigint_bit(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "expr"))
+		return test_bigint_expr(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "parallel"))
+		return test_bigint_parallel(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "comb"))
+		return test_bigint_comb(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "fixed"))
+		return test_bigint_fixed(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "native"))
+		return test_bigint_native(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "conv"))
+		return test_bigint_conv(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "bytes"))
+		return test_bigint_bytes(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "view"))
+		return test_bigint_view(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "hash"))
+		return test_bigint_hash(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "parse"))
+		return test_bigint_parse(argc-1, ((argv[1] = argv[0]), argv+1));
+	if (argc >= 2 && !strcmp(argv[1], "format"))
+		return test_bigint_format(argc-1, ((argv[1] = argv[0]), argv+1));
 
 	printf("usage: %s mode [args..]\n", argv[0]);
 	printf("   compare\n");
 	printf("   bigint\n");
+	printf("   large\n");
+	printf("   mul\n");
+	printf("   div\n");
+	printf("   str\n");
+	printf("   alloc\n");
+	printf("   pmr\n");
+	printf("   kernel\n");
+	printf("   pow\n");
+	printf("   gcd\n");
+	printf("   root\n");
+	printf("   bit\n");
+	printf("   expr\n");
+	printf("   parallel\n");
+	printf("   comb\n");
+	printf("   fixed\n");
+	printf("   native\n");
+	printf("   conv\n");
+	printf("   bytes\n");
+	printf("   view\n");
+	printf("   hash\n");
+	printf("   parse\n");
+	printf("   format\n");
 	return 0;
 }
 
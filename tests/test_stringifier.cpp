@@ -15,6 +15,7 @@
 #include <map>
 #include <set>
 #include <unordered_set>
+#include <array>
 
 
 